@@ -309,6 +309,14 @@ def define_components(reqs):
     reqs.define('fuse', libs=['fuse3'], defines=["FUSE_USE_VERSION=35"],
                 headers=['fuse3/fuse.h'], package='fuse3-devel')
 
+    reqs.define('uring', libs=['uring'], headers=['liburing.h'],
+                package='liburing-devel')
+
+    if reqs.get_env('BIO_URING') and reqs.check_component('uring'):
+        SPDK_URING = ' --with-uring'
+    else:
+        SPDK_URING = ' --without-uring'
+
     retriever = GitRepoRetriever("https://github.com/spdk/spdk.git", True)
     reqs.define('spdk',
                 retriever=retriever,
@@ -317,7 +325,8 @@ def define_components(reqs):
                           ' --disable-apps --without-vhost '                   \
                           ' --without-crypto --without-pmdk --without-rbd '    \
                           ' --with-rdma --without-iscsi-initiator '            \
-                          ' --without-isal --without-vtune --with-shared',
+                          ' --without-isal --without-vtune --with-shared' +    \
+                          SPDK_URING,
                           'make $JOBS_OPT', 'make install',
                           'cp -r -P dpdk/build/lib/* "$SPDK_PREFIX/lib"',
                           'mkdir -p "$SPDK_PREFIX/include/dpdk"',
@@ -17,6 +17,12 @@ dma_free_chunk(struct bio_dma_chunk *chunk)
 	D_ASSERT(chunk->bdc_ref == 0);
 	D_ASSERT(d_list_empty(&chunk->bdc_link));
 
+	/* Bulk handle array is kept on chunk reclaimed from bulk group */
+	if (chunk->bdc_bulks != NULL) {
+		D_ASSERT(chunk->bdc_bulk_cnt == 0);
+		D_FREE(chunk->bdc_bulks);
+	}
+
 	if (bio_nvme_configured())
 		spdk_dma_free(chunk->bdc_ptr);
 	else
@@ -26,7 +32,7 @@ dma_free_chunk(struct bio_dma_chunk *chunk)
 }
 
 static struct bio_dma_chunk *
-dma_alloc_chunk(unsigned int cnt)
+dma_alloc_chunk(unsigned int cnt, int socket)
 {
 	struct bio_dma_chunk *chunk;
 	ssize_t bytes = (ssize_t)cnt << BIO_DMA_PAGE_SHIFT;
@@ -40,7 +46,9 @@ dma_alloc_chunk(unsigned int cnt)
 	}
 
 	if (bio_nvme_configured()) {
-		chunk->bdc_ptr = spdk_dma_malloc(bytes, BIO_DMA_PAGE_SZ, NULL);
+		/* Allocate on the NUMA node where the NVMe device attached */
+		chunk->bdc_ptr = spdk_dma_malloc_socket(bytes, BIO_DMA_PAGE_SZ,
+							NULL, socket);
 	} else {
 		rc = posix_memalign(&chunk->bdc_ptr, BIO_DMA_PAGE_SZ, bytes);
 		if (rc)
@@ -73,6 +81,7 @@ dma_buffer_shrink(struct bio_dma_buffer *buf, unsigned int cnt)
 		buf->bdb_tot_cnt--;
 		cnt--;
 	}
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_tot, buf->bdb_tot_cnt);
 }
 
 int
@@ -84,7 +93,7 @@ dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt)
 	D_ASSERT((buf->bdb_tot_cnt + cnt) <= bio_chk_cnt_max);
 
 	for (i = 0; i < cnt; i++) {
-		chunk = dma_alloc_chunk(bio_chk_sz);
+		chunk = dma_alloc_chunk(bio_chk_sz, buf->bdb_socket);
 		if (chunk == NULL) {
 			rc = -DER_NOMEM;
 			break;
@@ -93,17 +102,412 @@ dma_buffer_grow(struct bio_dma_buffer *buf, unsigned int cnt)
 		d_list_add_tail(&chunk->bdc_link, &buf->bdb_idle_list);
 		buf->bdb_tot_cnt++;
 	}
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_tot, buf->bdb_tot_cnt);
 
 	return rc;
 }
 
+static unsigned int
+dma_buffer_idle_cnt(struct bio_dma_buffer *buf)
+{
+	struct bio_dma_chunk	*chunk;
+	unsigned int		 cnt = 0;
+
+	d_list_for_each_entry(chunk, &buf->bdb_idle_list, bdc_link)
+		cnt++;
+
+	return cnt;
+}
+
+/*
+ * Size the per-xstream DMA buffer by the observed inflight DMA bytes:
+ *
+ * - The target chunk count is twice of the (decaying) inflight peak, since
+ *   chunks are partially used and are separated by chunk type;
+ * - Grow ahead of the I/O path when the buffer is below target or the idle
+ *   chunks are below watermark, so that burst I/O won't hit exhaustion;
+ * - Release idle chunks when the buffer is above target;
+ *
+ * It's called from the NVMe poll ULT periodically.
+ */
+void
+dma_buffer_tune(struct bio_dma_buffer *buf, uint64_t now)
+{
+	uint64_t	chk_bytes = (uint64_t)bio_chk_sz << BIO_DMA_PAGE_SHIFT;
+	unsigned int	tgt_cnt, idle_cnt, cnt;
+	int		rc;
+
+	if (buf->bdb_tune_age + BIO_DMA_TUNE_PERIOD >= now)
+		return;
+	buf->bdb_tune_age = now;
+
+	tgt_cnt = (buf->bdb_inflight_peak * 2 + chk_bytes - 1) / chk_bytes;
+	tgt_cnt = max(tgt_cnt, bio_chk_cnt_init);
+	tgt_cnt = min(tgt_cnt, bio_chk_cnt_max);
+	buf->bdb_tgt_cnt = tgt_cnt;
+	d_tm_set_gauge(buf->bdb_stats.bds_chks_target, tgt_cnt);
+
+	/* Decay the peak, so that the buffer can shrink after burst I/O */
+	buf->bdb_inflight_peak = max(buf->bdb_inflight_peak / 2,
+				     buf->bdb_inflight_bytes);
+
+	idle_cnt = dma_buffer_idle_cnt(buf);
+	if (buf->bdb_tot_cnt < tgt_cnt || idle_cnt < BIO_DMA_IDLE_WATERMARK) {
+		cnt = max(tgt_cnt - min(buf->bdb_tot_cnt, tgt_cnt),
+			  BIO_DMA_IDLE_WATERMARK - min(idle_cnt,
+						       BIO_DMA_IDLE_WATERMARK));
+		cnt = min(cnt, bio_chk_cnt_max - buf->bdb_tot_cnt);
+		if (cnt == 0)
+			return;
+
+		rc = dma_buffer_grow(buf, cnt);
+		if (rc) {
+			D_WARN("Failed to prefetch grow %u chunks. "DF_RC"\n",
+			       cnt, DP_RC(rc));
+			return;
+		}
+		d_tm_inc_counter(buf->bdb_stats.bds_prefetch_grows, 1);
+		D_DEBUG(DB_IO, "Prefetch grow %u chunks, tot:%u, tgt:%u\n",
+			cnt, buf->bdb_tot_cnt, tgt_cnt);
+	} else if (buf->bdb_tot_cnt > tgt_cnt &&
+		   idle_cnt > BIO_DMA_IDLE_WATERMARK) {
+		cnt = min(buf->bdb_tot_cnt - tgt_cnt,
+			  idle_cnt - BIO_DMA_IDLE_WATERMARK);
+		dma_buffer_shrink(buf, cnt);
+		d_tm_inc_counter(buf->bdb_stats.bds_shrinks, 1);
+		D_DEBUG(DB_IO, "Shrink %u chunks, tot:%u, tgt:%u\n",
+			cnt, buf->bdb_tot_cnt, tgt_cnt);
+	}
+}
+
+static inline d_list_t *
+rc_bucket(struct bio_read_cache *rc, struct bio_io_context *ioctxt,
+	  uint64_t grp)
+{
+	uint64_t key = ((uint64_t)ioctxt >> 6) ^ grp;
+
+	return &rc->brc_buckets[key % BIO_RC_BUCKETS];
+}
+
+static inline uint64_t
+rc_ent_bytes(struct bio_rc_ent *ent)
+{
+	return ent->bre_pg_cnt << BIO_DMA_PAGE_SHIFT;
+}
+
+static void
+rc_free_ent(struct bio_dma_buffer *bdb, struct bio_rc_ent *ent)
+{
+	struct bio_read_cache *rc = &bdb->bdb_rcache;
+
+	D_ASSERT(rc->brc_bytes >= rc_ent_bytes(ent));
+	rc->brc_bytes -= rc_ent_bytes(ent);
+	d_tm_set_gauge(bdb->bdb_stats.bds_rc_bytes, rc->brc_bytes);
+
+	d_list_del(&ent->bre_link);
+	d_list_del(&ent->bre_lru);
+	D_FREE(ent->bre_data);
+	D_FREE(ent);
+}
+
+static struct bio_rc_ent *
+rc_lookup(struct bio_read_cache *rc, struct bio_io_context *ioctxt,
+	  uint64_t pg_idx)
+{
+	struct bio_rc_ent	*ent;
+	d_list_t		*head;
+
+	head = rc_bucket(rc, ioctxt, pg_idx >> BIO_RC_GRP_SHIFT);
+	d_list_for_each_entry(ent, head, bre_link) {
+		if (ent->bre_ioctxt == ioctxt && ent->bre_pg_idx == pg_idx)
+			return ent;
+	}
+	return NULL;
+}
+
+static inline bool
+rc_enabled(struct bio_dma_buffer *bdb, uint64_t pg_cnt)
+{
+	return bdb != NULL && bdb->bdb_rcache.brc_buckets != NULL &&
+		pg_cnt <= (1UL << BIO_RC_GRP_SHIFT);
+}
+
+/* Serve the NVMe read from cache, return true on hit */
+static bool
+rc_read(struct bio_dma_buffer *bdb, struct bio_io_context *ioctxt,
+	void *payload, uint64_t pg_idx, uint64_t pg_cnt)
+{
+	struct bio_read_cache	*rc = &bdb->bdb_rcache;
+	struct bio_rc_ent	*ent;
+
+	ent = rc_lookup(rc, ioctxt, pg_idx);
+	if (ent == NULL || ent->bre_pg_cnt < pg_cnt) {
+		d_tm_inc_counter(bdb->bdb_stats.bds_rc_misses, 1);
+		return false;
+	}
+
+	memcpy(payload, ent->bre_data, pg_cnt << BIO_DMA_PAGE_SHIFT);
+	d_list_move(&ent->bre_lru, &rc->brc_lru);
+	d_tm_inc_counter(bdb->bdb_stats.bds_rc_hits, 1);
+	return true;
+}
+
+/* Populate the cache with the data just read from NVMe */
+static void
+rc_insert(struct bio_dma_buffer *bdb, struct bio_io_context *ioctxt,
+	  void *payload, uint64_t pg_idx, uint64_t pg_cnt)
+{
+	struct bio_read_cache	*rc = &bdb->bdb_rcache;
+	struct bio_rc_ent	*ent;
+	uint64_t		 bytes = pg_cnt << BIO_DMA_PAGE_SHIFT;
+
+	if (bytes > rc->brc_bytes_max)
+		return;
+
+	ent = rc_lookup(rc, ioctxt, pg_idx);
+	if (ent != NULL) {
+		if (ent->bre_pg_cnt >= pg_cnt) {
+			d_list_move(&ent->bre_lru, &rc->brc_lru);
+			return;
+		}
+		rc_free_ent(bdb, ent);
+	}
+
+	/* Evict the least recently used extents */
+	while (rc->brc_bytes + bytes > rc->brc_bytes_max) {
+		D_ASSERT(!d_list_empty(&rc->brc_lru));
+		ent = d_list_entry(rc->brc_lru.prev, struct bio_rc_ent,
+				   bre_lru);
+		rc_free_ent(bdb, ent);
+	}
+
+	D_ALLOC_PTR(ent);
+	if (ent == NULL)
+		return;
+
+	D_ALLOC_NZ(ent->bre_data, bytes);
+	if (ent->bre_data == NULL) {
+		D_FREE(ent);
+		return;
+	}
+
+	memcpy(ent->bre_data, payload, bytes);
+	ent->bre_ioctxt = ioctxt;
+	ent->bre_pg_idx = pg_idx;
+	ent->bre_pg_cnt = pg_cnt;
+	d_list_add(&ent->bre_link,
+		   rc_bucket(rc, ioctxt, pg_idx >> BIO_RC_GRP_SHIFT));
+	d_list_add(&ent->bre_lru, &rc->brc_lru);
+
+	rc->brc_bytes += bytes;
+	d_tm_set_gauge(bdb->bdb_stats.bds_rc_bytes, rc->brc_bytes);
+}
+
+/* Drop all the cached extents of an I/O context */
+void
+rc_purge(struct bio_io_context *ioctxt)
+{
+	struct bio_dma_buffer	*bdb;
+	struct bio_rc_ent	*ent, *tmp;
+
+	if (ioctxt->bic_xs_ctxt == NULL)
+		return;
+
+	bdb = ioctxt->bic_xs_ctxt->bxc_dma_buf;
+	if (bdb == NULL || bdb->bdb_rcache.brc_buckets == NULL)
+		return;
+
+	bdb->bdb_rcache.brc_gen++;
+	d_list_for_each_entry_safe(ent, tmp, &bdb->bdb_rcache.brc_lru,
+				   bre_lru) {
+		if (ent->bre_ioctxt == ioctxt)
+			rc_free_ent(bdb, ent);
+	}
+}
+
+void
+bio_rcache_invalidate(struct bio_io_context *ioctxt, uint64_t off,
+		      uint64_t len)
+{
+	struct bio_dma_buffer	*bdb;
+	struct bio_read_cache	*rc;
+	struct bio_rc_ent	*ent, *tmp;
+	uint64_t		 pg_idx, pg_end, grp, grp_end;
+
+	if (ioctxt == NULL || ioctxt->bic_xs_ctxt == NULL || len == 0)
+		return;
+
+	bdb = ioctxt->bic_xs_ctxt->bxc_dma_buf;
+	if (bdb == NULL || bdb->bdb_rcache.brc_buckets == NULL)
+		return;
+
+	rc = &bdb->bdb_rcache;
+	rc->brc_gen++;
+
+	pg_idx = off >> BIO_DMA_PAGE_SHIFT;
+	pg_end = (off + len + BIO_DMA_PAGE_SZ - 1) >> BIO_DMA_PAGE_SHIFT;
+	grp = pg_idx >> BIO_RC_GRP_SHIFT;
+	grp_end = (pg_end - 1) >> BIO_RC_GRP_SHIFT;
+	/* Extent started in previous group could overlap with the range */
+	if (grp > 0)
+		grp--;
+
+	for (; grp <= grp_end; grp++) {
+		d_list_for_each_entry_safe(ent, tmp, rc_bucket(rc, ioctxt, grp),
+					   bre_link) {
+			if (ent->bre_ioctxt != ioctxt ||
+			    ent->bre_pg_idx >= pg_end ||
+			    ent->bre_pg_idx + ent->bre_pg_cnt <= pg_idx)
+				continue;
+			rc_free_ent(bdb, ent);
+		}
+	}
+}
+
+static void
+rc_init(struct bio_dma_buffer *buf)
+{
+	struct bio_read_cache	*rc = &buf->bdb_rcache;
+	int			 i;
+
+	D_INIT_LIST_HEAD(&rc->brc_lru);
+	if (bio_rc_pct == 0)
+		return;
+
+	rc->brc_bytes_max = ((uint64_t)bio_chk_cnt_max * bio_chk_sz *
+			     bio_rc_pct / 100) << BIO_DMA_PAGE_SHIFT;
+	if (rc->brc_bytes_max == 0)
+		return;
+
+	D_ALLOC_ARRAY(rc->brc_buckets, BIO_RC_BUCKETS);
+	if (rc->brc_buckets == NULL) {
+		D_WARN("Failed to allocate NVMe read cache\n");
+		return;
+	}
+
+	for (i = 0; i < BIO_RC_BUCKETS; i++)
+		D_INIT_LIST_HEAD(&rc->brc_buckets[i]);
+}
+
+static void
+rc_fini(struct bio_dma_buffer *buf)
+{
+	struct bio_read_cache	*rc = &buf->bdb_rcache;
+	struct bio_rc_ent	*ent, *tmp;
+
+	if (rc->brc_buckets == NULL)
+		return;
+
+	d_list_for_each_entry_safe(ent, tmp, &rc->brc_lru, bre_lru)
+		rc_free_ent(buf, ent);
+
+	D_ASSERT(rc->brc_bytes == 0);
+	D_FREE(rc->brc_buckets);
+}
+
+static void
+dma_metrics_init(struct bio_dma_buffer *buf, int tgt_id)
+{
+	struct bio_dma_stats	*stats = &buf->bdb_stats;
+	int			 rc;
+
+	rc = d_tm_add_metric(&stats->bds_chks_tot, D_TM_GAUGE,
+			     "Total chunks in DMA buffer", "chunks",
+			     "dmabuff/total_chunks/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create total_chunks telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_chks_target, D_TM_GAUGE,
+			     "Auto-tuned target chunks in DMA buffer", "chunks",
+			     "dmabuff/target_chunks/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create target_chunks telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_inflight_bytes, D_TM_STATS_GAUGE,
+			     "DMA buffer bytes reserved by inflight I/O",
+			     "bytes", "dmabuff/inflight_bytes/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create inflight_bytes telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_exhausted, D_TM_COUNTER,
+			     "DMA buffer exhausted", "errors",
+			     "dmabuff/exhausted/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create exhausted telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_retries, D_TM_COUNTER,
+			     "Retries on DMA buffer exhaustion", "retries",
+			     "dmabuff/retries/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create retries telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_prefetch_grows, D_TM_COUNTER,
+			     "DMA buffer grown ahead of I/O", "grows",
+			     "dmabuff/prefetch_grows/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create prefetch_grows telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_shrinks, D_TM_COUNTER,
+			     "DMA buffer shrunk to auto-tuned size", "shrinks",
+			     "dmabuff/shrinks/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create shrinks telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_wc_writes, D_TM_COUNTER,
+			     "NVMe writes queued for coalescing", "writes",
+			     "dmabuff/wc_writes/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create wc_writes telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_wc_flushes, D_TM_COUNTER,
+			     "Blob I/Os issued for coalesced writes", "ios",
+			     "dmabuff/wc_flushes/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create wc_flushes telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	if (buf->bdb_rcache.brc_buckets == NULL)
+		return;
+
+	rc = d_tm_add_metric(&stats->bds_rc_hits, D_TM_COUNTER,
+			     "NVMe reads served by read cache", "hits",
+			     "rcache/hits/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create rcache hits telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_rc_misses, D_TM_COUNTER,
+			     "NVMe reads missed in read cache", "misses",
+			     "rcache/misses/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create rcache misses telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&stats->bds_rc_bytes, D_TM_GAUGE,
+			     "Bytes cached by read cache", "bytes",
+			     "rcache/bytes/tgt_%d", tgt_id);
+	if (rc)
+		D_WARN("Failed to create rcache bytes telemetry: "DF_RC"\n",
+		       DP_RC(rc));
+}
+
 void
 dma_buffer_destroy(struct bio_dma_buffer *buf)
 {
 	D_ASSERT(d_list_empty(&buf->bdb_used_list));
 	D_ASSERT(buf->bdb_active_iods == 0);
+	D_ASSERT(buf->bdb_wc.bwq_cnt == 0);
 
 	bulk_cache_destroy(buf);
+	rc_fini(buf);
 	dma_buffer_shrink(buf, buf->bdb_tot_cnt);
 
 	D_ASSERT(buf->bdb_tot_cnt == 0);
@@ -114,7 +518,7 @@ dma_buffer_destroy(struct bio_dma_buffer *buf)
 }
 
 struct bio_dma_buffer *
-dma_buffer_create(unsigned int init_cnt)
+dma_buffer_create(unsigned int init_cnt, int tgt_id, int socket)
 {
 	struct bio_dma_buffer *buf;
 	int rc;
@@ -127,6 +531,8 @@ dma_buffer_create(unsigned int init_cnt)
 	D_INIT_LIST_HEAD(&buf->bdb_used_list);
 	buf->bdb_tot_cnt = 0;
 	buf->bdb_active_iods = 0;
+	buf->bdb_socket = socket;
+	buf->bdb_tgt_cnt = init_cnt;
 
 	rc = ABT_mutex_create(&buf->bdb_mutex);
 	if (rc != ABT_SUCCESS) {
@@ -148,6 +554,11 @@ dma_buffer_create(unsigned int init_cnt)
 		D_FREE(buf);
 		return NULL;
 	}
+	rc_init(buf);
+
+	/* Skip sensor setup on standalone vos & sys xstream */
+	if (tgt_id >= 0)
+		dma_metrics_init(buf, tgt_id);
 
 	rc = dma_buffer_grow(buf, init_cnt);
 	if (rc != 0) {
@@ -549,6 +960,7 @@ iod_add_region(struct bio_desc *biod, struct bio_dma_chunk *chk,
 
 	rsrvd_dma->brd_regions[cnt].brr_chk = chk;
 	rsrvd_dma->brd_regions[cnt].brr_pg_idx = chk_pg_idx;
+	rsrvd_dma->brd_regions[cnt].brr_chk_off = 0;
 	rsrvd_dma->brd_regions[cnt].brr_off = off;
 	rsrvd_dma->brd_regions[cnt].brr_end = end;
 	rsrvd_dma->brd_regions[cnt].brr_media = media;
@@ -623,7 +1035,7 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 	 * be high contention over the SPDK huge page cache.
 	 */
 	if (pg_cnt > bio_chk_sz) {
-		chk = dma_alloc_chunk(pg_cnt);
+		chk = dma_alloc_chunk(pg_cnt, bdb->bdb_socket);
 		if (chk == NULL)
 			return -DER_NOMEM;
 
@@ -717,6 +1129,7 @@ dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg)
 		if (rc == -DER_AGAIN) {
 			D_ERROR("DMA buffer isn't sufficient to sustain "
 				"current IO workload\n");
+			d_tm_inc_counter(bdb->bdb_stats.bds_exhausted, 1);
 			biod->bd_retry = 1;
 		} else {
 			D_ERROR("Failed to get idle chunk. "DF_RC"\n",
@@ -840,7 +1253,8 @@ scm_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 	D_ASSERT(biod->bd_rdma);
 	D_ASSERT(!bio_scm_rdma);
 
-	payload = rg->brr_chk->bdc_ptr + (rg->brr_pg_idx << BIO_DMA_PAGE_SHIFT);
+	payload = rg->brr_chk->bdc_ptr + (rg->brr_pg_idx << BIO_DMA_PAGE_SHIFT) +
+		  rg->brr_chk_off;
 
 	D_DEBUG(DB_IO, "SCM RDMA, type:%d payload:%p len:"DF_U64"\n",
 		biod->bd_type, payload, rg->brr_end - rg->brr_off);
@@ -849,6 +1263,181 @@ scm_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 		   payload, rg->brr_end - rg->brr_off);
 }
 
+/* Get the DMA payload address and the blob pages of an NVMe region */
+static inline void *
+nvme_rg_pages(struct bio_rsrvd_region *rg, uint64_t *pg_idx, uint64_t *pg_cnt)
+{
+	*pg_idx = rg->brr_off >> BIO_DMA_PAGE_SHIFT;
+	*pg_cnt = (rg->brr_end + BIO_DMA_PAGE_SZ - 1) >> BIO_DMA_PAGE_SHIFT;
+	D_ASSERT(*pg_cnt > *pg_idx);
+	*pg_cnt -= *pg_idx;
+
+	return rg->brr_chk->bdc_ptr + (rg->brr_pg_idx << BIO_DMA_PAGE_SHIFT);
+}
+
+/* Populate read cache with the NVMe regions of a completed fetch */
+static void
+rc_populate(struct bio_desc *biod, uint64_t gen)
+{
+	struct bio_dma_buffer	*bdb = biod->bd_ctxt->bic_xs_ctxt->bxc_dma_buf;
+	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
+	struct bio_rsrvd_region	*rg;
+	uint64_t		 pg_idx, pg_cnt;
+	void			*payload;
+	int			 i;
+
+	/* The blocks could be freed and reused while reading */
+	if (bdb == NULL || bdb->bdb_rcache.brc_gen != gen)
+		return;
+
+	if (daos_io_bypass & IOBP_NVME)
+		return;
+
+	for (i = 0; i < rsrvd_dma->brd_rg_cnt; i++) {
+		rg = &rsrvd_dma->brd_regions[i];
+		if (rg->brr_media != DAOS_MEDIA_NVME)
+			continue;
+
+		payload = nvme_rg_pages(rg, &pg_idx, &pg_cnt);
+		if (rc_enabled(bdb, pg_cnt))
+			rc_insert(bdb, biod->bd_ctxt, payload, pg_idx, pg_cnt);
+	}
+}
+
+/* Completion argument of a coalesced blob write */
+struct wc_req {
+	unsigned int		 wr_cnt;
+	struct bio_desc		*wr_biods[BIO_WC_CNT_MAX];
+	struct iovec		 wr_iovs[BIO_WC_CNT_MAX];
+};
+
+static void
+wc_completion(void *cb_arg, int err)
+{
+	struct wc_req	*req = cb_arg;
+	int		 i;
+
+	/* Complete each coalesced write against its own IOD */
+	for (i = 0; i < req->wr_cnt; i++)
+		rw_completion(req->wr_biods[i], err);
+
+	D_FREE(req);
+}
+
+/*
+ * Issue the pending writes in the coalescing queue, when @now is zero the
+ * queue is flushed unconditionally, otherwise, only when the pending writes
+ * exceeded the latency budget.
+ */
+void
+wc_queue_flush(struct bio_xs_context *xs_ctxt, uint64_t now)
+{
+	struct bio_dma_buffer	*bdb = xs_ctxt->bxc_dma_buf;
+	struct bio_wc_queue	*wcq = &bdb->bdb_wc;
+	struct bio_io_context	*ioctxt = wcq->bwq_ioctxt;
+	struct spdk_io_channel	*channel = xs_ctxt->bxc_io_channel;
+	struct wc_req		*req;
+	uint64_t		 pg_idx, pg_cnt;
+	int			 i;
+
+	if (wcq->bwq_cnt == 0)
+		return;
+
+	if (now != 0 && now < wcq->bwq_age + bio_wc_usecs)
+		return;
+
+	/*
+	 * The blob can't be closed nor torn down with any inflight DMA
+	 * transfer, so it's still valid here.
+	 */
+	D_ASSERT(ioctxt->bic_blob != NULL && channel != NULL);
+	d_tm_inc_counter(bdb->bdb_stats.bds_wc_flushes, 1);
+
+	if (wcq->bwq_cnt == 1) {
+		req = NULL;
+		goto single;
+	}
+
+	D_ALLOC_PTR(req);
+	if (req == NULL)
+		goto single;
+
+	req->wr_cnt = wcq->bwq_cnt;
+	memcpy(req->wr_biods, wcq->bwq_biods,
+	       sizeof(req->wr_biods[0]) * wcq->bwq_cnt);
+	memcpy(req->wr_iovs, wcq->bwq_iovs,
+	       sizeof(req->wr_iovs[0]) * wcq->bwq_cnt);
+
+	D_DEBUG(DB_IO, "Coalesced write blob:%p, cnt:%u, pg_idx:"DF_U64", "
+		"pg_cnt:"DF_U64"\n", ioctxt->bic_blob, wcq->bwq_cnt,
+		wcq->bwq_pg_idx, wcq->bwq_pg_end - wcq->bwq_pg_idx);
+
+	spdk_blob_io_writev(ioctxt->bic_blob, channel, req->wr_iovs,
+			    req->wr_cnt, page2io_unit(ioctxt, wcq->bwq_pg_idx),
+			    page2io_unit(ioctxt,
+					 wcq->bwq_pg_end - wcq->bwq_pg_idx),
+			    wc_completion, req);
+	wcq->bwq_cnt = 0;
+	return;
+single:
+	/* Issue the writes one by one */
+	pg_idx = wcq->bwq_pg_idx;
+	for (i = 0; i < wcq->bwq_cnt; i++) {
+		pg_cnt = wcq->bwq_iovs[i].iov_len >> BIO_DMA_PAGE_SHIFT;
+		spdk_blob_io_write(ioctxt->bic_blob, channel,
+				   wcq->bwq_iovs[i].iov_base,
+				   page2io_unit(ioctxt, pg_idx),
+				   page2io_unit(ioctxt, pg_cnt),
+				   rw_completion, wcq->bwq_biods[i]);
+		pg_idx += pg_cnt;
+	}
+	D_ASSERT(pg_idx == wcq->bwq_pg_end);
+	wcq->bwq_cnt = 0;
+}
+
+/* Queue a small NVMe write for coalescing with the adjacent writes */
+static void
+wc_queue_add(struct bio_xs_context *xs_ctxt, struct bio_desc *biod,
+	     void *payload, uint64_t pg_idx, uint64_t pg_cnt)
+{
+	struct bio_dma_buffer	*bdb = xs_ctxt->bxc_dma_buf;
+	struct bio_wc_queue	*wcq = &bdb->bdb_wc;
+	uint64_t		 tot_cnt;
+
+	tot_cnt = wcq->bwq_pg_end - wcq->bwq_pg_idx + pg_cnt;
+	if (wcq->bwq_cnt != 0 &&
+	    (wcq->bwq_ioctxt != biod->bd_ctxt || wcq->bwq_pg_end != pg_idx ||
+	     wcq->bwq_cnt == BIO_WC_CNT_MAX ||
+	     (tot_cnt << BIO_DMA_PAGE_SHIFT) > BIO_WC_BYTES_MAX))
+		wc_queue_flush(xs_ctxt, 0);
+
+	if (wcq->bwq_cnt == 0) {
+		wcq->bwq_ioctxt = biod->bd_ctxt;
+		wcq->bwq_pg_idx = pg_idx;
+		wcq->bwq_pg_end = pg_idx;
+		wcq->bwq_age = d_timeus_secdiff(0);
+	}
+
+	wcq->bwq_biods[wcq->bwq_cnt] = biod;
+	wcq->bwq_iovs[wcq->bwq_cnt].iov_base = payload;
+	wcq->bwq_iovs[wcq->bwq_cnt].iov_len = pg_cnt << BIO_DMA_PAGE_SHIFT;
+	wcq->bwq_pg_end += pg_cnt;
+	wcq->bwq_cnt++;
+	d_tm_inc_counter(bdb->bdb_stats.bds_wc_writes, 1);
+}
+
+static inline bool
+wc_enabled(struct bio_xs_context *xs_ctxt, uint64_t pg_cnt)
+{
+	/*
+	 * Coalesced writes are issued by the NVMe poll ULT, so it can't be
+	 * used by the self polling xstream.
+	 */
+	return bio_wc_usecs != 0 && xs_ctxt->bxc_tgt_id != -1 &&
+		xs_ctxt->bxc_dma_buf != NULL &&
+		(pg_cnt << BIO_DMA_PAGE_SHIFT) <= BIO_WC_WRITE_MAX;
+}
+
 static void
 nvme_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 {
@@ -875,11 +1464,14 @@ nvme_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 	}
 
 	D_ASSERT(channel != NULL);
-	payload = rg->brr_chk->bdc_ptr + (rg->brr_pg_idx << BIO_DMA_PAGE_SHIFT);
-	pg_idx = rg->brr_off >> BIO_DMA_PAGE_SHIFT;
-	pg_cnt = (rg->brr_end + BIO_DMA_PAGE_SZ - 1) >> BIO_DMA_PAGE_SHIFT;
-	D_ASSERT(pg_cnt > pg_idx);
-	pg_cnt -= pg_idx;
+	payload = nvme_rg_pages(rg, &pg_idx, &pg_cnt);
+
+	/* Serve the read from DRAM cache */
+	if (biod->bd_type == BIO_IOD_TYPE_FETCH &&
+	    rc_enabled(xs_ctxt->bxc_dma_buf, pg_cnt) &&
+	    rc_read(xs_ctxt->bxc_dma_buf, biod->bd_ctxt, payload, pg_idx,
+		    pg_cnt))
+		return;
 
 	/* NVMe poll needs be scheduled */
 	if (bio_need_nvme_poll(xs_ctxt))
@@ -894,7 +1486,9 @@ nvme_rw(struct bio_desc *biod, struct bio_rsrvd_region *rg)
 		blob, payload, pg_idx, pg_cnt);
 
 	D_ASSERT(biod->bd_type < BIO_IOD_TYPE_GETBUF);
-	if (biod->bd_type == BIO_IOD_TYPE_UPDATE)
+	if (biod->bd_type == BIO_IOD_TYPE_UPDATE && wc_enabled(xs_ctxt, pg_cnt))
+		wc_queue_add(xs_ctxt, biod, payload, pg_idx, pg_cnt);
+	else if (biod->bd_type == BIO_IOD_TYPE_UPDATE)
 		spdk_blob_io_write(blob, channel, payload,
 				   page2io_unit(biod->bd_ctxt, pg_idx),
 				   page2io_unit(biod->bd_ctxt, pg_cnt),
@@ -912,11 +1506,13 @@ dma_rw(struct bio_desc *biod)
 	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
 	struct bio_rsrvd_region	*rg;
 	struct bio_xs_context	*xs_ctxt;
+	uint64_t		 rc_gen = 0, start;
 	int			 i;
 
 	D_ASSERT(biod->bd_ctxt->bic_xs_ctxt);
 	xs_ctxt = biod->bd_ctxt->bic_xs_ctxt;
 
+	start = d_timeus_secdiff(0);
 	biod->bd_inflights = 0;
 	biod->bd_dma_issued = 0;
 	biod->bd_result = 0;
@@ -925,6 +1521,9 @@ dma_rw(struct bio_desc *biod)
 	D_ASSERT(biod->bd_type < BIO_IOD_TYPE_GETBUF);
 	D_DEBUG(DB_IO, "DMA start, type:%d\n", biod->bd_type);
 
+	if (xs_ctxt->bxc_dma_buf != NULL)
+		rc_gen = xs_ctxt->bxc_dma_buf->bdb_rcache.brc_gen;
+
 	for (i = 0; i < rsrvd_dma->brd_rg_cnt; i++) {
 		rg = &rsrvd_dma->brd_regions[i];
 
@@ -942,20 +1541,59 @@ dma_rw(struct bio_desc *biod)
 		xs_poll_completion(xs_ctxt, &biod->bd_inflights, 0);
 	} else {
 		biod->bd_dma_issued = 1;
-		if (biod->bd_inflights != 0)
+		if (biod->bd_inflights != 0) {
 			ABT_eventual_wait(biod->bd_dma_done, NULL);
+			bio_lat_update(xs_ctxt, d_timeus_secdiff(0) - start);
+		}
 	}
 
+	if (biod->bd_type == BIO_IOD_TYPE_FETCH && biod->bd_result == 0)
+		rc_populate(biod, rc_gen);
+
 	biod->bd_ctxt->bic_inflight_dmas--;
 	D_DEBUG(DB_IO, "DMA done, type:%d\n", biod->bd_type);
 }
 
+static uint64_t
+iod_dma_bytes(struct bio_desc *biod)
+{
+	struct bio_rsrvd_dma	*rsrvd_dma = &biod->bd_rsrvd;
+	struct bio_rsrvd_region	*rg;
+	uint64_t		 bytes = 0;
+	int			 i;
+
+	for (i = 0; i < rsrvd_dma->brd_rg_cnt; i++) {
+		rg = &rsrvd_dma->brd_regions[i];
+		bytes += rg->brr_end - rg->brr_off;
+	}
+	return bytes;
+}
+
+static void
+dma_add_iod(struct bio_dma_buffer *bdb, struct bio_desc *biod)
+{
+	bdb->bdb_active_iods++;
+
+	biod->bd_dma_bytes = iod_dma_bytes(biod);
+	bdb->bdb_inflight_bytes += biod->bd_dma_bytes;
+	if (bdb->bdb_inflight_bytes > bdb->bdb_inflight_peak)
+		bdb->bdb_inflight_peak = bdb->bdb_inflight_bytes;
+	d_tm_set_gauge(bdb->bdb_stats.bds_inflight_bytes,
+		       bdb->bdb_inflight_bytes);
+}
+
 static void
-dma_drop_iod(struct bio_dma_buffer *bdb)
+dma_drop_iod(struct bio_dma_buffer *bdb, struct bio_desc *biod)
 {
 	D_ASSERT(bdb->bdb_active_iods > 0);
 	bdb->bdb_active_iods--;
 
+	D_ASSERT(bdb->bdb_inflight_bytes >= biod->bd_dma_bytes);
+	bdb->bdb_inflight_bytes -= biod->bd_dma_bytes;
+	biod->bd_dma_bytes = 0;
+	d_tm_set_gauge(bdb->bdb_stats.bds_inflight_bytes,
+		       bdb->bdb_inflight_bytes);
+
 	ABT_mutex_lock(bdb->bdb_mutex);
 	ABT_cond_broadcast(bdb->bdb_wait_iods);
 	ABT_mutex_unlock(bdb->bdb_mutex);
@@ -1003,6 +1641,7 @@ retry:
 
 		D_DEBUG(DB_IO, "IOD %p waits for active IODs. %d\n",
 			biod, retry_cnt++);
+		d_tm_inc_counter(bdb->bdb_stats.bds_retries, 1);
 
 		ABT_mutex_lock(bdb->bdb_mutex);
 		ABT_cond_wait(bdb->bdb_wait_iods, bdb->bdb_mutex);
@@ -1020,7 +1659,7 @@ retry:
 		return 0;
 
 	bdb = iod_dma_buf(biod);
-	bdb->bdb_active_iods++;
+	dma_add_iod(bdb, biod);
 
 	if (biod->bd_type < BIO_IOD_TYPE_GETBUF) {
 		rc = ABT_eventual_create(0, &biod->bd_dma_done);
@@ -1044,7 +1683,7 @@ retry:
 	return 0;
 failed:
 	iod_release_buffer(biod);
-	dma_drop_iod(bdb);
+	dma_drop_iod(bdb, biod);
 	return rc;
 }
 
@@ -1070,7 +1709,7 @@ bio_iod_post(struct bio_desc *biod)
 
 	iod_release_buffer(biod);
 	bdb = iod_dma_buf(biod);
-	dma_drop_iod(bdb);
+	dma_drop_iod(bdb, biod);
 
 	return biod->bd_result;
 }
@@ -459,8 +459,10 @@ bulk_get_hdl(struct bio_desc *biod, unsigned int pg_cnt,
 			pg_cnt, DP_RC(rc));
 		dump_dma_info(bdb);
 
-		if (rc == -DER_AGAIN)
+		if (rc == -DER_AGAIN) {
+			d_tm_inc_counter(bdb->bdb_stats.bds_exhausted, 1);
 			biod->bd_retry = 1;
+		}
 
 		return NULL;
 	}
@@ -514,18 +516,64 @@ bulk_iod_init(struct bio_desc *biod)
 	}
 	biod->bd_bulk_max = max_bulks;
 	biod->bd_bulk_cnt = 0;
+	biod->bd_bulk_pack = 0;
 
 	return 0;
 }
 
+static inline void *
+bulk_hdl2base(struct bio_bulk_hdl *hdl)
+{
+	struct bio_dma_chunk	*chk = hdl->bbh_chunk;
+
+	return chk->bdc_ptr + (hdl->bbh_pg_idx << BIO_DMA_PAGE_SHIFT);
+}
+
 static inline void *
 bulk_hdl2addr(struct bio_bulk_hdl *hdl)
+{
+	return bulk_hdl2base(hdl) + hdl->bbh_bulk_off;
+}
+
+static inline unsigned int
+bulk_hdl2len(struct bio_bulk_hdl *hdl)
 {
 	struct bio_dma_chunk	*chk = hdl->bbh_chunk;
-	unsigned int		 chk_pg_idx = hdl->bbh_pg_idx;
-	unsigned int		 pg_off = hdl->bbh_bulk_off;
+	struct bio_bulk_group	*bbg;
 
-	return chk->bdc_ptr + (chk_pg_idx << BIO_DMA_PAGE_SHIFT) + pg_off;
+	D_ASSERT(chk != NULL);
+	bbg = chk->bdc_bulk_grp;
+	D_ASSERT(bbg != NULL);
+
+	return bbg->bbg_bulk_pgs << BIO_DMA_PAGE_SHIFT;
+}
+
+/*
+ * Small SCM IOVs are packed into the bulk handle used by the previous SCM IOV
+ * of the same IOD (sub-page packing), so that a bunch of small records won't
+ * consume a page sized bulk handle for each. NVMe IOVs can't be packed, since
+ * the NVMe DMA transfer is page granular.
+ */
+static struct bio_bulk_hdl *
+bulk_pack_hdl(struct bio_desc *biod, struct bio_iov *biov,
+	      unsigned int *pack_off)
+{
+	struct bio_bulk_hdl	*hdl;
+	unsigned int		 off;
+
+	if (bio_iov2media(biov) != DAOS_MEDIA_SCM || biod->bd_bulk_pack == 0)
+		return NULL;
+
+	D_ASSERT(biod->bd_bulk_cnt > 0);
+	hdl = biod->bd_bulk_hdls[biod->bd_bulk_cnt - 1];
+	D_ASSERT(hdl != NULL && bulk_hdl_is_inuse(hdl));
+
+	off = D_ALIGNUP(biod->bd_bulk_pack, BIO_BULK_PACK_ALIGN);
+	if (off + bio_iov2raw_len(biov) > bulk_hdl2len(hdl))
+		return NULL;
+
+	*pack_off = off;
+	return hdl;
 }
 
 /* Try to round up the bulk size to fully utilize the chunk */
@@ -542,8 +590,9 @@ bulk_map_one(struct bio_desc *biod, struct bio_iov *biov, void *data)
 {
 	struct bio_bulk_args	*arg = data;
 	struct bio_bulk_hdl	*hdl = NULL;
+	struct bio_rsrvd_dma	*rsrvd_dma;
 	uint64_t		 off, end;
-	unsigned int		 pg_cnt, pg_off;
+	unsigned int		 pg_cnt, pg_off, pack_off;
 	int			 rc = 0;
 
 	D_ASSERT(bulk_create_fn != NULL && bulk_free_fn != NULL);
@@ -562,10 +611,30 @@ bulk_map_one(struct bio_desc *biod, struct bio_iov *biov, void *data)
 
 	if (bypass_bulk_cache(biod, biov, pg_cnt)) {
 		rc = dma_map_one(biod, biov, NULL);
+		biod->bd_bulk_pack = 0;
 		goto done;
 	}
 	D_ASSERT(!BIO_ADDR_IS_DEDUP(&biov->bi_addr));
 
+	hdl = bulk_pack_hdl(biod, biov, &pack_off);
+	if (hdl != NULL) {
+		D_DEBUG(DB_TRACE, "Packed %u bytes at %u of bulk %p\n",
+			(unsigned int)bio_iov2raw_len(biov), pack_off, hdl);
+		bio_iov_set_raw_buf(biov, bulk_hdl2base(hdl) + pack_off);
+		rc = iod_add_region(biod, hdl->bbh_chunk,
+				    hdl->bbh_pg_idx +
+				    (pack_off >> BIO_DMA_PAGE_SHIFT),
+				    off, end, bio_iov2media(biov));
+		if (rc)
+			return rc;
+
+		rsrvd_dma = &biod->bd_rsrvd;
+		rsrvd_dma->brd_regions[rsrvd_dma->brd_rg_cnt - 1].brr_chk_off =
+			pack_off & (BIO_DMA_PAGE_SZ - 1);
+		biod->bd_bulk_pack = pack_off + bio_iov2raw_len(biov);
+		goto done;
+	}
+
 	hdl = bulk_get_hdl(biod, roundup_pgs(pg_cnt), pg_off, arg);
 	if (hdl == NULL) {
 		if (biod->bd_retry)
@@ -582,6 +651,12 @@ bulk_map_one(struct bio_desc *biod, struct bio_iov *biov, void *data)
 		bulk_hdl_unhold(hdl);
 		return rc;
 	}
+
+	/* Following small SCM IOVs can be packed into this bulk handle */
+	if (bio_iov2media(biov) == DAOS_MEDIA_SCM)
+		biod->bd_bulk_pack = bio_iov2raw_len(biov);
+	else
+		biod->bd_bulk_pack = 0;
 done:
 	D_ASSERT(biod->bd_bulk_hdls != NULL);
 	D_ASSERT(biod->bd_bulk_cnt < biod->bd_bulk_max);
@@ -595,7 +670,7 @@ done:
 void
 bulk_iod_release(struct bio_desc *biod)
 {
-	struct bio_bulk_hdl	*hdl;
+	struct bio_bulk_hdl	*hdl, *prev = NULL;
 	int			 i;
 
 	if (biod->bd_bulk_hdls == NULL) {
@@ -608,14 +683,22 @@ bulk_iod_release(struct bio_desc *biod)
 		hdl = biod->bd_bulk_hdls[i];
 
 		/* Bypassed bulk cache */
-		if (hdl == NULL)
+		if (hdl == NULL) {
+			prev = NULL;
 			continue;
+		}
 
-		bulk_hdl_unhold(hdl);
 		biod->bd_bulk_hdls[i] = NULL;
+		/* Packed IOVs share the handle with the previous IOV */
+		if (hdl == prev)
+			continue;
+
+		bulk_hdl_unhold(hdl);
+		prev = hdl;
 	}
 
 	biod->bd_bulk_cnt = 0;
+	biod->bd_bulk_pack = 0;
 }
 
 void
@@ -687,19 +770,6 @@ bulk_cache_create(struct bio_dma_buffer *bdb)
 	return 0;
 }
 
-static inline unsigned int
-bulk_hdl2len(struct bio_bulk_hdl *hdl)
-{
-	struct bio_dma_chunk	*chk = hdl->bbh_chunk;
-	struct bio_bulk_group	*bbg;
-
-	D_ASSERT(chk != NULL);
-	bbg = chk->bdc_bulk_grp;
-	D_ASSERT(bbg != NULL);
-
-	return bbg->bbg_bulk_pgs << BIO_DMA_PAGE_SHIFT;
-}
-
 void *
 bio_iod_bulk(struct bio_desc *biod, int sgl_idx, int iov_idx,
 	     unsigned int *bulk_off)
@@ -738,8 +808,14 @@ bio_iod_bulk(struct bio_desc *biod, int sgl_idx, int iov_idx,
 		return NULL;
 
 	D_ASSERT(bulk_hdl_is_inuse(hdl));
-	/* biov->bi_prefix_len is for csum, not included in bulk transfer */
-	*bulk_off = hdl->bbh_bulk_off + biov->bi_prefix_len;
+	/*
+	 * The IOV could be packed into the bulk handle, so calculate the
+	 * bulk offset by the IOV address instead of 'bbh_bulk_off'.
+	 *
+	 * biov->bi_prefix_len is for csum, not included in bulk transfer.
+	 */
+	*bulk_off = (bio_iov2raw_buf(biov) - bulk_hdl2base(hdl)) +
+		    biov->bi_prefix_len;
 	D_ASSERT(*bulk_off < bulk_hdl2len(hdl));
 
 	return hdl->bbh_bulk;
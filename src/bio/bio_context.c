@@ -561,6 +561,9 @@ bio_blob_close(struct bio_io_context *ctxt, bool async)
 		return -DER_BUSY;
 	}
 
+	/* Drop the cached extents, the blob could be deleted or replaced */
+	rc_purge(ctxt);
+
 	bma = blob_msg_arg_alloc();
 	if (bma == NULL)
 		return -DER_NOMEM;
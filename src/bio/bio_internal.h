@@ -24,6 +24,27 @@
  */
 #define NVME_MONITOR_PERIOD	    (60ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
 #define NVME_MONITOR_SHORT_PERIOD   (3ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
+/* How long a device is considered degrading after new errors were seen */
+#define NVME_DEGRADED_HOLD	    (5 * NVME_MONITOR_PERIOD)
+
+/*
+ * An xstream is considered degrading when its short term NVMe I/O latency
+ * is BIO_STEER_LAT_RATIO times of the long term one and is above the floor
+ * of bio_steer_lat_us.
+ */
+#define BIO_STEER_LAT_US	2000
+#define BIO_STEER_LAT_RATIO	4
+#define BIO_LAT_SHIFT		10
+/*
+ * Period to re-evaluate the per-xstream DMA buffer size against the observed
+ * inflight DMA bytes, 1 second by default.
+ */
+#define BIO_DMA_TUNE_PERIOD	(1ULL * (NSEC_PER_SEC / NSEC_PER_USEC))
+/* Minimum idle chunks kept ahead of the I/O path by prefetch grow */
+#define BIO_DMA_IDLE_WATERMARK	2
+
+/* Alignment of small SCM IOVs packed into the same cached bulk handle */
+#define BIO_BULK_PACK_ALIGN	64
 
 struct bio_bulk_args {
 	void		*ba_bulk_ctxt;
@@ -90,6 +111,81 @@ struct bio_bulk_cache {
 	d_list_t		  bbc_grp_lru;
 };
 
+/* DMA buffer statistics exported via telemetry framework */
+struct bio_dma_stats {
+	struct d_tm_node_t	*bds_chks_tot;
+	struct d_tm_node_t	*bds_chks_target;
+	struct d_tm_node_t	*bds_inflight_bytes;
+	struct d_tm_node_t	*bds_exhausted;
+	struct d_tm_node_t	*bds_retries;
+	struct d_tm_node_t	*bds_prefetch_grows;
+	struct d_tm_node_t	*bds_shrinks;
+	struct d_tm_node_t	*bds_wc_writes;
+	struct d_tm_node_t	*bds_wc_flushes;
+	struct d_tm_node_t	*bds_rc_hits;
+	struct d_tm_node_t	*bds_rc_misses;
+	struct d_tm_node_t	*bds_rc_bytes;
+};
+
+/*
+ * Cached extents are indexed by the group of their start page, an extent
+ * can't be larger than a group, so it spans two groups at most.
+ */
+#define BIO_RC_GRP_SHIFT	8	/* 256 pages, 1MB */
+#define BIO_RC_BUCKETS		1024
+
+/* A cached NVMe extent */
+struct bio_rc_ent {
+	/* Link to the hash bucket */
+	d_list_t		 bre_link;
+	/* Link to the LRU list */
+	d_list_t		 bre_lru;
+	struct bio_io_context	*bre_ioctxt;
+	/* Start blob page and page count */
+	uint64_t		 bre_pg_idx;
+	uint64_t		 bre_pg_cnt;
+	void			*bre_data;
+};
+
+/*
+ * Per-xstream DRAM read cache for NVMe extents, keyed by (blob, page offset).
+ * Extents are invalidated when the blocks are freed or the blob is closed.
+ */
+struct bio_read_cache {
+	/* Hash buckets, NULL when the cache is disabled */
+	d_list_t		*brc_buckets;
+	d_list_t		 brc_lru;
+	uint64_t		 brc_bytes;
+	uint64_t		 brc_bytes_max;
+	/* Bumped on each invalidation, to drop stale inflight reads */
+	uint64_t		 brc_gen;
+};
+
+/* Max number of NVMe writes coalesced into one blob I/O */
+#define BIO_WC_CNT_MAX		32
+/* Max size of an NVMe write to be coalesced */
+#define BIO_WC_WRITE_MAX	(64UL << 10)
+/* Max size of a coalesced blob I/O */
+#define BIO_WC_BYTES_MAX	(1UL << 20)
+
+/*
+ * Per-xstream write coalescing queue. Small NVMe writes landing on adjacent
+ * blob pages are held for at most bio_wc_usecs, and then issued as a single
+ * blob writev, each write is still completed against its own bio_desc.
+ */
+struct bio_wc_queue {
+	/* I/O context of the pending writes */
+	struct bio_io_context	*bwq_ioctxt;
+	/* Start and end (not included) blob page of the pending writes */
+	uint64_t		 bwq_pg_idx;
+	uint64_t		 bwq_pg_end;
+	/* Time when the first pending write was queued, in usecs */
+	uint64_t		 bwq_age;
+	unsigned int		 bwq_cnt;
+	struct bio_desc		*bwq_biods[BIO_WC_CNT_MAX];
+	struct iovec		 bwq_iovs[BIO_WC_CNT_MAX];
+};
+
 /*
  * Per-xstream DMA buffer, used as SPDK dma I/O buffer or as temporary
  * RDMA buffer for ZC fetch/update over NVMe devices.
@@ -104,6 +200,19 @@ struct bio_dma_buffer {
 	ABT_cond		 bdb_wait_iods;
 	ABT_mutex		 bdb_mutex;
 	struct bio_bulk_cache	 bdb_bulk_cache;
+	/* NUMA socket where DMA chunks are allocated */
+	int			 bdb_socket;
+	/* Auto-tuned chunk count, derived from observed inflight bytes */
+	unsigned int		 bdb_tgt_cnt;
+	/* DMA bytes reserved by inflight IODs */
+	uint64_t		 bdb_inflight_bytes;
+	/* Peak inflight bytes in current tuning period (decaying) */
+	uint64_t		 bdb_inflight_peak;
+	/* Last time the buffer size was tuned */
+	uint64_t		 bdb_tune_age;
+	struct bio_dma_stats	 bdb_stats;
+	struct bio_wc_queue	 bdb_wc;
+	struct bio_read_cache	 bdb_rcache;
 };
 
 #define BIO_PROTO_NVME_STATS_LIST					\
@@ -254,6 +363,11 @@ struct bio_dev_health {
 	void		       *bdh_error_buf; /* device error logs */
 	void		       *bdh_intel_smart_buf; /*Intel SMART attributes*/
 	uint64_t		bdh_stat_age;
+	/* Error count seen by last monitor tick, for error trend tracking */
+	uint64_t		bdh_err_base;
+	/* Device is considered degrading until this time (in usecs) */
+	uint64_t		bdh_degraded_until;
+	unsigned int		bdh_trend_samples;
 	unsigned int		bdh_inflights;
 	uint16_t		bdh_vendor_id; /* PCI vendor ID */
 
@@ -348,6 +462,9 @@ struct bio_xs_context {
 	struct spdk_io_channel	*bxc_io_channel;
 	struct bio_dma_buffer	*bxc_dma_buf;
 	d_list_t		 bxc_io_ctxts;
+	/* Short & long term NVMe I/O latency EWMA, in usecs << BIO_LAT_SHIFT */
+	uint64_t		 bxc_lat_fast;
+	uint64_t		 bxc_lat_slow;
 };
 
 /* Per VOS instance I/O context */
@@ -370,6 +487,8 @@ struct bio_rsrvd_region {
 	struct bio_dma_chunk	*brr_chk;
 	/* Start page idx within the DMA chunk */
 	unsigned int		 brr_pg_idx;
+	/* Byte offset within the start page, for packed SCM region */
+	unsigned int		 brr_chk_off;
 	/* Offset within the SPDK blob in bytes */
 	uint64_t		 brr_off;
 	/* End (not included) in bytes */
@@ -406,6 +525,8 @@ struct bio_desc {
 	int			 bd_result;
 	unsigned int		 bd_chk_type;
 	unsigned int		 bd_type;
+	/* DMA bytes reserved by this io descriptor */
+	uint64_t		 bd_dma_bytes;
 	/* Flags */
 	unsigned int		 bd_buffer_prep:1,
 				 bd_dma_issued:1,
@@ -415,6 +536,8 @@ struct bio_desc {
 	struct bio_bulk_hdl    **bd_bulk_hdls;
 	unsigned int		 bd_bulk_max;
 	unsigned int		 bd_bulk_cnt;
+	/* Bytes used in the last bulk handle, 0 means it can't be packed */
+	unsigned int		 bd_bulk_pack;
 	/* SG lists involved in this io descriptor */
 	unsigned int		 bd_sgl_cnt;
 	struct bio_sglist	 bd_sgls[0];
@@ -442,6 +565,9 @@ enum {
 	BDEV_CLASS_NVME = 0,
 	BDEV_CLASS_MALLOC,
 	BDEV_CLASS_AIO,
+#ifdef BIO_URING
+	BDEV_CLASS_URING,
+#endif
 	BDEV_CLASS_UNKNOWN
 };
 
@@ -454,6 +580,10 @@ get_bdev_type(struct spdk_bdev *bdev)
 		return BDEV_CLASS_MALLOC;
 	else if (strcmp(spdk_bdev_get_product_name(bdev), "AIO disk") == 0)
 		return BDEV_CLASS_AIO;
+#ifdef BIO_URING
+	else if (strcmp(spdk_bdev_get_product_name(bdev), "URING bdev") == 0)
+		return BDEV_CLASS_URING;
+#endif
 	else
 		return BDEV_CLASS_UNKNOWN;
 }
@@ -482,6 +612,10 @@ struct media_error_msg {
 extern bool		bio_scm_rdma;
 extern unsigned int	bio_chk_sz;
 extern unsigned int	bio_chk_cnt_max;
+extern unsigned int	bio_chk_cnt_init;
+extern unsigned int	bio_wc_usecs;
+extern unsigned int	bio_rc_pct;
+extern unsigned int	bio_steer_lat_us;
 int xs_poll_completion(struct bio_xs_context *ctxt, unsigned int *inflights,
 		       uint64_t timeout);
 void bio_bdev_event_cb(enum spdk_bdev_event_type type, struct spdk_bdev *bdev,
@@ -506,7 +640,11 @@ bool bypass_health_collect(void);
 
 /* bio_buffer.c */
 void dma_buffer_destroy(struct bio_dma_buffer *buf);
-struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt);
+struct bio_dma_buffer *dma_buffer_create(unsigned int init_cnt, int tgt_id,
+					 int socket);
+void dma_buffer_tune(struct bio_dma_buffer *buf, uint64_t now);
+void wc_queue_flush(struct bio_xs_context *xs_ctxt, uint64_t now);
+void rc_purge(struct bio_io_context *ioctxt);
 void bio_memcpy(struct bio_desc *biod, uint16_t media, void *media_addr,
 		void *addr, ssize_t n);
 int dma_map_one(struct bio_desc *biod, struct bio_iov *biov, void *arg);
@@ -557,11 +695,14 @@ dump_dma_info(struct bio_dma_buffer *bdb)
 	struct bio_bulk_group	*bbg;
 	int			 i, bulk_grps = 0, bulk_chunks = 0;
 
-	D_EMIT("chk_size:%u, tot_chk:%u/%u, active_iods:%u, used:%u,%u,%u\n",
-		bio_chk_sz, bdb->bdb_tot_cnt, bio_chk_cnt_max,
+	D_EMIT("chk_size:%u, tot_chk:%u/%u/%u, active_iods:%u, used:%u,%u,%u, "
+	       "inflight:"DF_U64"/"DF_U64", socket:%d\n",
+		bio_chk_sz, bdb->bdb_tot_cnt, bdb->bdb_tgt_cnt, bio_chk_cnt_max,
 		bdb->bdb_active_iods, bdb->bdb_used_cnt[BIO_CHK_TYPE_IO],
 		bdb->bdb_used_cnt[BIO_CHK_TYPE_LOCAL],
-		bdb->bdb_used_cnt[BIO_CHK_TYPE_REBUILD]);
+		bdb->bdb_used_cnt[BIO_CHK_TYPE_REBUILD],
+		bdb->bdb_inflight_bytes, bdb->bdb_inflight_peak,
+		bdb->bdb_socket);
 
 	/* cached bulk info */
 	for (i = 0; i < bbc->bbc_grp_cnt; i++) {
@@ -582,6 +723,7 @@ dump_dma_info(struct bio_dma_buffer *bdb)
 /* bio_monitor.c */
 int bio_init_health_monitoring(struct bio_blobstore *bb, char *bdev_name);
 void bio_fini_health_monitoring(struct bio_blobstore *bb);
+void bio_lat_update(struct bio_xs_context *ctxt, uint64_t lat_us);
 void bio_bs_monitor(struct bio_xs_context *ctxt, uint64_t now);
 void bio_media_error(void *msg_arg);
 void bio_export_health_stats(struct bio_blobstore *bb, char *bdev_name);
@@ -599,5 +741,6 @@ int bio_bs_state_set(struct bio_blobstore *bbs, enum bio_bs_state new_state);
 /* bio_device.c */
 void bio_led_event_monitor(struct bio_xs_context *ctxt, uint64_t now);
 int fill_in_traddr(struct bio_dev_info *b_info, char *dev_name);
+int bio_dev_socket_id(char *dev_name);
 
 #endif /* __BIO_INTERNAL_H__ */
@@ -727,6 +727,81 @@ collect_raw_health_data(struct bio_xs_context *ctxt)
 	}
 }
 
+/*
+ * Track the error trend of the device, any new media, I/O or checksum error
+ * since last monitor tick marks the device as degrading for a while, so that
+ * the I/O could be steered to other replicas proactively.
+ */
+static void
+health_trend_update(struct bio_xs_context *ctxt, uint64_t now)
+{
+	struct bio_dev_health	*bdh = xs_ctxt2dev_health(ctxt);
+	struct nvme_stats	*stats = &bdh->bdh_health_state;
+	uint64_t		 errs;
+
+	errs = stats->media_errs + stats->bio_read_errs +
+	       stats->bio_write_errs + stats->checksum_errs;
+
+	/*
+	 * Health data is collected asynchronously, skip the first couple of
+	 * samples, otherwise the lifetime media errors will be regarded as
+	 * new errors.
+	 */
+	if (bdh->bdh_trend_samples < 2) {
+		bdh->bdh_trend_samples++;
+		bdh->bdh_err_base = errs;
+		return;
+	}
+
+	if (errs > bdh->bdh_err_base) {
+		if (bdh->bdh_degraded_until <= now)
+			D_WARN("Target %d: "DF_U64" new errors, mark device "
+			       "as degrading\n", ctxt->bxc_tgt_id,
+			       errs - bdh->bdh_err_base);
+		bdh->bdh_degraded_until = now + NVME_DEGRADED_HOLD;
+	}
+	bdh->bdh_err_base = errs;
+}
+
+/* Update NVMe I/O latency EWMAs, called on I/O completion */
+void
+bio_lat_update(struct bio_xs_context *ctxt, uint64_t lat_us)
+{
+	uint64_t	lat = lat_us << BIO_LAT_SHIFT;
+
+	if (ctxt->bxc_lat_slow == 0) {
+		ctxt->bxc_lat_fast = lat;
+		ctxt->bxc_lat_slow = lat;
+		return;
+	}
+	/* alpha = 1/8 for the short term, 1/1024 for the long term */
+	ctxt->bxc_lat_fast = ctxt->bxc_lat_fast - (ctxt->bxc_lat_fast >> 3) +
+			     (lat >> 3);
+	ctxt->bxc_lat_slow = ctxt->bxc_lat_slow -
+			     (ctxt->bxc_lat_slow >> BIO_LAT_SHIFT) + lat_us;
+}
+
+bool
+bio_xs_degraded(struct bio_xs_context *ctxt)
+{
+	struct bio_dev_health	*bdh;
+	uint64_t		 floor;
+
+	if (ctxt == NULL || ctxt->bxc_blobstore == NULL)
+		return false;
+
+	bdh = xs_ctxt2dev_health(ctxt);
+	if (bdh->bdh_degraded_until > d_timeus_secdiff(0))
+		return true;
+
+	if (bio_steer_lat_us == 0)
+		return false;
+
+	floor = (uint64_t)bio_steer_lat_us << BIO_LAT_SHIFT;
+	return ctxt->bxc_lat_fast > floor &&
+	       ctxt->bxc_lat_fast > ctxt->bxc_lat_slow * BIO_STEER_LAT_RATIO;
+}
+
 void
 bio_bs_monitor(struct bio_xs_context *ctxt, uint64_t now)
 {
@@ -751,6 +826,8 @@ bio_bs_monitor(struct bio_xs_context *ctxt, uint64_t now)
 		return;
 	dev_health->bdh_stat_age = now;
 
+	health_trend_update(ctxt, now);
+
 	rc = auto_detect_faulty(bbs);
 	if (rc)
 		D_ERROR("Auto faulty detect on target %d failed. %d\n",
@@ -42,9 +42,15 @@ unsigned int bio_chk_sz;
 /* Per-xstream maximum DMA buffer size (in chunk count) */
 unsigned int bio_chk_cnt_max;
 /* Per-xstream initial DMA buffer size (in chunk count) */
-static unsigned int bio_chk_cnt_init;
+unsigned int bio_chk_cnt_init;
 /* Diret RDMA over SCM */
 bool bio_scm_rdma;
+/* Max time in usecs to hold small NVMe writes for coalescing, 0: disabled */
+unsigned int bio_wc_usecs;
+/* Per-xstream NVMe read cache size in percentage of DMA buffer upper bound */
+unsigned int bio_rc_pct;
+/* NVMe latency floor in usecs for degraded target detection, 0: disabled */
+unsigned int bio_steer_lat_us;
 
 struct bio_nvme_data {
 	ABT_mutex		 bd_mutex;
@@ -169,6 +175,15 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 	d_getenv_bool("DAOS_SCM_RDMA_ENABLED", &bio_scm_rdma);
 	D_INFO("RDMA to SCM is %s\n", bio_scm_rdma ? "enabled" : "disabled");
 
+	bio_wc_usecs = 0;
+	d_getenv_int("DAOS_NVME_WC_USECS", &bio_wc_usecs);
+	if (bio_wc_usecs != 0)
+		D_INFO("NVMe write coalescing window is %u usecs\n",
+		       bio_wc_usecs);
+
+	bio_steer_lat_us = BIO_STEER_LAT_US;
+	d_getenv_int("DAOS_NVME_STEER_LAT_US", &bio_steer_lat_us);
+
 	if (nvme_conf == NULL || strlen(nvme_conf) == 0) {
 		D_INFO("NVMe config isn't specified, skip NVMe setup.\n");
 		return 0;
@@ -200,6 +215,17 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 	D_INFO("Set per-xstream DMA buffer upper bound to %u %uMB chunks\n",
 	       bio_chk_cnt_max, size_mb);
 
+	bio_rc_pct = 0;
+	d_getenv_int("DAOS_NVME_RCACHE_PCT", &bio_rc_pct);
+	if (bio_rc_pct > 50) {
+		D_WARN("NVMe read cache %u%% is too large, use 50%%\n",
+		       bio_rc_pct);
+		bio_rc_pct = 50;
+	}
+	if (bio_rc_pct != 0)
+		D_INFO("NVMe read cache is %u%% of DMA buffer upper bound\n",
+		       bio_rc_pct);
+
 	rc = smd_init(db);
 	if (rc != 0) {
 		D_ERROR("Initialize SMD store failed. "DF_RC"\n", DP_RC(rc));
@@ -215,6 +241,19 @@ bio_nvme_init(const char *nvme_conf, int shm_id, int mem_size,
 	if (env && strcasecmp(env, "AIO") == 0) {
 		D_WARN("AIO device(s) will be used!\n");
 		nvme_glb.bd_bdev_class = BDEV_CLASS_AIO;
+	} else if (env && strcasecmp(env, "URING") == 0) {
+#ifdef BIO_URING
+		/*
+		 * io_uring bdevs are submitted and reaped by the pollers
+		 * on the xstream's SPDK thread, no extra thread hop.
+		 */
+		D_WARN("io_uring device(s) will be used!\n");
+		nvme_glb.bd_bdev_class = BDEV_CLASS_URING;
+#else
+		D_ERROR("io_uring bdev class isn't built in\n");
+		rc = -DER_NOTSUPPORTED;
+		goto fini_smd;
+#endif
 	}
 
 	env = getenv("VMD_LED_PERIOD");
@@ -1248,7 +1287,7 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id)
 {
 	struct bio_xs_context	*ctxt;
 	char			 th_name[32];
-	int			 rc;
+	int			 socket, rc;
 
 	D_ALLOC_PTR(ctxt);
 	if (ctxt == NULL)
@@ -1259,7 +1298,8 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id)
 
 	/* Skip NVMe context setup if the daos_nvme.conf isn't present */
 	if (!bio_nvme_configured()) {
-		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init);
+		ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id,
+						      SPDK_ENV_SOCKET_ID_ANY);
 		if (ctxt->bxc_dma_buf == NULL) {
 			D_FREE(ctxt);
 			*pctxt = NULL;
@@ -1335,7 +1375,12 @@ bio_xsctxt_alloc(struct bio_xs_context **pctxt, int tgt_id)
 	if (rc)
 		goto out;
 
-	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init);
+	/* Place DMA buffer on the NUMA node where the NVMe device attached */
+	socket = SPDK_ENV_SOCKET_ID_ANY;
+	if (ctxt->bxc_blobstore != NULL)
+		socket = bio_dev_socket_id(ctxt->bxc_blobstore->bb_dev->bb_name);
+
+	ctxt->bxc_dma_buf = dma_buffer_create(bio_chk_cnt_init, tgt_id, socket);
 	if (ctxt->bxc_dma_buf == NULL) {
 		D_ERROR("failed to initialize dma buffer\n");
 		rc = -DER_NOMEM;
@@ -1542,11 +1587,19 @@ bio_nvme_poll(struct bio_xs_context *ctxt)
 	uint64_t now = d_timeus_secdiff(0);
 	int rc;
 
+	/* Auto-tune DMA buffer size against the observed inflight bytes */
+	if (ctxt != NULL && ctxt->bxc_dma_buf != NULL)
+		dma_buffer_tune(ctxt->bxc_dma_buf, now);
+
 	/* NVMe context setup was skipped */
 	if (!bio_nvme_configured())
 		return 0;
 
 	D_ASSERT(ctxt != NULL && ctxt->bxc_thread != NULL);
+	/* Issue the coalesced writes which exceeded the latency budget */
+	if (ctxt->bxc_dma_buf != NULL)
+		wc_queue_flush(ctxt, now);
+
 	rc = spdk_thread_poll(ctxt->bxc_thread, 0, 0);
 
 	/*
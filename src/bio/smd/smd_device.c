@@ -9,12 +9,6 @@
 #include <daos/dtx.h>
 #include "smd_internal.h"
 
-struct smd_device {
-	enum smd_dev_state	sd_state;
-	uint32_t		sd_tgt_cnt;
-	uint32_t		sd_tgts[SMD_MAX_TGT_CNT];
-};
-
 int
 smd_dev_add_tgt(uuid_t dev_id, uint32_t tgt_id)
 {
@@ -25,6 +25,21 @@
 
 #define SMD_MAX_TGT_CNT		64
 
+/** value of TABLE_DEV, keyed by device ID */
+struct smd_device {
+	enum smd_dev_state	sd_state;
+	uint32_t		sd_tgt_cnt;
+	uint32_t		sd_tgts[SMD_MAX_TGT_CNT];
+};
+
+/** value of TABLE_POOL, keyed by pool ID */
+struct smd_pool {
+	uint64_t	sp_blob_sz;
+	uint32_t	sp_tgt_cnt;
+	uint32_t	sp_tgts[SMD_MAX_TGT_CNT];
+	uint64_t	sp_blobs[SMD_MAX_TGT_CNT];
+};
+
 /** callback parameter for smd_db_traverse */
 struct smd_trav_data {
 	d_list_t		td_list;
@@ -9,13 +9,6 @@
 #include <daos/dtx.h>
 #include "smd_internal.h"
 
-struct smd_pool {
-	uint64_t	sp_blob_sz;
-	uint32_t	sp_tgt_cnt;
-	uint32_t	sp_tgts[SMD_MAX_TGT_CNT];
-	uint64_t	sp_blobs[SMD_MAX_TGT_CNT];
-};
-
 static int
 smd_pool_find_tgt(struct smd_pool *pool, int tgt_id)
 {
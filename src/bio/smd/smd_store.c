@@ -17,11 +17,225 @@
 
 static struct sys_db	*smd_db;
 
+/*
+ * DRAM index of the SMD tables. All tables are loaded from sys_db once on
+ * smd_init(), lookups and traversals are then served from DRAM, and updates
+ * are written through to sys_db. The index is protected by smd_db_lock().
+ *
+ * If the index can't be kept consistent with sys_db (e.g. out of memory), it
+ * is dropped and all operations fall back to sys_db.
+ */
+#define SMD_CACHE_BITS	6
+
+struct smd_cache_rec {
+	d_list_t	 scr_link;
+	uint32_t	 scr_key_sz;
+	uint32_t	 scr_val_sz;
+	/* key followed by value */
+	char		 scr_buf[0];
+};
+
+struct smd_cache {
+	char			*sc_table;
+	uint32_t		 sc_val_sz;
+	struct d_hash_table	 sc_htable;
+};
+
+static struct smd_cache smd_caches[] = {
+	{ .sc_table = TABLE_DEV,	.sc_val_sz = sizeof(struct smd_device) },
+	{ .sc_table = TABLE_TGT,	.sc_val_sz = sizeof(struct d_uuid) },
+	{ .sc_table = TABLE_POOL,	.sc_val_sz = sizeof(struct smd_pool) },
+};
+
+#define SMD_CACHE_NR	ARRAY_SIZE(smd_caches)
+
+static bool	smd_cache_ready;
+
+static inline struct smd_cache_rec *
+smd_cache_rec_obj(d_list_t *rlink)
+{
+	return container_of(rlink, struct smd_cache_rec, scr_link);
+}
+
+static inline void *
+smd_cache_rec_val(struct smd_cache_rec *rec)
+{
+	return &rec->scr_buf[rec->scr_key_sz];
+}
+
+static bool
+smd_cache_key_cmp(struct d_hash_table *htable, d_list_t *rlink,
+		  const void *key, unsigned int ksize)
+{
+	struct smd_cache_rec *rec = smd_cache_rec_obj(rlink);
+
+	return rec->scr_key_sz == ksize &&
+	       memcmp(rec->scr_buf, key, ksize) == 0;
+}
+
+static bool
+smd_cache_rec_decref(struct d_hash_table *htable, d_list_t *rlink)
+{
+	/* Records are owned by the hash table, free it once deleted */
+	return true;
+}
+
+static void
+smd_cache_rec_free(struct d_hash_table *htable, d_list_t *rlink)
+{
+	struct smd_cache_rec *rec = smd_cache_rec_obj(rlink);
+
+	D_FREE(rec);
+}
+
+static d_hash_table_ops_t smd_cache_ops = {
+	.hop_key_cmp	= smd_cache_key_cmp,
+	.hop_rec_decref	= smd_cache_rec_decref,
+	.hop_rec_free	= smd_cache_rec_free,
+};
+
+static struct smd_cache *
+smd_cache_lookup(char *table)
+{
+	int	i;
+
+	if (!smd_cache_ready)
+		return NULL;
+
+	for (i = 0; i < SMD_CACHE_NR; i++) {
+		if (strcmp(smd_caches[i].sc_table, table) == 0)
+			return &smd_caches[i];
+	}
+	return NULL;
+}
+
+static int
+smd_cache_upsert(struct smd_cache *sc, void *key, int key_size, void *val,
+		 int val_size)
+{
+	struct smd_cache_rec	*rec;
+	d_list_t		*rlink;
+	int			 rc;
+
+	rlink = d_hash_rec_find(&sc->sc_htable, key, key_size);
+	if (rlink != NULL) {
+		rec = smd_cache_rec_obj(rlink);
+		D_ASSERT(rec->scr_val_sz == val_size);
+		memcpy(smd_cache_rec_val(rec), val, val_size);
+		return 0;
+	}
+
+	D_ALLOC(rec, sizeof(*rec) + key_size + val_size);
+	if (rec == NULL)
+		return -DER_NOMEM;
+
+	rec->scr_key_sz = key_size;
+	rec->scr_val_sz = val_size;
+	memcpy(rec->scr_buf, key, key_size);
+	memcpy(smd_cache_rec_val(rec), val, val_size);
+
+	rc = d_hash_rec_insert(&sc->sc_htable, key, key_size, &rec->scr_link,
+			       true);
+	if (rc)
+		D_FREE(rec);
+	return rc;
+}
+
+static void
+smd_cache_fini(void)
+{
+	int	i;
+
+	if (!smd_cache_ready)
+		return;
+
+	for (i = 0; i < SMD_CACHE_NR; i++)
+		d_hash_table_destroy_inplace(&smd_caches[i].sc_htable, true);
+	smd_cache_ready = false;
+}
+
+/* Drop the DRAM index when it can't be kept in sync with sys_db */
+static void
+smd_cache_drop(int err)
+{
+	D_WARN("Drop SMD DRAM index, fall back to sys_db. "DF_RC"\n",
+	       DP_RC(err));
+	smd_cache_fini();
+}
+
+static int
+smd_cache_load_cb(struct sys_db *db, char *table, d_iov_t *key, void *args)
+{
+	struct smd_cache	*sc = args;
+	union {
+		struct smd_device	dev;
+		struct smd_pool		pool;
+		struct d_uuid		id;
+	}			 buf;
+	d_iov_t			 val;
+	int			 rc;
+
+	D_ASSERT(sc->sc_val_sz <= sizeof(buf));
+	d_iov_set(&val, &buf, sc->sc_val_sz);
+	rc = db->sd_fetch(db, table, key, &val);
+	if (rc)
+		return rc;
+
+	return smd_cache_upsert(sc, key->iov_buf, key->iov_len, &buf,
+				sc->sc_val_sz);
+}
+
+static int
+smd_cache_init(void)
+{
+	int	i, rc;
+
+	D_ASSERT(!smd_cache_ready);
+	for (i = 0; i < SMD_CACHE_NR; i++) {
+		rc = d_hash_table_create_inplace(D_HASH_FT_NOLOCK,
+						 SMD_CACHE_BITS, NULL,
+						 &smd_cache_ops,
+						 &smd_caches[i].sc_htable);
+		if (rc)
+			goto failed;
+	}
+	smd_cache_ready = true;
+
+	for (i = 0; i < SMD_CACHE_NR; i++) {
+		rc = smd_db->sd_traverse(smd_db, smd_caches[i].sc_table,
+					 smd_cache_load_cb, &smd_caches[i]);
+		if (rc) {
+			smd_cache_fini();
+			return rc;
+		}
+	}
+	return 0;
+failed:
+	while (--i >= 0)
+		d_hash_table_destroy_inplace(&smd_caches[i].sc_htable, true);
+	return rc;
+}
+
 int
 smd_db_fetch(char *table, void *key, int key_size, void *val, int val_size)
 {
-	d_iov_t	key_iov;
-	d_iov_t	val_iov;
+	struct smd_cache	*sc;
+	struct smd_cache_rec	*rec;
+	d_list_t		*rlink;
+	d_iov_t			 key_iov;
+	d_iov_t			 val_iov;
+
+	sc = smd_cache_lookup(table);
+	if (sc != NULL) {
+		rlink = d_hash_rec_find(&sc->sc_htable, key, key_size);
+		if (rlink == NULL)
+			return -DER_NONEXIST;
+
+		rec = smd_cache_rec_obj(rlink);
+		D_ASSERT(rec->scr_val_sz == val_size);
+		memcpy(val, smd_cache_rec_val(rec), val_size);
+		return 0;
+	}
 
 	d_iov_set(&key_iov, key, key_size);
 	d_iov_set(&val_iov, val, val_size);
@@ -32,27 +246,77 @@ smd_db_fetch(char *table, void *key, int key_size, void *val, int val_size)
 int
 smd_db_upsert(char *table, void *key, int key_size, void *val, int val_size)
 {
-	d_iov_t	key_iov;
-	d_iov_t	val_iov;
+	struct smd_cache	*sc;
+	d_iov_t			 key_iov;
+	d_iov_t			 val_iov;
+	int			 rc;
 
 	d_iov_set(&key_iov, key, key_size);
 	d_iov_set(&val_iov, val, val_size);
 
-	return smd_db->sd_upsert(smd_db, table, &key_iov, &val_iov);
+	rc = smd_db->sd_upsert(smd_db, table, &key_iov, &val_iov);
+	if (rc)
+		return rc;
+
+	sc = smd_cache_lookup(table);
+	if (sc != NULL) {
+		rc = smd_cache_upsert(sc, key, key_size, val, val_size);
+		if (rc)
+			smd_cache_drop(rc);
+	}
+	return 0;
 }
 
 int
 smd_db_delete(char *table, void *key, int key_size)
 {
-	d_iov_t	key_iov;
+	struct smd_cache	*sc;
+	d_iov_t			 key_iov;
+	int			 rc;
 
 	d_iov_set(&key_iov, key, key_size);
-	return smd_db->sd_delete(smd_db, table, &key_iov);
+	rc = smd_db->sd_delete(smd_db, table, &key_iov);
+	if (rc)
+		return rc;
+
+	sc = smd_cache_lookup(table);
+	if (sc != NULL)
+		d_hash_rec_delete(&sc->sc_htable, key, key_size);
+	return 0;
+}
+
+struct smd_cache_trav_args {
+	char			*ta_table;
+	sys_db_trav_cb_t	 ta_cb;
+	void			*ta_args;
+};
+
+static int
+smd_cache_trav_cb(d_list_t *rlink, void *args)
+{
+	struct smd_cache_trav_args	*ta = args;
+	struct smd_cache_rec		*rec = smd_cache_rec_obj(rlink);
+	d_iov_t				 key;
+
+	d_iov_set(&key, rec->scr_buf, rec->scr_key_sz);
+	return ta->ta_cb(smd_db, ta->ta_table, &key, ta->ta_args);
 }
 
 int
 smd_db_traverse(char *table, sys_db_trav_cb_t cb, struct smd_trav_data *td)
 {
+	struct smd_cache		*sc;
+	struct smd_cache_trav_args	 ta;
+
+	sc = smd_cache_lookup(table);
+	if (sc != NULL) {
+		ta.ta_table = table;
+		ta.ta_cb = cb;
+		ta.ta_args = td;
+		return d_hash_table_traverse(&sc->sc_htable, smd_cache_trav_cb,
+					     &ta);
+	}
+
 	return smd_db->sd_traverse(smd_db, table, cb, td);
 }
 
@@ -69,9 +333,22 @@ int
 smd_db_tx_end(int rc)
 {
 	if (smd_db->sd_tx_end)
-		return smd_db->sd_tx_end(smd_db, rc);
-	else
-		return rc;
+		rc = smd_db->sd_tx_end(smd_db, rc);
+
+	/*
+	 * The updates in an aborted transaction have been applied to the
+	 * DRAM index, reload the index from sys_db.
+	 */
+	if (rc && smd_cache_ready) {
+		int	rc1;
+
+		smd_cache_fini();
+		rc1 = smd_cache_init();
+		if (rc1)
+			D_WARN("Reload SMD DRAM index failed, fall back to "
+			       "sys_db. "DF_RC"\n", DP_RC(rc1));
+	}
+	return rc;
 }
 
 bool
@@ -97,17 +374,25 @@ smd_db_unlock(void)
 void
 smd_fini(void)
 {
+	smd_cache_fini();
 	smd_db = NULL;
 }
 
 int
 smd_init(struct sys_db *db)
 {
+	int	rc;
+
 	D_ASSERT(db->sd_fetch);
 	D_ASSERT(db->sd_upsert);
 	D_ASSERT(db->sd_delete);
 	D_ASSERT(db->sd_traverse);
 
 	smd_db = db;
+
+	rc = smd_cache_init();
+	if (rc)
+		D_WARN("Load SMD DRAM index failed, fall back to sys_db. "
+		       DF_RC"\n", DP_RC(rc));
 	return 0;
 }
@@ -493,10 +493,67 @@ ut_dev_replace(void **state)
 	}
 }
 
+static void
+ut_reload(void **state)
+{
+	struct smd_dev_info	*dev_info;
+	struct sys_db		*db = &ut_db.ud_db;
+	struct smd_device	 dev;
+	struct d_uuid		 id;
+	d_iov_t			 key, val;
+	d_list_t		 pool_list;
+	uint64_t		 blob_id;
+	int			 rc, pool_cnt = 0;
+
+	/* Modify sys_db behind SMD, DRAM index isn't aware of it */
+	uuid_copy(id.uuid, dev_id2);
+	d_iov_set(&key, &id, sizeof(id));
+	d_iov_set(&val, &dev, sizeof(dev));
+	rc = db->sd_fetch(db, TABLE_DEV, &key, &val);
+	assert_rc_equal(rc, 0);
+	dev.sd_state = SMD_DEV_NORMAL;
+	rc = db->sd_upsert(db, TABLE_DEV, &key, &val);
+	assert_rc_equal(rc, 0);
+
+	rc = smd_dev_get_by_tgt(3, &dev_info);
+	assert_rc_equal(rc, 0);
+	verify_dev(dev_info, dev_id2, 2);
+	smd_dev_free_info(dev_info);
+
+	/* Reload DRAM index from sys_db */
+	smd_fini();
+	rc = smd_init(db);
+	assert_rc_equal(rc, 0);
+
+	rc = smd_dev_get_by_tgt(3, &dev_info);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(dev_info->sdi_state, SMD_DEV_NORMAL);
+	smd_dev_free_info(dev_info);
+
+	D_INIT_LIST_HEAD(&pool_list);
+	rc = smd_pool_list(&pool_list, &pool_cnt);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(pool_cnt, 2);
+
+	while (!d_list_empty(&pool_list)) {
+		struct smd_pool_info	*pool_info;
+
+		pool_info = d_list_entry(pool_list.next, struct smd_pool_info,
+					 spi_link);
+		rc = smd_pool_get_blob(pool_info->spi_id, 1, &blob_id);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(blob_id, 666);
+
+		d_list_del(&pool_info->spi_link);
+		smd_pool_free_info(pool_info);
+	}
+}
+
 static const struct CMUnitTest smd_uts[] = {
 	{ "smd_ut_device", ut_device, NULL, NULL},
 	{ "smd_ut_pool", ut_pool, NULL, NULL},
 	{ "smd_ut_dev_replace", ut_dev_replace, NULL, NULL},
+	{ "smd_ut_reload", ut_reload, NULL, NULL},
 };
 
 int main(int argc, char **argv)
@@ -6,6 +6,7 @@
 #define D_LOGFAC       DD_FAC(client)
 
 #include <daos/container.h>
+#include <daos/object.h>
 #include <daos/task.h>
 #include "client_internal.h"
 #include "task_internal.h"
@@ -764,6 +765,23 @@ daos_cont_create_snap(daos_handle_t coh, daos_epoch_t *epoch, char *name,
 					 DAOS_SNAP_OPT_CR, ev);
 }
 
+int
+daos_cont_flush(daos_handle_t coh, daos_event_t *ev)
+{
+	daos_cont_flush_t	*args;
+	tse_task_t		*task;
+	int			 rc;
+
+	rc = dc_task_create(dc_tx_wcq_flush, NULL, ev, &task);
+	if (rc)
+		return rc;
+
+	args = dc_task_get_args(task);
+	args->coh	= coh;
+
+	return dc_task_schedule(task, true);
+}
+
 int
 daos_cont_destroy_snap(daos_handle_t coh, daos_epoch_range_t epr,
 		       daos_event_t *ev)
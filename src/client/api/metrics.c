@@ -393,6 +393,30 @@ daos_metrics_get_cntrs(enum daos_metrics_cntr_grp mc_grp, daos_metrics_ucntrs_t
 				cntrs->mc_grp = DAOS_METRICS_OBJ_RPC_CNTR;
 			}
 			break;
+		case DAOS_METRICS_OBJ_LAYOUT_CNTR:
+			rc = dc_obj_metrics_get_layout_cntrs(&cntrs->u.arc_layout_cntrs);
+			if (rc != 0) {
+				D_ERROR("Failed to obtain object layout counters, rc = %d\n", rc);
+			} else  {
+				cntrs->mc_grp = DAOS_METRICS_OBJ_LAYOUT_CNTR;
+			}
+			break;
+		case DAOS_METRICS_OBJ_EC_CNTR:
+			rc = dc_obj_metrics_get_ec_cntrs(&cntrs->u.arc_ec_cntrs);
+			if (rc != 0) {
+				D_ERROR("Failed to obtain object EC counters, rc = %d\n", rc);
+			} else  {
+				cntrs->mc_grp = DAOS_METRICS_OBJ_EC_CNTR;
+			}
+			break;
+		case DAOS_METRICS_OBJ_EC_RECOV_CNTR:
+			rc = dc_obj_metrics_get_ec_recov_cntrs(&cntrs->u.arc_ec_recov_cntrs);
+			if (rc != 0) {
+				D_ERROR("Failed to obtain object EC recovery counters, rc = %d\n", rc);
+			} else  {
+				cntrs->mc_grp = DAOS_METRICS_OBJ_EC_RECOV_CNTR;
+			}
+			break;
 		default:
 			D_ERROR("Invalid argument mc_grp = %d\n", mc_grp);
 			rc = -DER_INVAL;
@@ -678,6 +702,105 @@ out:
 	return rc;
 }
 
+static int
+dump_obj_layout_cntrs(FILE *fp)
+{
+	int rc;
+	daos_metrics_ucntrs_t *cntrs;
+	daos_metrics_obj_layout_cntrs_t *lcntrs;
+
+	rc = daos_metrics_alloc_cntrsbuf(&cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj layout counters rc = %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	rc = daos_metrics_get_cntrs(DAOS_METRICS_OBJ_LAYOUT_CNTR, cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj layout counters rc = %d\n", rc);
+		D_GOTO(alloc_out, rc);
+	}
+
+	lcntrs = &cntrs->u.arc_layout_cntrs;
+
+	fprintf(fp, "****************  Dumping Object Layout Cache Counters ****************\n");
+	fprintf(fp, "%-16s\t%12s\t%12s\t%12s\n","Name","Hit","Miss","Invalidated");
+	fprintf(fp, "%-16s\t%12lu\t%12lu\t%12lu\n","obj layout", lcntrs->lcc_hit, \
+			lcntrs->lcc_miss, lcntrs->lcc_inval);
+	fflush(fp);
+alloc_out:
+	daos_metrics_free_cntrsbuf(cntrs);
+out:
+	return rc;
+}
+
+static int
+dump_obj_ec_cntrs(FILE *fp)
+{
+	int rc;
+	daos_metrics_ucntrs_t *cntrs;
+	daos_metrics_obj_ec_cntrs_t *ecntrs;
+	double mbps = 0;
+
+	rc = daos_metrics_alloc_cntrsbuf(&cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj EC counters rc = %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	rc = daos_metrics_get_cntrs(DAOS_METRICS_OBJ_EC_CNTR, cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj EC counters rc = %d\n", rc);
+		D_GOTO(alloc_out, rc);
+	}
+
+	ecntrs = &cntrs->u.arc_ec_cntrs;
+	if (ecntrs->ecc_nsec != 0)
+		mbps = (double)ecntrs->ecc_bytes * 1000 / ecntrs->ecc_nsec;
+
+	fprintf(fp, "*******************  Dumping Object EC Encoding Counters ********************\n");
+	fprintf(fp, "%-16s\t%12s\t%12s\t%16s\t%12s\n","Name","Stripes","Offloaded","Bytes","MB/s");
+	fprintf(fp, "%-16s\t%12lu\t%12lu\t%16lu\t%12.2f\n","ec encode", ecntrs->ecc_stripes, \
+			ecntrs->ecc_offloaded, ecntrs->ecc_bytes, mbps);
+	fflush(fp);
+alloc_out:
+	daos_metrics_free_cntrsbuf(cntrs);
+out:
+	return rc;
+}
+
+static int
+dump_obj_ec_recov_cntrs(FILE *fp)
+{
+	int rc;
+	daos_metrics_ucntrs_t *cntrs;
+	daos_metrics_obj_ec_recov_cntrs_t *rcntrs;
+
+	rc = daos_metrics_alloc_cntrsbuf(&cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj EC recovery counters rc = %d\n", rc);
+		D_GOTO(out, rc);
+	}
+
+	rc = daos_metrics_get_cntrs(DAOS_METRICS_OBJ_EC_RECOV_CNTR, cntrs);
+	if (rc != 0) {
+		D_ERROR("Failed to dump obj EC recovery counters rc = %d\n", rc);
+		D_GOTO(alloc_out, rc);
+	}
+
+	rcntrs = &cntrs->u.arc_ec_recov_cntrs;
+	fprintf(fp, "*******************  Dumping Object EC Recovery Counters ********************\n");
+	fprintf(fp, "%-16s\t%12s\t%12s\t%12s\t%12s\t%12s\n","Name","Fetches","Stripes","Hit","Miss","Evicted");
+	fprintf(fp, "%-16s\t%12lu\t%12lu\t%12lu\t%12lu\t%12lu\n","ec recovery", rcntrs->erc_fetches, \
+			rcntrs->erc_stripes, rcntrs->erc_cache_hit, rcntrs->erc_cache_miss, \
+			rcntrs->erc_cache_evict);
+	fflush(fp);
+alloc_out:
+	daos_metrics_free_cntrsbuf(cntrs);
+out:
+	return rc;
+}
+
 static int
 dump_obj_stats(FILE *fp)
 {
@@ -857,6 +980,18 @@ daos_metrics_dump(FILE *fp)
 	if (rc != 0) {
 		D_GOTO(out, rc);
 	}
+	rc = dump_obj_layout_cntrs(fp);
+	if (rc != 0) {
+		D_GOTO(out, rc);
+	}
+	rc = dump_obj_ec_cntrs(fp);
+	if (rc != 0) {
+		D_GOTO(out, rc);
+	}
+	rc = dump_obj_ec_recov_cntrs(fp);
+	if (rc != 0) {
+		D_GOTO(out, rc);
+	}
 	rc = dump_obj_stats(fp);
 	if (rc != 0) {
 		D_GOTO(out, rc);
@@ -148,6 +148,14 @@ dc_task_get_args(tse_task_t *task)
 	return &task_ptr2args(task)->ta_u;
 }
 
+bool
+dc_task_is_blocking(tse_task_t *task)
+{
+	daos_event_t *ev = task_ptr2args(task)->ta_ev;
+
+	return ev != NULL && daos_event_is_priv(ev);
+}
+
 void
 dc_task_set_opc(tse_task_t *task, uint32_t opc)
 {
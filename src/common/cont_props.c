@@ -28,7 +28,8 @@ daos_props_2cont_props(daos_prop_t *props, struct cont_props *cont_prop)
 	    daos_prop_entry_get(props, DAOS_PROP_CO_ENCRYPT) == NULL	     ||
 	    daos_prop_entry_get(props, DAOS_PROP_CO_REDUN_FAC) == NULL	     ||
 	    daos_prop_entry_get(props, DAOS_PROP_CO_ALLOCED_OID) == NULL     ||
-	    daos_prop_entry_get(props, DAOS_PROP_CO_EC_CELL_SZ) == NULL)
+	    daos_prop_entry_get(props, DAOS_PROP_CO_EC_CELL_SZ) == NULL     ||
+	    daos_prop_entry_get(props, DAOS_PROP_CO_EC_PDELTA) == NULL)
 		D_DEBUG(DB_TRACE, "some prop entry type not found, "
 			"use default value.\n");
 
@@ -58,6 +59,8 @@ daos_props_2cont_props(daos_prop_t *props, struct cont_props *cont_prop)
 	cont_prop->dcp_redun_fac	= daos_cont_prop2redunfac(props);
 	/** EC cell size */
 	cont_prop->dcp_ec_cell_sz	= daos_cont_prop2ec_cell_sz(props);
+	/** EC parity delta */
+	cont_prop->dcp_ec_pdelta	= daos_cont_prop2ec_pdelta(props);
 
 	/** alloc'ed oid */
 	cont_prop->dcp_alloced_oid	= daos_cont_prop2allocedoid(props);
@@ -225,6 +228,17 @@ daos_cont_prop2ec_cell_sz(daos_prop_t *props)
 	return prop == NULL ? 0 : (uint32_t)prop->dpe_val;
 }
 
+/** Whether EC aggregation ships parity deltas for a container. */
+bool
+daos_cont_prop2ec_pdelta(daos_prop_t *props)
+{
+	struct daos_prop_entry *prop =
+		daos_prop_entry_get(props, DAOS_PROP_CO_EC_PDELTA);
+
+	return prop == NULL ? false :
+	       prop->dpe_val == DAOS_PROP_CO_EC_PDELTA_ON;
+}
+
 /** Convert the redun_fac to number of allowed failures */
 int
 daos_cont_rf2allowedfailures(int rf)
@@ -430,6 +430,15 @@ daos_prop_valid(daos_prop_t *prop, bool pool, bool input)
 				return false;
 			}
 			break;
+		case DAOS_PROP_CO_EC_PDELTA:
+			val = prop->dpp_entries[i].dpe_val;
+			if (val != DAOS_PROP_CO_EC_PDELTA_OFF &&
+			    val != DAOS_PROP_CO_EC_PDELTA_ON) {
+				D_ERROR("invalid EC parity delta "DF_U64".\n",
+					val);
+				return false;
+			}
+			break;
 		case DAOS_PROP_CO_STATUS:
 			val = prop->dpp_entries[i].dpe_val;
 			daos_prop_val_2_co_status(val, &co_status);
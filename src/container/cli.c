@@ -16,6 +16,7 @@
 #include <daos/dedup.h>
 #include <daos/event.h>
 #include <daos/mgmt.h>
+#include <daos/object.h>
 #include <daos/pool.h>
 #include <daos/rsvc.h>
 #include <daos_types.h>
@@ -462,6 +463,7 @@ dc_cont_free(struct dc_cont *dc)
 	D_RWLOCK_DESTROY(&dc->dc_obj_list_lock);
 	D_ASSERT(d_list_empty(&dc->dc_po_list));
 	D_ASSERT(d_list_empty(&dc->dc_obj_list));
+	dc_obj_layout_cache_destroy(dc->dc_layout_cache);
 	D_FREE(dc);
 }
 
@@ -478,8 +480,15 @@ dc_cont_alloc(const uuid_t uuid)
 	uuid_copy(dc->dc_uuid, uuid);
 	D_INIT_LIST_HEAD(&dc->dc_obj_list);
 	D_INIT_LIST_HEAD(&dc->dc_po_list);
-	if (D_RWLOCK_INIT(&dc->dc_obj_list_lock, NULL) != 0)
+	if (D_RWLOCK_INIT(&dc->dc_obj_list_lock, NULL) != 0) {
 		D_FREE(dc);
+		return NULL;
+	}
+
+	if (dc_obj_layout_cache_create(&dc->dc_layout_cache) != 0) {
+		D_RWLOCK_DESTROY(&dc->dc_obj_list_lock);
+		D_FREE(dc);
+	}
 
 	return dc;
 }
@@ -1212,6 +1221,9 @@ cont_query_bits(daos_prop_t *prop)
 		case DAOS_PROP_CO_EC_CELL_SZ:
 			bits |= DAOS_CO_QUERY_PROP_EC_CELL_SZ;
 			break;
+		case DAOS_PROP_CO_EC_PDELTA:
+			bits |= DAOS_CO_QUERY_PROP_EC_PDELTA;
+			break;
 		default:
 			D_ERROR("ignore bad dpt_type %d.\n", entry->dpe_type);
 			break;
@@ -3081,6 +3093,38 @@ dc_cont_hdl2redunfac(daos_handle_t coh)
 	return rc;
 }
 
+uint64_t
+dc_cont_hdl2capas(daos_handle_t coh)
+{
+	struct dc_cont	*dc;
+	uint64_t	 capas;
+
+	dc = dc_hdl2cont(coh);
+	if (dc == NULL)
+		return 0;
+
+	capas = dc->dc_capas;
+	dc_cont_put(dc);
+
+	return capas;
+}
+
+struct dc_obj_layout_cache *
+dc_cont_hdl2layout_cache(daos_handle_t coh)
+{
+	struct dc_cont			*dc;
+	struct dc_obj_layout_cache	*cache;
+
+	dc = dc_hdl2cont(coh);
+	if (dc == NULL)
+		return NULL;
+
+	cache = dc->dc_layout_cache;
+	dc_cont_put(dc);
+
+	return cache;
+}
+
 struct daos_csummer *
 dc_cont_hdl2csummer(daos_handle_t coh)
 {
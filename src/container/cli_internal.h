@@ -27,6 +27,8 @@ struct dc_cont {
 	/* pool handler of the container */
 	daos_handle_t		dc_pool_hdl;
 	struct daos_csummer    *dc_csummer;
+	/* cached object layouts, NULL if the cache is disabled */
+	struct dc_obj_layout_cache *dc_layout_cache;
 	struct cont_props	dc_props;
 	/* minimal pmap version */
 	uint32_t		dc_min_ver;
@@ -91,6 +91,7 @@ extern d_iov_t ds_cont_attr_user;		/* user attribute KVS */
 extern d_iov_t ds_cont_prop_handles;		/* handle index KVS */
 extern d_iov_t ds_cont_prop_roots;		/* container first citizens */
 extern d_iov_t ds_cont_prop_ec_cell_sz;		/* cell size of EC */
+extern d_iov_t ds_cont_prop_ec_pdelta;		/* uint64_t */
 
 /*
  * Snapshot KVS (RDB_KVS_INTEGER)
@@ -37,15 +37,6 @@
 
 /* Per VOS container aggregation ULT ***************************************/
 
-/*
- * VOS aggregation should try to avoid aggregating in the epoch range where
- * lots of data records are pending to commit, so the highest aggregate epoch
- * will be:
- *
- * current HLC - (DTX batched commit threshold + buffer period)
- */
-#define DAOS_AGG_THRESHOLD	(DTX_COMMIT_THRESHOLD_AGE + 10) /* seconds */
-
 #define DAOS_AGG_LAZY_RATE	50 /* ms */
 
 bool
@@ -82,7 +73,7 @@ ds_cont_get_props(struct cont_props *cont_props, uuid_t pool_uuid,
 	/* The provided prop entry types should cover the types used in
 	 * daos_props_2cont_props().
 	 */
-	props = daos_prop_alloc(10);
+	props = daos_prop_alloc(11);
 	if (props == NULL)
 		return -DER_NOMEM;
 
@@ -96,6 +87,7 @@ ds_cont_get_props(struct cont_props *cont_props, uuid_t pool_uuid,
 	props->dpp_entries[7].dpe_type = DAOS_PROP_CO_REDUN_FAC;
 	props->dpp_entries[8].dpe_type = DAOS_PROP_CO_ALLOCED_OID;
 	props->dpp_entries[9].dpe_type = DAOS_PROP_CO_EC_CELL_SZ;
+	props->dpp_entries[10].dpe_type = DAOS_PROP_CO_EC_PDELTA;
 
 	rc = cont_iv_prop_fetch(pool_uuid, cont_uuid, props);
 	if (rc == DER_SUCCESS)
@@ -749,6 +741,7 @@ cont_child_free_ref(struct daos_llink *llink)
 	vos_cont_close(cont->sc_hdl);
 	ds_pool_child_put(cont->sc_pool);
 	daos_csummer_destroy(&cont->sc_csummer);
+	D_FREE(cont->sc_dtx_cmt_cache);
 
 	ABT_cond_free(&cont->sc_dtx_resync_cond);
 	ABT_mutex_free(&cont->sc_mutex);
@@ -417,6 +417,36 @@ var propHdlrs = propHdlrMap{
 		},
 		false,
 	},
+	"ec_pdelta": {
+		C.DAOS_PROP_CO_EC_PDELTA,
+		"EC Parity Delta",
+		func(h *propHdlr, e *C.struct_daos_prop_entry, v string) error {
+			vh, err := h.valHdlrs.get("ec_pdelta", v)
+			if err != nil {
+				return err
+			}
+
+			return vh(e, v)
+		},
+		valHdlrMap{
+			"on":  setDpeVal(C.DAOS_PROP_CO_EC_PDELTA_ON),
+			"off": setDpeVal(C.DAOS_PROP_CO_EC_PDELTA_OFF),
+		},
+		func(e *C.struct_daos_prop_entry, name string) string {
+			if e == nil {
+				return propNotFound(name)
+			}
+			switch C.get_dpe_val(e) {
+			case C.DAOS_PROP_CO_EC_PDELTA_OFF:
+				return "off"
+			case C.DAOS_PROP_CO_EC_PDELTA_ON:
+				return "on"
+			default:
+				return propInvalidValue(e, name)
+			}
+		},
+		false,
+	},
 	// Read-only properties here for use by get-property.
 	"layout_type": {
 		C.DAOS_PROP_CO_LAYOUT_TYPE,
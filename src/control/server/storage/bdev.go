@@ -265,6 +265,7 @@ type (
 		DeviceList     []string
 		DeviceFileSize uint64 // size in bytes for NVMe device emulation
 		Tier           int
+		Uring          bool // use io_uring instead of AIO for emulation
 	}
 
 	// BdevFormatRequest defines the parameters for a Format operation.
@@ -36,6 +36,7 @@ func TestBackend_writeJsonConfig(t *testing.T) {
 		fileSizeGB         int
 		devList            []string
 		enableVmd          bool
+		uring              bool
 		vosEnv             string
 		expExtraBdevCfgs   []*SpdkSubsystemConfig
 		expExtraSubsystems []*SpdkSubsystem
@@ -155,6 +156,51 @@ func TestBackend_writeJsonConfig(t *testing.T) {
 			},
 			vosEnv: "AIO",
 		},
+		"uring file class; non-zero file size": {
+			class:      storage.ClassFile,
+			fileSizeGB: 1,
+			uring:      true,
+			devList:    []string{"/path/to/myfile"},
+			expExtraBdevCfgs: []*SpdkSubsystemConfig{
+				{
+					Method: SpdkBdevUringCreate,
+					Params: UringCreateParams{
+						BlockSize:  humanize.KiByte * 4,
+						DeviceName: fmt.Sprintf("URING_%s_0_%d", host, tierId),
+						Filename:   "/path/to/myfile",
+					},
+				},
+			},
+			vosEnv: "URING",
+		},
+		"uring kdev class; multiple devices": {
+			class:   storage.ClassKdev,
+			uring:   true,
+			devList: []string{"/dev/sdb", "/dev/sdc"},
+			expExtraBdevCfgs: []*SpdkSubsystemConfig{
+				{
+					Method: SpdkBdevUringCreate,
+					Params: UringCreateParams{
+						DeviceName: fmt.Sprintf("URING_%s_0_%d", host, tierId),
+						Filename:   "/dev/sdb",
+					},
+				},
+				{
+					Method: SpdkBdevUringCreate,
+					Params: UringCreateParams{
+						DeviceName: fmt.Sprintf("URING_%s_1_%d", host, tierId),
+						Filename:   "/dev/sdc",
+					},
+				},
+			},
+			vosEnv: "URING",
+		},
+		"uring nvme class": {
+			class:          storage.ClassNvme,
+			uring:          true,
+			devList:        []string{common.MockPCIAddr(1)},
+			expValidateErr: errors.New("doesn't support bdev_uring"),
+		},
 	}
 
 	for name, tc := range tests {
@@ -168,6 +214,7 @@ func TestBackend_writeJsonConfig(t *testing.T) {
 				Bdev: storage.BdevConfig{
 					DeviceList: tc.devList,
 					FileSize:   tc.fileSizeGB,
+					Uring:      tc.uring,
 				},
 			}
 			if tc.class != "" {
@@ -23,6 +23,7 @@ const (
 	SpdkBdevNvmeSetHotplug       = "bdev_nvme_set_hotplug"
 	SpdkVmdEnable                = "enable_vmd"
 	SpdkBdevAioCreate            = "bdev_aio_create"
+	SpdkBdevUringCreate          = "bdev_uring_create"
 )
 
 // SpdkSubsystemConfigParams is an interface that defines an object that
@@ -82,6 +83,15 @@ type AioCreateParams struct {
 
 func (acp AioCreateParams) isSpdkSubsystemConfigParams() {}
 
+// UringCreateParams specifies details for a SpdkBdevUringCreate method.
+type UringCreateParams struct {
+	BlockSize  uint64 `json:"block_size,omitempty"`
+	DeviceName string `json:"name"`
+	Filename   string `json:"filename"`
+}
+
+func (ucp UringCreateParams) isSpdkSubsystemConfigParams() {}
+
 // SpdkSubsystemConfig entries apply to any SpdkSubsystem.
 type SpdkSubsystemConfig struct {
 	Params SpdkSubsystemConfigParams `json:"params"`
@@ -171,6 +181,27 @@ func getAioKdevCreateMethod(name, path string) *SpdkSubsystemConfig {
 	}
 }
 
+func getUringFileCreateMethod(name, path string) *SpdkSubsystemConfig {
+	return &SpdkSubsystemConfig{
+		Method: SpdkBdevUringCreate,
+		Params: UringCreateParams{
+			DeviceName: fmt.Sprintf("URING_%s", name),
+			Filename:   path,
+			BlockSize:  aioBlockSize,
+		},
+	}
+}
+
+func getUringKdevCreateMethod(name, path string) *SpdkSubsystemConfig {
+	return &SpdkSubsystemConfig{
+		Method: SpdkBdevUringCreate,
+		Params: UringCreateParams{
+			DeviceName: fmt.Sprintf("URING_%s", name),
+			Filename:   path,
+		},
+	}
+}
+
 func getSpdkConfigMethods(req *storage.BdevWriteNvmeConfigRequest) (sscs []*SpdkSubsystemConfig) {
 	for _, tier := range req.TierProps {
 		var f configMethodGetter
@@ -180,8 +211,14 @@ func getSpdkConfigMethods(req *storage.BdevWriteNvmeConfigRequest) (sscs []*Spdk
 			f = getNvmeAttachMethod
 		case storage.ClassFile:
 			f = getAioFileCreateMethod
+			if tier.Uring {
+				f = getUringFileCreateMethod
+			}
 		case storage.ClassKdev:
 			f = getAioKdevCreateMethod
+			if tier.Uring {
+				f = getUringKdevCreateMethod
+			}
 		}
 
 		for index, dev := range tier.DeviceList {
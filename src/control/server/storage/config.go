@@ -153,6 +153,12 @@ func (c *TierConfig) WithBdevDeviceCount(count int) *TierConfig {
 	return c
 }
 
+// WithBdevUring selects io_uring instead of Linux AIO for file and kdev classes.
+func (c *TierConfig) WithBdevUring(uring bool) *TierConfig {
+	c.Bdev.Uring = uring
+	return c
+}
+
 // WithBdevFileSize sets the backing file size (used when BdevClass is malloc or file).
 func (c *TierConfig) WithBdevFileSize(size int) *TierConfig {
 	c.Bdev.FileSize = size
@@ -180,6 +186,9 @@ func (sc *Config) Validate() error {
 		switch bdevCfgs[0].Class {
 		case ClassFile, ClassKdev:
 			sc.VosEnv = "AIO"
+			if bdevCfgs[0].Bdev.Uring {
+				sc.VosEnv = "URING"
+			}
 		case ClassNvme:
 			sc.VosEnv = "NVME"
 		}
@@ -286,6 +295,7 @@ type BdevConfig struct {
 	VmdDisabled bool     `yaml:"-"` // set during start-up
 	DeviceCount int      `yaml:"bdev_number,omitempty"`
 	FileSize    int      `yaml:"bdev_size,omitempty"`
+	Uring       bool     `yaml:"bdev_uring,omitempty"`
 }
 
 func (bc *BdevConfig) checkNonZeroDevFileSize(class Class) error {
@@ -328,6 +338,9 @@ func (bc *BdevConfig) Validate(class Class) error {
 			return err
 		}
 	case ClassNvme:
+		if bc.Uring {
+			return errors.Errorf("bdev_class %s doesn't support bdev_uring", class)
+		}
 		for _, pci := range bc.DeviceList {
 			_, _, _, _, err := common.ParsePCIAddress(pci)
 			if err != nil {
@@ -86,10 +86,7 @@ dtx_free_dbca(struct dtx_batched_cont_args *dbca)
 
 	/* Nobody re-opened it during waiting dtx_flush_on_deregister(). */
 	if (cont->sc_closing) {
-		if (daos_handle_is_valid(cont->sc_dtx_cos_hdl)) {
-			dbtree_destroy(cont->sc_dtx_cos_hdl, NULL);
-			cont->sc_dtx_cos_hdl = DAOS_HDL_INVAL;
-		}
+		dtx_cos_fini(cont);
 
 		D_ASSERT(cont->sc_dtx_committable_count == 0);
 		D_ASSERT(d_list_empty(&cont->sc_dtx_cos_list));
@@ -512,6 +509,7 @@ void
 dtx_batched_commit(void *arg)
 {
 	struct dss_module_info		*dmi = dss_get_module_info();
+	struct dtx_tls			*tls = dtx_tls_get();
 	struct dtx_batched_cont_args	*dbca;
 	struct dtx_batched_cont_args	*tmp;
 	ABT_thread			 child;
@@ -559,6 +557,9 @@ dtx_batched_commit(void *arg)
 		d_list_move_tail(&dbca->dbca_sys_link,
 				 &dmi->dmi_dtx_batched_cont_list);
 		dtx_stat(cont, &stat);
+		if (stat.dtx_oldest_committable_time != 0)
+			d_tm_set_gauge(tls->dt_cos_age, dtx_hlc_age2sec(
+				       stat.dtx_oldest_committable_time));
 
 		if (!cont->sc_closing &&
 		    !dbca->dbca_deregister && dbca->dbca_commit_req == NULL &&
@@ -1050,6 +1051,176 @@ dtx_leader_wait(struct dtx_leader_handle *dlh)
 	return dlh->dlh_result;
 };
 
+/* The participants that need to commit the DTX via piggyback. */
+static uint64_t
+dtx_piggyback_need(struct dtx_leader_handle *dlh, struct dtx_memberships *mbs)
+{
+	struct dtx_sub_status	*sub;
+	uint64_t		 need = 0;
+	int			 i;
+	int			 j;
+
+	if (!(mbs->dm_flags & DMF_SRDG_REP) || mbs->dm_tgt_cnt > DTX_PB_TGT_MAX)
+		return 0;
+
+	for (i = 0; i < mbs->dm_tgt_cnt; i++) {
+		for (j = 0; j < dlh->dlh_sub_cnt; j++) {
+			sub = &dlh->dlh_subs[j];
+			if (sub->dss_tgt.st_rank != DAOS_TGT_IGNORE &&
+			    sub->dss_tgt.st_tgt_id == mbs->dm_tgts[i].ddt_id) {
+				need |= 1ULL << i;
+				break;
+			}
+		}
+	}
+
+	return need;
+}
+
+/**
+ * Get the DTX array to be sent via the dispatched RPC for the sub request
+ * @idx. Besides the CoS DTXs for current modification, piggyback some other
+ * committable DTXs that the target participates in, then it can commit them
+ * together with current modification, that saves the DTX_COMMIT RPC for it.
+ * If there is nothing to piggyback, then return the dth_dti_cos directly.
+ *
+ * \return	The count of DTXs in the array.
+ */
+int
+dtx_leader_piggyback(struct dtx_leader_handle *dlh, struct ds_cont_child *cont,
+		     int idx, struct dtx_id **dtis)
+{
+	struct dtx_handle	*dth = &dlh->dlh_handle;
+	struct dtx_sub_status	*sub = &dlh->dlh_subs[idx];
+	uint32_t		 cos_cnt = dth->dth_dti_cos_count;
+	int			 cnt;
+
+	/* Resent RPC for the sub request, reuse the former piggybacked ones. */
+	if (sub->dss_pb_dtis != NULL)
+		goto out;
+
+	if (daos_is_zero_dti(&dth->dth_xid) || cont->sc_closing ||
+	    cont->sc_dtx_committable_count == 0 ||
+	    DAOS_FAIL_CHECK(DAOS_DTX_NO_BATCHED_CMT) ||
+	    DAOS_FAIL_CHECK(DAOS_DTX_NO_COMMITTABLE))
+		goto out;
+
+	D_ALLOC_ARRAY(sub->dss_pb_dtis, cos_cnt + DTX_PB_MAX);
+	if (sub->dss_pb_dtis == NULL)
+		goto out;
+
+	D_ALLOC_ARRAY(sub->dss_pb_dcks, DTX_PB_MAX);
+	if (sub->dss_pb_dcks == NULL) {
+		D_FREE(sub->dss_pb_dtis);
+		goto out;
+	}
+
+	cnt = dtx_cos_piggyback(cont, sub->dss_tgt.st_tgt_id,
+				dth->dth_dti_cos, cos_cnt, DTX_PB_MAX,
+				sub->dss_pb_dtis + cos_cnt, sub->dss_pb_dcks);
+	if (cnt == 0) {
+		D_FREE(sub->dss_pb_dtis);
+		D_FREE(sub->dss_pb_dcks);
+		goto out;
+	}
+
+	if (cos_cnt > 0)
+		memcpy(sub->dss_pb_dtis, dth->dth_dti_cos,
+		       sizeof(*dth->dth_dti_cos) * cos_cnt);
+	sub->dss_pb_cnt = cnt;
+
+	D_DEBUG(DB_TRACE, "Piggyback %d DTXs to rank %u tag %u with "DF_DTI"\n",
+		cnt, sub->dss_tgt.st_rank, sub->dss_tgt.st_tgt_idx,
+		DP_DTI(&dth->dth_xid));
+
+out:
+	if (sub->dss_pb_dtis == NULL) {
+		*dtis = dth->dth_dti_cos;
+		return cos_cnt;
+	}
+
+	*dtis = sub->dss_pb_dtis;
+	return cos_cnt + sub->dss_pb_cnt;
+}
+
+/*
+ * Handle the piggybacked DTXs after all sub requests completed. Successful
+ * reply means that the target has committed them with its modification.
+ * Once all the participants committed some DTX, commit it locally and
+ * remove it from the CoS cache, the batched commit will not handle it.
+ */
+static void
+dtx_piggyback_end(struct dtx_leader_handle *dlh, struct ds_cont_child *cont)
+{
+	struct dtx_tls		*tls = dtx_tls_get();
+	struct dtx_sub_status	*sub;
+	struct dtx_id		*dtis = NULL;
+	struct dtx_cos_key	*dcks = NULL;
+	bool			*rm_cos = NULL;
+	uint32_t		 cos_cnt = dlh->dlh_handle.dth_dti_cos_count;
+	int			 total = 0;
+	int			 cnt = 0;
+	int			 rc;
+	int			 i;
+	int			 j;
+
+	for (i = 0; i < dlh->dlh_sub_cnt; i++)
+		total += dlh->dlh_subs[i].dss_pb_cnt;
+
+	if (total == 0)
+		return;
+
+	D_ALLOC_ARRAY(dtis, total);
+	D_ALLOC_ARRAY(dcks, total);
+
+	for (i = 0; i < dlh->dlh_sub_cnt; i++) {
+		sub = &dlh->dlh_subs[i];
+		for (j = 0; j < sub->dss_pb_cnt; j++) {
+			rc = dtx_cos_piggyback_done(cont,
+					&sub->dss_pb_dtis[cos_cnt + j],
+					sub->dss_tgt.st_tgt_id,
+					sub->dss_result == 0);
+			if (rc > 0 && dtis != NULL && dcks != NULL) {
+				dtis[cnt] = sub->dss_pb_dtis[cos_cnt + j];
+				dcks[cnt] = sub->dss_pb_dcks[j];
+				cnt++;
+			}
+		}
+
+		D_FREE(sub->dss_pb_dtis);
+		D_FREE(sub->dss_pb_dcks);
+		sub->dss_pb_cnt = 0;
+	}
+
+	/* Otherwise, leave them to the batched commit. */
+	if (cnt == 0)
+		goto out;
+
+	D_ALLOC_ARRAY(rm_cos, cnt);
+	if (rm_cos == NULL)
+		goto out;
+
+	rc = vos_dtx_commit(cont->sc_hdl, dtis, cnt, rm_cos);
+	if (rc < 0 && rc != -DER_NONEXIST) {
+		D_ERROR(DF_UUID": Fail to commit piggybacked DTXs "DF_DTI
+			", count %d: "DF_RC"\n", DP_UUID(cont->sc_uuid),
+			DP_DTI(&dtis[0]), cnt, DP_RC(rc));
+		goto out;
+	}
+
+	for (i = 0; i < cnt; i++) {
+		if (rm_cos[i])
+			dtx_del_cos(cont, &dtis[i], &dcks[i].oid,
+				    dcks[i].dkey_hash);
+	}
+	d_tm_inc_counter(tls->dt_piggyback, cnt);
+
+out:
+	D_FREE(rm_cos);
+	D_FREE(dtis);
+	D_FREE(dcks);
+}
+
 /**
  * Stop the leader thandle.
  *
@@ -1081,8 +1252,10 @@ dtx_leader_end(struct dtx_leader_handle *dlh, struct ds_cont_child *cont,
 	 * should still wait for remote object to finish the request.
 	 */
 
-	if (dlh->dlh_sub_cnt != 0)
+	if (dlh->dlh_sub_cnt != 0) {
 		rc = dtx_leader_wait(dlh);
+		dtx_piggyback_end(dlh, cont);
+	}
 
 	if (daos_is_zero_dti(&dth->dth_xid))
 		D_GOTO(out, result = result < 0 ? result : rc);
@@ -1214,7 +1387,8 @@ dtx_leader_end(struct dtx_leader_handle *dlh, struct ds_cont_child *cont,
 	else
 		flags = 0;
 	rc = dtx_add_cos(cont, dte, &dth->dth_leader_oid,
-			 dth->dth_dkey_hash, dth->dth_epoch, flags);
+			 dth->dth_dkey_hash, dth->dth_epoch, flags,
+			 dtx_piggyback_need(dlh, mbs));
 	dtx_entry_put(dte);
 	if (rc == 0) {
 		if (!DAOS_FAIL_CHECK(DAOS_DTX_NO_COMMITTABLE)) {
@@ -1388,8 +1562,6 @@ dtx_end(struct dtx_handle *dth, struct ds_cont_child *cont, int result)
 	return result;
 }
 
-#define DTX_COS_BTREE_ORDER		23
-
 static void
 dtx_flush_on_deregister(struct dss_module_info *dmi,
 			struct dtx_batched_cont_args *dbca)
@@ -1443,7 +1615,6 @@ dtx_batched_commit_register(struct ds_cont_child *cont)
 	d_list_t			*cont_head;
 	struct dtx_batched_pool_args	*dbpa;
 	struct dtx_batched_cont_args	*dbca;
-	struct umem_attr		 uma;
 	int				 rc;
 	bool				 new_pool = true;
 
@@ -1492,20 +1663,14 @@ dtx_batched_commit_register(struct ds_cont_child *cont)
 
 	/* Former dtx_batched_commit_deregister is waiting for
 	 * dtx_flush_on_deregister, we reopening the container.
-	 * Let's reuse the CoS tree.
+	 * Let's reuse the CoS cache.
 	 */
-	if (daos_handle_is_valid(cont->sc_dtx_cos_hdl))
+	if (cont->sc_dtx_cos_hash != NULL)
 		goto add;
 
-	memset(&uma, 0, sizeof(uma));
-	uma.uma_id = UMEM_CLASS_VMEM;
-	rc = dbtree_create_inplace_ex(DBTREE_CLASS_DTX_COS, 0,
-				      DTX_COS_BTREE_ORDER, &uma,
-				      &cont->sc_dtx_cos_btr,
-				      DAOS_HDL_INVAL, cont,
-				      &cont->sc_dtx_cos_hdl);
+	rc = dtx_cos_init(cont);
 	if (rc != 0) {
-		D_ERROR("Failed to create DTX CoS btree: "DF_RC"\n",
+		D_ERROR("Failed to create DTX CoS cache: "DF_RC"\n",
 			DP_RC(rc));
 		D_FREE(dbca);
 		if (new_pool)
@@ -1513,8 +1678,6 @@ dtx_batched_commit_register(struct ds_cont_child *cont)
 		return rc;
 	}
 
-	cont->sc_dtx_committable_count = 0;
-	D_INIT_LIST_HEAD(&cont->sc_dtx_cos_list);
 	cont->sc_dtx_resync_ver = 1;
 
 add:
@@ -10,15 +10,17 @@
  */
 #define D_LOGFAC	DD_FAC(dtx)
 
-#include <daos/btree.h>
+#include <gurt/hash.h>
 #include <daos_srv/vos.h>
 #include "dtx_internal.h"
 
-/* The record for the DTX CoS B+tree in DRAM. Each record contains current
+/* The record for the DTX CoS hash table in DRAM. Each record contains current
  * committable DTXs that modify (update or punch) something under the same
  * object and the same dkey.
  */
 struct dtx_cos_rec {
+	/* Link into the container::sc_dtx_cos_hash. */
+	d_list_t		 dcr_hlink;
 	daos_unit_oid_t		 dcr_oid;
 	uint64_t		 dcr_dkey_hash;
 	/* The DTXs in the list only modify some SVT value or EVT value
@@ -52,218 +54,198 @@ struct dtx_cos_rec {
 struct dtx_cos_rec_child {
 	/* Link into the container::sc_dtx_cos_list. */
 	d_list_t		 dcrc_gl_committable;
-	/* Link into related dcr_{reg,prio}_list. */
+	/* Link into related dcr_{reg,prio,expcmt}_list. */
 	d_list_t		 dcrc_lo_link;
+	/* Link into the container::sc_dtx_cos_xid_hash. */
+	d_list_t		 dcrc_hlink;
 	/* The DTX identifier. */
 	struct dtx_entry	*dcrc_dte;
 	/* The DTX epoch. */
 	daos_epoch_t		 dcrc_epoch;
 	/* Pointer to the dtx_cos_rec. */
 	struct dtx_cos_rec	*dcrc_ptr;
+	/* DCF_* flags, decide which dcr_*_list the DTX is linked into. */
+	uint32_t		 dcrc_flags;
+	/* The participants (bit index in dte_mbs) that need to commit the
+	 * DTX via piggyback, zero if it can only be committed via DTX RPC.
+	 */
+	uint64_t		 dcrc_pb_need;
+	/* The participants that the DTX has been piggybacked to. */
+	uint64_t		 dcrc_pb_sent;
+	/* The participants that have committed the DTX via piggyback. */
+	uint64_t		 dcrc_pb_acked;
 };
 
-struct dtx_cos_rec_bundle {
-	struct dtx_entry	*dte;
-	daos_epoch_t		 epoch;
-	uint32_t		 flags;
-};
+static inline struct dtx_cos_rec *
+dtx_cos_hlink2rec(d_list_t *rlink)
+{
+	return container_of(rlink, struct dtx_cos_rec, dcr_hlink);
+}
 
-static int
-dtx_cos_hkey_size(void)
+static inline struct dtx_cos_rec_child *
+dtx_cos_hlink2child(d_list_t *rlink)
 {
-	return sizeof(struct dtx_cos_key);
+	return container_of(rlink, struct dtx_cos_rec_child, dcrc_hlink);
 }
 
-static void
-dtx_cos_hkey_gen(struct btr_instance *tins, d_iov_t *key_iov, void *hkey)
+static bool
+dtx_cos_key_cmp(struct d_hash_table *htable, d_list_t *rlink,
+		const void *key, unsigned int ksize)
 {
-	D_ASSERT(key_iov->iov_len == sizeof(struct dtx_cos_key));
+	struct dtx_cos_rec		*dcr = dtx_cos_hlink2rec(rlink);
+	const struct dtx_cos_key	*dck = key;
 
-	memcpy(hkey, key_iov->iov_buf, key_iov->iov_len);
+	D_ASSERT(ksize == sizeof(*dck));
+
+	return dcr->dcr_dkey_hash == dck->dkey_hash &&
+	       daos_unit_oid_compare(dcr->dcr_oid, dck->oid) == 0;
 }
 
-static int
-dtx_cos_hkey_cmp(struct btr_instance *tins, struct btr_record *rec, void *hkey)
+static uint32_t
+dtx_cos_key_hash(struct d_hash_table *htable, const void *key,
+		 unsigned int ksize)
 {
-	struct dtx_cos_key *hkey1 = (struct dtx_cos_key *)&rec->rec_hkey[0];
-	struct dtx_cos_key *hkey2 = (struct dtx_cos_key *)hkey;
-	int		    rc;
-
-	rc = memcmp(hkey1, hkey2, sizeof(struct dtx_cos_key));
+	const struct dtx_cos_key *dck = key;
 
-	return dbtree_key_cmp_rc(rc);
+	return (uint32_t)d_hash_murmur64((const unsigned char *)&dck->oid,
+					 sizeof(dck->oid), dck->dkey_hash);
 }
 
-static int
-dtx_cos_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov,
-		  d_iov_t *val_iov, struct btr_record *rec)
+static uint32_t
+dtx_cos_rec_hash(struct d_hash_table *htable, d_list_t *rlink)
 {
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_key		*key;
-	struct dtx_cos_rec_bundle	*rbund;
-	struct dtx_cos_rec		*dcr;
-	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_tls			*tls = dtx_tls_get();
+	struct dtx_cos_rec	*dcr = dtx_cos_hlink2rec(rlink);
+	struct dtx_cos_key	 dck;
 
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
+	dck.oid = dcr->dcr_oid;
+	dck.dkey_hash = dcr->dcr_dkey_hash;
 
-	key = (struct dtx_cos_key *)key_iov->iov_buf;
-	rbund = (struct dtx_cos_rec_bundle *)val_iov->iov_buf;
+	return dtx_cos_key_hash(htable, &dck, sizeof(dck));
+}
 
-	D_ALLOC_PTR(dcr);
-	if (dcr == NULL)
-		return -DER_NOMEM;
+static d_hash_table_ops_t dtx_cos_hash_ops = {
+	.hop_key_cmp	= dtx_cos_key_cmp,
+	.hop_key_hash	= dtx_cos_key_hash,
+	.hop_rec_hash	= dtx_cos_rec_hash,
+};
 
-	dcr->dcr_oid = key->oid;
-	dcr->dcr_dkey_hash = key->dkey_hash;
-	D_INIT_LIST_HEAD(&dcr->dcr_reg_list);
-	D_INIT_LIST_HEAD(&dcr->dcr_prio_list);
-	D_INIT_LIST_HEAD(&dcr->dcr_expcmt_list);
+static bool
+dtx_cos_xid_cmp(struct d_hash_table *htable, d_list_t *rlink,
+		const void *key, unsigned int ksize)
+{
+	struct dtx_cos_rec_child	*dcrc = dtx_cos_hlink2child(rlink);
 
-	D_ALLOC_PTR(dcrc);
-	if (dcrc == NULL) {
-		D_FREE_PTR(dcr);
-		return -DER_NOMEM;
-	}
+	D_ASSERT(ksize == sizeof(struct dtx_id));
 
-	dcrc->dcrc_dte = dtx_entry_get(rbund->dte);
-	dcrc->dcrc_epoch = rbund->epoch;
-	dcrc->dcrc_ptr = dcr;
+	return memcmp(&dcrc->dcrc_dte->dte_xid, key, ksize) == 0;
+}
 
-	d_list_add_tail(&dcrc->dcrc_gl_committable,
-			&cont->sc_dtx_cos_list);
-	cont->sc_dtx_committable_count++;
-	d_tm_inc_gauge(tls->dt_committable, 1);
+static uint32_t
+dtx_cos_xid_hash(struct d_hash_table *htable, const void *key,
+		 unsigned int ksize)
+{
+	return (uint32_t)d_hash_murmur64(key, ksize, 0);
+}
 
-	if (rbund->flags & DCF_EXP_CMT) {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
-		dcr->dcr_expcmt_count = 1;
-	} else if (rbund->flags & DCF_SHARED) {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
-		dcr->dcr_prio_count = 1;
-	} else {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
-		dcr->dcr_reg_count = 1;
-	}
+static uint32_t
+dtx_cos_xid_rec_hash(struct d_hash_table *htable, d_list_t *rlink)
+{
+	struct dtx_cos_rec_child	*dcrc = dtx_cos_hlink2child(rlink);
 
-	rec->rec_off = umem_ptr2off(&tins->ti_umm, dcr);
+	return dtx_cos_xid_hash(htable, &dcrc->dcrc_dte->dte_xid,
+				sizeof(struct dtx_id));
+}
 
-	return 0;
+static d_hash_table_ops_t dtx_cos_xid_hash_ops = {
+	.hop_key_cmp	= dtx_cos_xid_cmp,
+	.hop_key_hash	= dtx_cos_xid_hash,
+	.hop_rec_hash	= dtx_cos_xid_rec_hash,
+};
+
+static inline int
+dtx_cos_rec_depth(struct dtx_cos_rec *dcr)
+{
+	return dcr->dcr_reg_count + dcr->dcr_prio_count +
+	       dcr->dcr_expcmt_count;
 }
 
-static int
-dtx_cos_rec_free(struct btr_instance *tins, struct btr_record *rec, void *args)
+/* Unlink the DTX from all the CoS indexes and release it. The owner record
+ * will be released together if it becomes empty.
+ */
+static void
+dtx_cos_child_del(struct ds_cont_child *cont, struct dtx_cos_rec_child *dcrc)
 {
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_rec		*dcr;
-	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_cos_rec_child	*next;
-	int				 dec = 0;
-	struct dtx_tls			*tls = dtx_tls_get();
+	struct dtx_cos_rec	*dcr = dcrc->dcrc_ptr;
 
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
+	d_hash_rec_delete_at(cont->sc_dtx_cos_xid_hash, &dcrc->dcrc_hlink);
+	d_list_del(&dcrc->dcrc_gl_committable);
+	d_list_del(&dcrc->dcrc_lo_link);
 
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_reg_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
-		dec++;
-	}
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_prio_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
-		dec++;
-	}
-	d_list_for_each_entry_safe(dcrc, next, &dcr->dcr_expcmt_list,
-				   dcrc_lo_link) {
-		d_list_del(&dcrc->dcrc_lo_link);
-		d_list_del(&dcrc->dcrc_gl_committable);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
-		dec++;
-	}
-	D_FREE_PTR(dcr);
+	if (dcrc->dcrc_flags & DCF_EXP_CMT)
+		dcr->dcr_expcmt_count--;
+	else if (dcrc->dcrc_flags & DCF_SHARED)
+		dcr->dcr_prio_count--;
+	else
+		dcr->dcr_reg_count--;
 
-	cont->sc_dtx_committable_count -= dec;
+	dtx_entry_put(dcrc->dcrc_dte);
+	D_FREE_PTR(dcrc);
 
-	/** adjust per-pool counter */
-	d_tm_dec_gauge(tls->dt_committable, dec);
+	cont->sc_dtx_committable_count--;
+	d_tm_dec_gauge(dtx_tls_get()->dt_committable, 1);
 
-	return 0;
+	if (dtx_cos_rec_depth(dcr) == 0) {
+		d_hash_rec_delete_at(cont->sc_dtx_cos_hash, &dcr->dcr_hlink);
+		D_FREE_PTR(dcr);
+	}
 }
 
-static int
-dtx_cos_rec_fetch(struct btr_instance *tins, struct btr_record *rec,
-		  d_iov_t *key_iov, d_iov_t *val_iov)
+int
+dtx_cos_init(struct ds_cont_child *cont)
 {
-	struct dtx_cos_rec	*dcr;
+	int	rc;
 
-	D_ASSERT(val_iov != NULL);
+	rc = d_hash_table_create(D_HASH_FT_NOLOCK, DTX_COS_HASH_BITS, NULL,
+				 &dtx_cos_hash_ops, &cont->sc_dtx_cos_hash);
+	if (rc != 0)
+		return rc;
+
+	rc = d_hash_table_create(D_HASH_FT_NOLOCK, DTX_COS_HASH_BITS, NULL,
+				 &dtx_cos_xid_hash_ops,
+				 &cont->sc_dtx_cos_xid_hash);
+	if (rc != 0) {
+		d_hash_table_destroy(cont->sc_dtx_cos_hash, true);
+		cont->sc_dtx_cos_hash = NULL;
+		return rc;
+	}
 
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	d_iov_set(val_iov, dcr, sizeof(struct dtx_cos_rec));
+	cont->sc_dtx_committable_count = 0;
+	D_INIT_LIST_HEAD(&cont->sc_dtx_cos_list);
 
 	return 0;
 }
 
-static int
-dtx_cos_rec_update(struct btr_instance *tins, struct btr_record *rec,
-		   d_iov_t *key, d_iov_t *val)
+void
+dtx_cos_fini(struct ds_cont_child *cont)
 {
-	struct ds_cont_child		*cont = tins->ti_priv;
-	struct dtx_cos_rec_bundle	*rbund;
-	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
-	struct dtx_tls			*tls = dtx_tls_get();
-
-	D_ASSERT(tins->ti_umm.umm_id == UMEM_CLASS_VMEM);
-
-	dcr = (struct dtx_cos_rec *)umem_off2ptr(&tins->ti_umm, rec->rec_off);
-	rbund = (struct dtx_cos_rec_bundle *)val->iov_buf;
-
-	D_ALLOC_PTR(dcrc);
-	if (dcrc == NULL)
-		return -DER_NOMEM;
-
-	dcrc->dcrc_dte = dtx_entry_get(rbund->dte);
-	dcrc->dcrc_epoch = rbund->epoch;
-	dcrc->dcrc_ptr = dcr;
 
-	d_list_add_tail(&dcrc->dcrc_gl_committable,
-			&cont->sc_dtx_cos_list);
-	cont->sc_dtx_committable_count++;
-	d_tm_inc_gauge(tls->dt_committable, 1);
+	if (cont->sc_dtx_cos_hash == NULL)
+		return;
 
-	if (rbund->flags & DCF_EXP_CMT) {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
-		dcr->dcr_expcmt_count++;
-	} else if (rbund->flags & DCF_SHARED) {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
-		dcr->dcr_prio_count++;
-	} else {
-		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
-		dcr->dcr_reg_count++;
+	while (!d_list_empty(&cont->sc_dtx_cos_list)) {
+		dcrc = d_list_entry(cont->sc_dtx_cos_list.next,
+				    struct dtx_cos_rec_child,
+				    dcrc_gl_committable);
+		dtx_cos_child_del(cont, dcrc);
 	}
 
-	return 0;
+	d_hash_table_destroy(cont->sc_dtx_cos_xid_hash, false);
+	cont->sc_dtx_cos_xid_hash = NULL;
+	d_hash_table_destroy(cont->sc_dtx_cos_hash, false);
+	cont->sc_dtx_cos_hash = NULL;
 }
 
-btr_ops_t dtx_btr_cos_ops = {
-	.to_hkey_size	= dtx_cos_hkey_size,
-	.to_hkey_gen	= dtx_cos_hkey_gen,
-	.to_hkey_cmp	= dtx_cos_hkey_cmp,
-	.to_rec_alloc	= dtx_cos_rec_alloc,
-	.to_rec_free	= dtx_cos_rec_free,
-	.to_rec_fetch	= dtx_cos_rec_fetch,
-	.to_rec_update	= dtx_cos_rec_update,
-};
-
 int
 dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 		      daos_unit_oid_t *oid, daos_epoch_t epoch,
@@ -324,25 +306,21 @@ dtx_list_cos(struct ds_cont_child *cont, daos_unit_oid_t *oid,
 	     uint64_t dkey_hash, int max, struct dtx_id **dtis)
 {
 	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
 	struct dtx_id			*dti = NULL;
 	struct dtx_cos_rec		*dcr = NULL;
 	struct dtx_cos_rec_child	*dcrc;
+	d_list_t			*rlink;
 	int				 count;
-	int				 rc;
 	int				 i = 0;
 
 	key.oid = *oid;
 	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
 
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc != 0)
-		return rc == -DER_NONEXIST ? 0 : rc;
+	rlink = d_hash_rec_find(cont->sc_dtx_cos_hash, &key, sizeof(key));
+	if (rlink == NULL)
+		return 0;
 
-	dcr = (struct dtx_cos_rec *)riov.iov_buf;
+	dcr = dtx_cos_hlink2rec(rlink);
 	if (dcr->dcr_prio_count == 0)
 		return 0;
 
@@ -369,131 +347,219 @@ dtx_list_cos(struct ds_cont_child *cont, daos_unit_oid_t *oid,
 	return count;
 }
 
+static int
+dtx_pb_tgt_idx(struct dtx_memberships *mbs, uint32_t tgt_id)
+{
+	int	i;
+
+	for (i = 0; i < mbs->dm_tgt_cnt && i < DTX_PB_TGT_MAX; i++) {
+		if (mbs->dm_tgts[i].ddt_id == tgt_id)
+			return i;
+	}
+
+	return -1;
+}
+
+/**
+ * Pick up to @max committable DTXs that have not been piggybacked to the
+ * target @tgt_id yet, oldest first. The ones in @skip will be committed
+ * via the dispatched RPC as CoS DTXs anyway.
+ *
+ * \return	The count of DTXs filled into @dtis and @dcks.
+ */
 int
-dtx_add_cos(struct ds_cont_child *cont, struct dtx_entry *dte,
-	    daos_unit_oid_t *oid, uint64_t dkey_hash,
-	    daos_epoch_t epoch, uint32_t flags)
+dtx_cos_piggyback(struct ds_cont_child *cont, uint32_t tgt_id,
+		  struct dtx_id *skip, int skip_cnt, int max,
+		  struct dtx_id *dtis, struct dtx_cos_key *dcks)
 {
-	struct dtx_cos_key		key;
-	struct dtx_cos_rec_bundle	rbund;
-	d_iov_t				kiov;
-	d_iov_t				riov;
-	int				rc;
+	struct dtx_cos_rec_child	*dcrc;
+	struct dtx_entry		*dte;
+	uint64_t			 bit;
+	int				 scanned = 0;
+	int				 count = 0;
+	int				 idx;
+	int				 i;
 
-	if (cont->sc_dtx_cos_shutdown || cont->sc_closing)
-		return -DER_SHUTDOWN;
+	d_list_for_each_entry(dcrc, &cont->sc_dtx_cos_list,
+			      dcrc_gl_committable) {
+		if (count >= max || ++scanned > DTX_PB_SCAN_MAX)
+			break;
 
-	D_ASSERT(dte->dte_mbs != NULL);
-	D_ASSERT(epoch != DAOS_EPOCH_MAX);
+		if (dcrc->dcrc_pb_need == 0)
+			continue;
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
+		dte = dcrc->dcrc_dte;
+		idx = dtx_pb_tgt_idx(dte->dte_mbs, tgt_id);
+		if (idx < 0)
+			continue;
 
-	rbund.dte = dte;
-	rbund.epoch = epoch;
-	rbund.flags = flags;
-	d_iov_set(&riov, &rbund, sizeof(rbund));
+		bit = 1ULL << idx;
+		if (!(dcrc->dcrc_pb_need & bit) || (dcrc->dcrc_pb_sent & bit))
+			continue;
 
-	rc = dbtree_upsert(cont->sc_dtx_cos_hdl, BTR_PROBE_EQ,
-			   DAOS_INTENT_UPDATE, &kiov, &riov);
+		for (i = 0; i < skip_cnt; i++) {
+			if (memcmp(&skip[i], &dte->dte_xid, sizeof(*skip)) == 0)
+				break;
+		}
+		if (i < skip_cnt)
+			continue;
 
-	D_CDEBUG(rc != 0, DLOG_ERR, DB_IO, "Insert DTX "DF_DTI" to CoS "
-		 "cache, "DF_UOID", key %lu, flags %x: rc = "DF_RC"\n",
-		 DP_DTI(&dte->dte_xid), DP_UOID(*oid), (unsigned long)dkey_hash,
-		 flags, DP_RC(rc));
+		dcrc->dcrc_pb_sent |= bit;
+		dtis[count] = dte->dte_xid;
+		dcks[count].oid = dcrc->dcrc_ptr->dcr_oid;
+		dcks[count].dkey_hash = dcrc->dcrc_ptr->dcr_dkey_hash;
+		count++;
+	}
 
-	return rc;
+	return count;
 }
 
+/**
+ * Handle the reply of the dispatched RPC that piggybacked the DTX @xid to
+ * the target @tgt_id.
+ *
+ * \return	1 if all the participants have committed the DTX, then the
+ *		leader can commit it locally. Otherwise zero.
+ */
 int
-dtx_del_cos(struct ds_cont_child *cont, struct dtx_id *xid,
-	    daos_unit_oid_t *oid, uint64_t dkey_hash)
+dtx_cos_piggyback_done(struct ds_cont_child *cont, struct dtx_id *xid,
+		       uint32_t tgt_id, bool committed)
 {
-	struct dtx_tls			*tls = dtx_tls_get();
-	struct dtx_cos_key		 key;
-	d_iov_t				 kiov;
-	d_iov_t				 riov;
-	struct dtx_cos_rec		*dcr;
 	struct dtx_cos_rec_child	*dcrc;
-	int				 found = 0;
-	int				 rc;
+	d_list_t			*rlink;
+	uint64_t			 bit;
+	int				 idx;
 
-	key.oid = *oid;
-	key.dkey_hash = dkey_hash;
-	d_iov_set(&kiov, &key, sizeof(key));
-	d_iov_set(&riov, NULL, 0);
+	/* Has been committed and removed from CoS cache by race. */
+	rlink = d_hash_rec_find(cont->sc_dtx_cos_xid_hash, xid, sizeof(*xid));
+	if (rlink == NULL)
+		return 0;
 
-	rc = dbtree_lookup(cont->sc_dtx_cos_hdl, &kiov, &riov);
-	if (rc != 0)
-		goto out;
+	dcrc = dtx_cos_hlink2child(rlink);
+	if (dcrc->dcrc_flags & DCF_EXP_CMT)
+		return 0;
 
-	dcr = (struct dtx_cos_rec *)riov.iov_buf;
+	idx = dtx_pb_tgt_idx(dcrc->dcrc_dte->dte_mbs, tgt_id);
+	if (idx < 0)
+		return 0;
 
-	d_list_for_each_entry(dcrc, &dcr->dcr_prio_list, dcrc_lo_link) {
-		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) != 0)
-			continue;
+	bit = 1ULL << idx;
+	if (committed) {
+		dcrc->dcrc_pb_acked |= bit;
+	} else {
+		/* Let the subsequent dispatched RPC piggyback it again. */
+		dcrc->dcrc_pb_sent &= ~bit;
+		return 0;
+	}
 
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_lo_link);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
+	return (dcrc->dcrc_pb_acked & dcrc->dcrc_pb_need) ==
+		dcrc->dcrc_pb_need ? 1 : 0;
+}
 
-		cont->sc_dtx_committable_count--;
-		dcr->dcr_prio_count--;
-		d_tm_dec_gauge(tls->dt_committable, 1);
+int
+dtx_add_cos(struct ds_cont_child *cont, struct dtx_entry *dte,
+	    daos_unit_oid_t *oid, uint64_t dkey_hash,
+	    daos_epoch_t epoch, uint32_t flags, uint64_t pb_need)
+{
+	struct dtx_tls			*tls = dtx_tls_get();
+	struct dtx_cos_key		 key;
+	struct dtx_cos_rec		*dcr;
+	struct dtx_cos_rec_child	*dcrc;
+	d_list_t			*rlink;
+	int				 rc = 0;
 
-		D_GOTO(out, found = 1);
-	}
+	if (cont->sc_dtx_cos_shutdown || cont->sc_closing)
+		return -DER_SHUTDOWN;
 
-	d_list_for_each_entry(dcrc, &dcr->dcr_reg_list, dcrc_lo_link) {
-		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) != 0)
-			continue;
+	D_ASSERT(dte->dte_mbs != NULL);
+	D_ASSERT(epoch != DAOS_EPOCH_MAX);
 
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_lo_link);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
+	key.oid = *oid;
+	key.dkey_hash = dkey_hash;
 
-		cont->sc_dtx_committable_count--;
-		dcr->dcr_reg_count--;
-		d_tm_dec_gauge(tls->dt_committable, 1);
+	D_ALLOC_PTR(dcrc);
+	if (dcrc == NULL)
+		D_GOTO(out, rc = -DER_NOMEM);
 
-		D_GOTO(out, found = 2);
+	rlink = d_hash_rec_find(cont->sc_dtx_cos_hash, &key, sizeof(key));
+	if (rlink != NULL) {
+		dcr = dtx_cos_hlink2rec(rlink);
+	} else {
+		D_ALLOC_PTR(dcr);
+		if (dcr == NULL) {
+			D_FREE_PTR(dcrc);
+			D_GOTO(out, rc = -DER_NOMEM);
+		}
+
+		dcr->dcr_oid = key.oid;
+		dcr->dcr_dkey_hash = key.dkey_hash;
+		D_INIT_LIST_HEAD(&dcr->dcr_reg_list);
+		D_INIT_LIST_HEAD(&dcr->dcr_prio_list);
+		D_INIT_LIST_HEAD(&dcr->dcr_expcmt_list);
+		d_hash_rec_insert(cont->sc_dtx_cos_hash, &key, sizeof(key),
+				  &dcr->dcr_hlink, false);
 	}
 
-	d_list_for_each_entry(dcrc, &dcr->dcr_expcmt_list, dcrc_lo_link) {
-		if (memcmp(&dcrc->dcrc_dte->dte_xid, xid, sizeof(*xid)) != 0)
-			continue;
-
-		d_list_del(&dcrc->dcrc_gl_committable);
-		d_list_del(&dcrc->dcrc_lo_link);
-		dtx_entry_put(dcrc->dcrc_dte);
-		D_FREE_PTR(dcrc);
+	dcrc->dcrc_dte = dtx_entry_get(dte);
+	dcrc->dcrc_epoch = epoch;
+	dcrc->dcrc_ptr = dcr;
+	dcrc->dcrc_flags = flags;
+	dcrc->dcrc_pb_need = (flags & DCF_EXP_CMT) ? 0 : pb_need;
 
-		cont->sc_dtx_committable_count--;
-		dcr->dcr_expcmt_count--;
-		d_tm_dec_gauge(tls->dt_committable, 1);
+	d_hash_rec_insert(cont->sc_dtx_cos_xid_hash, &dte->dte_xid,
+			  sizeof(dte->dte_xid), &dcrc->dcrc_hlink, false);
+	d_list_add_tail(&dcrc->dcrc_gl_committable, &cont->sc_dtx_cos_list);
+	cont->sc_dtx_committable_count++;
+	d_tm_inc_gauge(tls->dt_committable, 1);
 
-		D_GOTO(out, found = 3);
+	if (flags & DCF_EXP_CMT) {
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_expcmt_list);
+		dcr->dcr_expcmt_count++;
+	} else if (flags & DCF_SHARED) {
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_prio_list);
+		dcr->dcr_prio_count++;
+	} else {
+		d_list_add_tail(&dcrc->dcrc_lo_link, &dcr->dcr_reg_list);
+		dcr->dcr_reg_count++;
 	}
 
+	d_tm_set_gauge(tls->dt_cos_depth, dtx_cos_rec_depth(dcr));
+
 out:
-	if (found > 0 && dcr->dcr_reg_count == 0 && dcr->dcr_prio_count == 0 &&
-	    dcr->dcr_expcmt_count == 0)
-		rc = dbtree_delete(cont->sc_dtx_cos_hdl, BTR_PROBE_EQ,
-				   &kiov, NULL);
+	D_CDEBUG(rc != 0, DLOG_ERR, DB_IO, "Insert DTX "DF_DTI" to CoS "
+		 "cache, "DF_UOID", key %lu, flags %x: rc = "DF_RC"\n",
+		 DP_DTI(&dte->dte_xid), DP_UOID(*oid), (unsigned long)dkey_hash,
+		 flags, DP_RC(rc));
 
-	if (rc == 0 && found == 0)
-		rc = -DER_NONEXIST;
+	return rc;
+}
 
-	D_CDEBUG(rc != 0 && rc != -DER_NONEXIST, DLOG_ERR, DB_IO,
-		 "Remove DTX "DF_DTI" from CoS "
-		 "cache, "DF_UOID", key %lu, %s shared entry: rc = "DF_RC"\n",
-		 DP_DTI(xid), DP_UOID(*oid), (unsigned long)dkey_hash,
-		 found == 1 ? "has" : "has not", DP_RC(rc));
+int
+dtx_del_cos(struct ds_cont_child *cont, struct dtx_id *xid,
+	    daos_unit_oid_t *oid, uint64_t dkey_hash)
+{
+	struct dtx_cos_rec_child	*dcrc;
+	d_list_t			*rlink;
+	bool				 shared;
+
+	rlink = d_hash_rec_find(cont->sc_dtx_cos_xid_hash, xid, sizeof(*xid));
+	if (rlink == NULL)
+		return 0;
 
-	return rc == -DER_NONEXIST ? 0 : rc;
+	/* Not the DTX that modified the given object and dkey. */
+	dcrc = dtx_cos_hlink2child(rlink);
+	if (dcrc->dcrc_ptr->dcr_dkey_hash != dkey_hash ||
+	    daos_unit_oid_compare(dcrc->dcrc_ptr->dcr_oid, *oid) != 0)
+		return 0;
+
+	shared = dcrc->dcrc_flags & DCF_SHARED;
+	dtx_cos_child_del(cont, dcrc);
+
+	D_DEBUG(DB_IO, "Remove DTX "DF_DTI" from CoS cache, "DF_UOID
+		", key %lu, %s shared entry\n", DP_DTI(xid), DP_UOID(*oid),
+		(unsigned long)dkey_hash, shared ? "has" : "has not");
+
+	return 0;
 }
 
 uint64_t
@@ -22,7 +22,7 @@
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See src/include/daos/rpc.h.
  */
-#define DAOS_DTX_VERSION	2
+#define DAOS_DTX_VERSION	3
 
 /* LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr,
@@ -94,6 +94,28 @@ CRT_RPC_DECLARE(dtx, DAOS_ISEQ_DTX, DAOS_OSEQ_DTX);
  */
 #define DTX_CLEANUP_THD_AGE_LO	45
 
+/* The max count of DTXs to be committed via piggyback on one dispatched
+ * update/punch RPC, besides the CoS DTXs for the modified object/dkey.
+ */
+#define DTX_PB_MAX		32
+
+/* Only scan so many oldest committable DTXs for piggyback candidates. */
+#define DTX_PB_SCAN_MAX		128
+
+/* Commit via piggyback is only for the DTX with not more participants. */
+#define DTX_PB_TGT_MAX		64
+
+/* The slots count of the per-container cache for the DTXs that have been
+ * resolved as committable via DTX refresh. It is direct-mapped, a newer
+ * DTX simply replaces the older one in the same slot.
+ */
+#define DTX_CMT_CACHE_SIZE	256
+
+/* The bits of the per-container CoS hash tables, both the one indexed by
+ * object and dkey and the one indexed by DTX identifier.
+ */
+#define DTX_COS_HASH_BITS	10
+
 struct dtx_pool_metrics {
 	struct d_tm_node_t	*dpm_total[DTX_PROTO_SRV_RPC_COUNT];
 };
@@ -103,6 +125,9 @@ struct dtx_pool_metrics {
  */
 struct dtx_tls {
 	struct d_tm_node_t	*dt_committable;
+	struct d_tm_node_t	*dt_piggyback;
+	struct d_tm_node_t	*dt_cos_depth;
+	struct d_tm_node_t	*dt_cos_age;
 };
 
 extern struct dss_module_key dtx_module_key;
@@ -115,7 +140,6 @@ dtx_tls_get(void)
 
 extern struct crt_proto_format dtx_proto_fmt;
 extern btr_ops_t dbtree_dtx_cf_ops;
-extern btr_ops_t dtx_btr_cos_ops;
 extern uint64_t dtx_agg_gen;
 
 /* dtx_common.c */
@@ -123,14 +147,21 @@ int dtx_handle_reinit(struct dtx_handle *dth);
 void dtx_batched_commit(void *arg);
 
 /* dtx_cos.c */
+int dtx_cos_init(struct ds_cont_child *cont);
+void dtx_cos_fini(struct ds_cont_child *cont);
 int dtx_fetch_committable(struct ds_cont_child *cont, uint32_t max_cnt,
 			  daos_unit_oid_t *oid, daos_epoch_t epoch,
 			  struct dtx_entry ***dtes, struct dtx_cos_key **dcks);
 int dtx_add_cos(struct ds_cont_child *cont, struct dtx_entry *dte,
 		daos_unit_oid_t *oid, uint64_t dkey_hash,
-		daos_epoch_t epoch, uint32_t flags);
+		daos_epoch_t epoch, uint32_t flags, uint64_t pb_need);
 int dtx_del_cos(struct ds_cont_child *cont, struct dtx_id *xid,
 		daos_unit_oid_t *oid, uint64_t dkey_hash);
+int dtx_cos_piggyback(struct ds_cont_child *cont, uint32_t tgt_id,
+		      struct dtx_id *skip, int skip_cnt, int max,
+		      struct dtx_id *dtis, struct dtx_cos_key *dcks);
+int dtx_cos_piggyback_done(struct ds_cont_child *cont, struct dtx_id *xid,
+			   uint32_t tgt_id, bool committed);
 uint64_t dtx_cos_oldest(struct ds_cont_child *cont);
 
 /* dtx_rpc.c */
@@ -101,6 +101,8 @@ struct dtx_cf_rec_bundle {
 	 * the dtx_req_rec::drr_dti array size when allocating it.
 	 */
 	int				 dcrb_count;
+	/* The DTX to be refreshed, used for DTX_REFRESH case. */
+	struct dtx_share_peer		*dcrb_dsp;
 };
 
 /* Make sure that the "dcrb_key" is consisted of "dcrb_rank" + "dcrb_tag". */
@@ -108,6 +110,42 @@ D_CASSERT(sizeof(((struct dtx_cf_rec_bundle *)0)->dcrb_rank) +
 	  sizeof(((struct dtx_cf_rec_bundle *)0)->dcrb_tag) ==
 	  sizeof(((struct dtx_cf_rec_bundle *)0)->dcrb_key));
 
+static inline struct dtx_id *
+dtx_cmt_cache_slot(struct ds_cont_child *cont, struct dtx_id *xid)
+{
+	uint64_t	hash;
+
+	hash = d_hash_murmur64((unsigned char *)xid, sizeof(*xid), 0);
+
+	return &cont->sc_dtx_cmt_cache[hash % DTX_CMT_CACHE_SIZE];
+}
+
+/* Remember the DTX that is known as committable on its leader. */
+static void
+dtx_cmt_cache_insert(struct ds_cont_child *cont, struct dtx_id *xid)
+{
+	if (cont->sc_dtx_cmt_cache == NULL) {
+		D_ALLOC_ARRAY(cont->sc_dtx_cmt_cache, DTX_CMT_CACHE_SIZE);
+		if (cont->sc_dtx_cmt_cache == NULL)
+			return;
+	}
+
+	*dtx_cmt_cache_slot(cont, xid) = *xid;
+}
+
+/*
+ * A committable DTX will never be aborted, so it is safe to resolve the
+ * DTX as committable via the cache without asking its leader again.
+ */
+static bool
+dtx_cmt_cache_lookup(struct ds_cont_child *cont, struct dtx_id *xid)
+{
+	if (cont->sc_dtx_cmt_cache == NULL)
+		return false;
+
+	return daos_dti_equal(dtx_cmt_cache_slot(cont, xid), xid);
+}
+
 static void
 dtx_req_cb(const struct crt_cb_info *cb_info)
 {
@@ -152,6 +190,7 @@ dtx_req_cb(const struct crt_cb_info *cb_info)
 			break;
 		case DTX_ST_COMMITTABLE:
 			/* Committable, will be committed soon. */
+			dtx_cmt_cache_insert(dra->dra_cont, &dsp->dsp_xid);
 			if (dra->dra_cmt_list != NULL)
 				d_list_add_tail(&dsp->dsp_link,
 						dra->dra_cmt_list);
@@ -433,6 +472,17 @@ dtx_cf_rec_alloc(struct btr_instance *tins, d_iov_t *key_iov,
 		return -DER_NOMEM;
 	}
 
+	if (dcrb->dcrb_dsp != NULL) {
+		D_ALLOC_ARRAY(drr->drr_cb_args, dcrb->dcrb_count);
+		if (drr->drr_cb_args == NULL) {
+			D_FREE(drr->drr_dti);
+			D_FREE(drr);
+			return -DER_NOMEM;
+		}
+
+		drr->drr_cb_args[0] = dcrb->dcrb_dsp;
+	}
+
 	drr->drr_rank = dcrb->dcrb_rank;
 	drr->drr_tag = dcrb->dcrb_tag;
 	drr->drr_count = 1;
@@ -479,8 +529,14 @@ dtx_cf_rec_update(struct btr_instance *tins, struct btr_record *rec,
 	dcrb = (struct dtx_cf_rec_bundle *)val->iov_buf;
 	D_ASSERT(drr->drr_count >= 1);
 
-	if (!daos_dti_equal(&drr->drr_dti[drr->drr_count - 1],
-			    dcrb->dcrb_dti)) {
+	/* Each DTX to be refreshed is unique, and needs its own reply. */
+	if (dcrb->dcrb_dsp != NULL) {
+		D_ASSERT(drr->drr_count < dcrb->dcrb_count);
+
+		drr->drr_cb_args[drr->drr_count] = dcrb->dcrb_dsp;
+		drr->drr_dti[drr->drr_count++] = *dcrb->dcrb_dti;
+	} else if (!daos_dti_equal(&drr->drr_dti[drr->drr_count - 1],
+				   dcrb->dcrb_dti)) {
 		D_ASSERT(drr->drr_count < dcrb->dcrb_count);
 
 		drr->drr_dti[drr->drr_count++] = *dcrb->dcrb_dti;
@@ -513,6 +569,7 @@ dtx_dti_classify_one(struct ds_pool *pool, daos_handle_t tree, d_list_t *head,
 
 	dcrb.dcrb_count = count;
 	dcrb.dcrb_dti = &dte->dte_xid;
+	dcrb.dcrb_dsp = NULL;
 	dcrb.dcrb_head = head;
 	dcrb.dcrb_length = length;
 
@@ -870,6 +927,10 @@ dtx_refresh_internal(struct ds_cont_child *cont, int *check_count,
 	struct dtx_share_peer	*tmp;
 	struct dtx_req_rec	*drr;
 	struct dtx_req_args	 dra;
+	struct dtx_cf_rec_bundle dcrb;
+	struct umem_attr	 uma = { 0 };
+	struct btr_root		 tree_root = { 0 };
+	daos_handle_t		 tree_hdl = DAOS_HDL_INVAL;
 	d_list_t		 head;
 	d_list_t		 self;
 	d_rank_t		 myrank;
@@ -880,10 +941,37 @@ dtx_refresh_internal(struct ds_cont_child *cont, int *check_count,
 	D_INIT_LIST_HEAD(&self);
 	crt_group_rank(NULL, &myrank);
 
+	/* Classify the DTXs by their leaders, then send single DTX_REFRESH
+	 * RPC to each leader, and all of them are in flight concurrently.
+	 */
+	uma.uma_id = UMEM_CLASS_VMEM;
+	rc = dbtree_create_inplace(DBTREE_CLASS_DTX_CF, 0, DTX_CF_BTREE_ORDER,
+				   &uma, &tree_root, &tree_hdl);
+	if (rc != 0)
+		return rc;
+
+	dcrb.dcrb_head = &head;
+	dcrb.dcrb_length = &len;
+	dcrb.dcrb_count = *check_count;
+
 	d_list_for_each_entry_safe(dsp, tmp, check_list, dsp_link) {
 		int		leader_tgt = PO_COMP_ID_ALL;
 		int		tgt;
 		bool		drop = false;
+		d_iov_t		kiov;
+		d_iov_t		riov;
+
+		/* Resolved as committable by others on this target. */
+		if (dtx_cmt_cache_lookup(cont, &dsp->dsp_xid)) {
+			d_list_del(&dsp->dsp_link);
+			if (cmt_list != NULL)
+				d_list_add_tail(&dsp->dsp_link, cmt_list);
+			else
+				D_FREE(dsp);
+			if (--(*check_count) == 0)
+				break;
+			continue;
+		}
 
 		if (!(dsp->dsp_mbs.dm_flags & DMF_CONTAIN_LEADER)) {
 
@@ -956,39 +1044,17 @@ again:
 		if (target->ta_comp.co_status != PO_COMP_ST_UPIN)
 			goto again;
 
-		d_list_for_each_entry(drr, &head, drr_link) {
-			if (drr->drr_rank == target->ta_comp.co_rank &&
-			    drr->drr_tag == target->ta_comp.co_index) {
-				drr->drr_dti[drr->drr_count] = dsp->dsp_xid;
-				drr->drr_cb_args[drr->drr_count++] = dsp;
-				goto next;
-			}
-		}
-
-		D_ALLOC_PTR(drr);
-		if (drr == NULL)
-			D_GOTO(out, rc = -DER_NOMEM);
-
-		D_ALLOC_ARRAY(drr->drr_dti, *check_count);
-		if (drr->drr_dti == NULL) {
-			D_FREE(drr);
-			D_GOTO(out, rc = -DER_NOMEM);
-		}
-
-		D_ALLOC_ARRAY(drr->drr_cb_args, *check_count);
-		if (drr->drr_cb_args == NULL) {
-			D_FREE(drr->drr_dti);
-			D_FREE(drr);
-			D_GOTO(out, rc = -DER_NOMEM);
-		}
+		dcrb.dcrb_rank = target->ta_comp.co_rank;
+		dcrb.dcrb_tag = target->ta_comp.co_index;
+		dcrb.dcrb_dti = &dsp->dsp_xid;
+		dcrb.dcrb_dsp = dsp;
 
-		drr->drr_rank = target->ta_comp.co_rank;
-		drr->drr_tag = target->ta_comp.co_index;
-		drr->drr_count = 1;
-		drr->drr_dti[0] = dsp->dsp_xid;
-		drr->drr_cb_args[0] = dsp;
-		d_list_add_tail(&drr->drr_link, &head);
-		len++;
+		d_iov_set(&riov, &dcrb, sizeof(dcrb));
+		d_iov_set(&kiov, &dcrb.dcrb_key, sizeof(dcrb.dcrb_key));
+		rc = dbtree_upsert(tree_hdl, BTR_PROBE_EQ, DAOS_INTENT_UPDATE,
+				   &kiov, &riov);
+		if (rc != 0)
+			goto out;
 
 next:
 		d_list_del_init(&dsp->dsp_link);
@@ -1067,6 +1133,9 @@ next:
 	rc = 0;
 
 out:
+	if (daos_handle_is_valid(tree_hdl))
+		dbtree_destroy(tree_hdl, NULL);
+
 	while ((drr = d_list_pop_entry(&head, struct dtx_req_rec,
 				       drr_link)) != NULL) {
 		D_FREE(drr->drr_cb_args);
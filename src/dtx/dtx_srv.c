@@ -39,6 +39,29 @@ dtx_tls_init(int xs_id, int tgt_id)
 		D_WARN("Failed to create DTX committable metric: " DF_RC"\n",
 		       DP_RC(rc));
 
+	rc = d_tm_add_metric(&tls->dt_piggyback, D_TM_COUNTER,
+			     "total number of DTX entries committed via "
+			     "piggyback on dispatched RPCs", "entries",
+			     "io/dtx/piggyback/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX piggyback metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_cos_depth, D_TM_STATS_GAUGE,
+			     "committable DTX entries under the same object "
+			     "and dkey in CoS cache", "entries",
+			     "io/dtx/cos/depth/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX CoS depth metric: " DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->dt_cos_age, D_TM_STATS_GAUGE,
+			     "age of the oldest committable DTX in CoS cache",
+			     "s", "io/dtx/cos/age/tgt_%u", tgt_id);
+	if (rc != DER_SUCCESS)
+		D_WARN("Failed to create DTX CoS age metric: " DF_RC"\n",
+		       DP_RC(rc));
+
 	return tls;
 }
 
@@ -289,9 +312,6 @@ dtx_init(void)
 	rc = dbtree_class_register(DBTREE_CLASS_DTX_CF,
 				   BTR_FEAT_UINT_KEY | BTR_FEAT_DYNAMIC_ROOT,
 				   &dbtree_dtx_cf_ops);
-	if (rc == 0)
-		rc = dbtree_class_register(DBTREE_CLASS_DTX_COS, 0,
-					   &dtx_btr_cos_ops);
 
 	return rc;
 }
@@ -0,0 +1,358 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+/**
+ * Unit tests and micro benchmark for the DTX CoS (commit on share) cache.
+ *
+ * dtx/tests/dtx_cos_tests.c
+ */
+#define D_LOGFAC	DD_FAC(tests)
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <daos/tests_lib.h>
+#include <daos/common.h>
+#include <daos_srv/daos_engine.h>
+#include <daos_srv/container.h>
+#include <daos_srv/dtx_srv.h>
+#include "../dtx_internal.h"
+
+/* The symbols that the CoS logic needs from the engine and dtx_srv.c */
+pthread_key_t		 dss_tls_key;
+struct dss_module_key	*dss_module_keys[DAOS_MODULE_KEYS_NR];
+struct dss_module_key	 dtx_module_key = {
+	.dmk_tags	= DAOS_SERVER_TAG,
+	.dmk_index	= 0,
+};
+
+static struct dtx_tls			 ut_tls;
+static void				*ut_tls_values[DAOS_MODULE_KEYS_NR];
+static struct dss_thread_local_storage	 ut_dtls = {
+	.dtls_tag	= DAOS_SERVER_TAG,
+	.dtls_values	= ut_tls_values,
+};
+
+#define COS_UT_TGT_CNT		2
+#define COS_BENCH_DTX_CNT	(1 << 17)
+#define COS_BENCH_KEY_CNT	(1 << 10)
+
+static struct dtx_entry *
+cos_ut_dte_alloc(uint64_t hlc)
+{
+	struct dtx_memberships	*mbs;
+	struct dtx_entry	*dte;
+	int			 i;
+
+	D_ALLOC(dte, sizeof(*dte) + sizeof(*mbs) +
+		sizeof(struct dtx_daos_target) * COS_UT_TGT_CNT);
+	assert_non_null(dte);
+
+	mbs = (struct dtx_memberships *)(dte + 1);
+	mbs->dm_tgt_cnt = COS_UT_TGT_CNT;
+	for (i = 0; i < COS_UT_TGT_CNT; i++)
+		mbs->dm_tgts[i].ddt_id = i;
+
+	uuid_generate(dte->dte_xid.dti_uuid);
+	dte->dte_xid.dti_hlc = hlc;
+	dte->dte_mbs = mbs;
+	dte->dte_refs = 1;
+
+	return dte;
+}
+
+static void
+cos_ut_oid_set(daos_unit_oid_t *oid, uint64_t lo)
+{
+	memset(oid, 0, sizeof(*oid));
+	oid->id_pub.lo = lo;
+}
+
+static int
+cos_ut_setup(void **state)
+{
+	struct ds_cont_child	*cont;
+	int			 rc;
+
+	D_ALLOC_PTR(cont);
+	if (cont == NULL)
+		return -1;
+
+	rc = dtx_cos_init(cont);
+	if (rc != 0) {
+		D_FREE(cont);
+		return -1;
+	}
+
+	*state = cont;
+	return 0;
+}
+
+static int
+cos_ut_teardown(void **state)
+{
+	struct ds_cont_child	*cont = *state;
+
+	dtx_cos_fini(cont);
+	assert_null(cont->sc_dtx_cos_hash);
+	assert_int_equal(cont->sc_dtx_committable_count, 0);
+	D_FREE(cont);
+
+	return 0;
+}
+
+static void
+cos_ut_add_del(void **state)
+{
+	struct ds_cont_child	*cont = *state;
+	struct dtx_entry	*dte[3];
+	struct dtx_id		*dtis = NULL;
+	daos_unit_oid_t		 oid;
+	uint32_t		 flags[3] = { 0, DCF_SHARED, DCF_EXP_CMT };
+	int			 rc;
+	int			 i;
+
+	cos_ut_oid_set(&oid, 1);
+	for (i = 0; i < 3; i++) {
+		dte[i] = cos_ut_dte_alloc(i + 1);
+		rc = dtx_add_cos(cont, dte[i], &oid, 100, i + 1, flags[i], 0);
+		assert_rc_equal(rc, 0);
+		assert_int_equal(dte[i]->dte_refs, 2);
+	}
+	assert_int_equal(cont->sc_dtx_committable_count, 3);
+
+	/* Only the shared one needs to be committed before modification. */
+	rc = dtx_list_cos(cont, &oid, 100, DTX_THRESHOLD_COUNT, &dtis);
+	assert_int_equal(rc, 1);
+	assert_memory_equal(&dtis[0], &dte[1]->dte_xid, sizeof(*dtis));
+	D_FREE(dtis);
+
+	rc = dtx_list_cos(cont, &oid, 101, DTX_THRESHOLD_COUNT, &dtis);
+	assert_int_equal(rc, 0);
+
+	rc = dtx_del_cos(cont, &dte[1]->dte_xid, &oid, 100);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(dte[1]->dte_refs, 1);
+	assert_int_equal(cont->sc_dtx_committable_count, 2);
+
+	rc = dtx_list_cos(cont, &oid, 100, DTX_THRESHOLD_COUNT, &dtis);
+	assert_int_equal(rc, 0);
+
+	/* Remove twice is harmless. */
+	rc = dtx_del_cos(cont, &dte[1]->dte_xid, &oid, 100);
+	assert_rc_equal(rc, 0);
+
+	for (i = 0; i < 3; i += 2) {
+		rc = dtx_del_cos(cont, &dte[i]->dte_xid, &oid, 100);
+		assert_rc_equal(rc, 0);
+	}
+	assert_int_equal(cont->sc_dtx_committable_count, 0);
+	assert_true(d_list_empty(&cont->sc_dtx_cos_list));
+	assert_null(d_hash_rec_first(cont->sc_dtx_cos_hash));
+	assert_null(d_hash_rec_first(cont->sc_dtx_cos_xid_hash));
+
+	for (i = 0; i < 3; i++)
+		dtx_entry_put(dte[i]);
+}
+
+static void
+cos_ut_oldest(void **state)
+{
+	struct ds_cont_child	 *cont = *state;
+	struct dtx_entry	 *dte[8];
+	struct dtx_entry	**dtes = NULL;
+	struct dtx_cos_key	 *dcks = NULL;
+	daos_unit_oid_t		  oid;
+	int			  rc;
+	int			  i;
+
+	assert_int_equal(dtx_cos_oldest(cont), 0);
+
+	for (i = 0; i < 8; i++) {
+		cos_ut_oid_set(&oid, i % 3);
+		dte[i] = cos_ut_dte_alloc(i + 10);
+		rc = dtx_add_cos(cont, dte[i], &oid, i, i + 10, 0, 0);
+		assert_rc_equal(rc, 0);
+	}
+	assert_int_equal(dtx_cos_oldest(cont), 10);
+
+	/* Remove from the head, the middle and the tail. */
+	for (i = 0; i < 8; i += 3) {
+		cos_ut_oid_set(&oid, i % 3);
+		rc = dtx_del_cos(cont, &dte[i]->dte_xid, &oid, i);
+		assert_rc_equal(rc, 0);
+	}
+	assert_int_equal(dtx_cos_oldest(cont), 11);
+
+	/* The committable ones are still fetched in time order. */
+	rc = dtx_fetch_committable(cont, DTX_THRESHOLD_COUNT, NULL,
+				   DAOS_EPOCH_MAX, &dtes, &dcks);
+	assert_int_equal(rc, 5);
+	assert_memory_equal(&dtes[0]->dte_xid, &dte[1]->dte_xid,
+			    sizeof(struct dtx_id));
+	assert_memory_equal(&dtes[4]->dte_xid, &dte[7]->dte_xid,
+			    sizeof(struct dtx_id));
+	assert_int_equal(dcks[4].dkey_hash, 7);
+
+	for (i = 0; i < rc; i++)
+		dtx_entry_put(dtes[i]);
+	D_FREE(dtes);
+	D_FREE(dcks);
+
+	/* Leave the others to be released via dtx_cos_fini(). */
+	for (i = 0; i < 8; i++)
+		dtx_entry_put(dte[i]);
+}
+
+static void
+cos_ut_piggyback(void **state)
+{
+	struct ds_cont_child	*cont = *state;
+	struct dtx_entry	*dte;
+	struct dtx_id		 dti;
+	struct dtx_cos_key	 dck;
+	daos_unit_oid_t		 oid;
+	int			 rc;
+
+	cos_ut_oid_set(&oid, 1);
+	dte = cos_ut_dte_alloc(1);
+	rc = dtx_add_cos(cont, dte, &oid, 100, 1, 0, 0x3);
+	assert_rc_equal(rc, 0);
+
+	rc = dtx_cos_piggyback(cont, 1, NULL, 0, DTX_PB_MAX, &dti, &dck);
+	assert_int_equal(rc, 1);
+	assert_memory_equal(&dti, &dte->dte_xid, sizeof(dti));
+
+	/* Has been sent to target 1, not again. */
+	rc = dtx_cos_piggyback(cont, 1, NULL, 0, DTX_PB_MAX, &dti, &dck);
+	assert_int_equal(rc, 0);
+
+	/* Failed on target 1, then it can be piggybacked again. */
+	rc = dtx_cos_piggyback_done(cont, &dte->dte_xid, 1, false);
+	assert_int_equal(rc, 0);
+	rc = dtx_cos_piggyback(cont, 1, NULL, 0, DTX_PB_MAX, &dti, &dck);
+	assert_int_equal(rc, 1);
+
+	rc = dtx_cos_piggyback_done(cont, &dte->dte_xid, 1, true);
+	assert_int_equal(rc, 0);
+	rc = dtx_cos_piggyback_done(cont, &dte->dte_xid, 0, true);
+	assert_int_equal(rc, 1);
+
+	rc = dtx_del_cos(cont, &dte->dte_xid, &oid, 100);
+	assert_rc_equal(rc, 0);
+
+	/* Has been removed from CoS cache. */
+	rc = dtx_cos_piggyback_done(cont, &dte->dte_xid, 0, true);
+	assert_int_equal(rc, 0);
+
+	dtx_entry_put(dte);
+}
+
+static void
+cos_bench(void **state)
+{
+	struct ds_cont_child	*cont = *state;
+	struct dtx_entry	**dtes;
+	uint32_t		 *order;
+	daos_unit_oid_t		  oid;
+	uint64_t		  start;
+	uint64_t		  add_ns;
+	uint64_t		  del_ns;
+	uint32_t		  tmp;
+	int			  rc;
+	int			  i;
+	int			  j;
+
+	D_ALLOC_ARRAY(dtes, COS_BENCH_DTX_CNT);
+	assert_non_null(dtes);
+	D_ALLOC_ARRAY(order, COS_BENCH_DTX_CNT);
+	assert_non_null(order);
+
+	for (i = 0; i < COS_BENCH_DTX_CNT; i++) {
+		dtes[i] = cos_ut_dte_alloc(i + 1);
+		order[i] = i;
+	}
+
+	/* Shuffle, commit reply does not always come in the time order. */
+	for (i = COS_BENCH_DTX_CNT - 1; i > 0; i--) {
+		j = rand() % (i + 1);
+		tmp = order[i];
+		order[i] = order[j];
+		order[j] = tmp;
+	}
+
+	start = daos_get_ntime();
+	for (i = 0; i < COS_BENCH_DTX_CNT; i++) {
+		cos_ut_oid_set(&oid, i % COS_BENCH_KEY_CNT);
+		rc = dtx_add_cos(cont, dtes[i], &oid, 0, i + 1, 0, 0);
+		assert_rc_equal(rc, 0);
+	}
+	add_ns = daos_get_ntime() - start;
+
+	assert_int_equal(dtx_cos_oldest(cont), 1);
+
+	start = daos_get_ntime();
+	for (i = 0; i < COS_BENCH_DTX_CNT; i++) {
+		j = order[i];
+		cos_ut_oid_set(&oid, j % COS_BENCH_KEY_CNT);
+		rc = dtx_del_cos(cont, &dtes[j]->dte_xid, &oid, 0);
+		assert_rc_equal(rc, 0);
+	}
+	del_ns = daos_get_ntime() - start;
+
+	assert_int_equal(cont->sc_dtx_committable_count, 0);
+
+	print_message("CoS bench: %d DTXs on %d keys, add %lu ns/op, "
+		      "delete %lu ns/op\n", COS_BENCH_DTX_CNT,
+		      COS_BENCH_KEY_CNT,
+		      (unsigned long)(add_ns / COS_BENCH_DTX_CNT),
+		      (unsigned long)(del_ns / COS_BENCH_DTX_CNT));
+
+	for (i = 0; i < COS_BENCH_DTX_CNT; i++)
+		dtx_entry_put(dtes[i]);
+	D_FREE(order);
+	D_FREE(dtes);
+}
+
+static const struct CMUnitTest cos_tests[] = {
+	cmocka_unit_test_setup_teardown(cos_ut_add_del, cos_ut_setup,
+					cos_ut_teardown),
+	cmocka_unit_test_setup_teardown(cos_ut_oldest, cos_ut_setup,
+					cos_ut_teardown),
+	cmocka_unit_test_setup_teardown(cos_ut_piggyback, cos_ut_setup,
+					cos_ut_teardown),
+	cmocka_unit_test_setup_teardown(cos_bench, cos_ut_setup,
+					cos_ut_teardown),
+};
+
+int
+main(int argc, char **argv)
+{
+	int	rc;
+
+	d_register_alt_assert(mock_assert);
+
+	rc = daos_debug_init(DAOS_LOG_DEFAULT);
+	if (rc != 0)
+		return rc;
+
+	rc = pthread_key_create(&dss_tls_key, NULL);
+	if (rc != 0)
+		goto out;
+
+	dss_module_keys[dtx_module_key.dmk_index] = &dtx_module_key;
+	ut_tls_values[dtx_module_key.dmk_index] = &ut_tls;
+	pthread_setspecific(dss_tls_key, &ut_dtls);
+
+	rc = cmocka_run_group_tests_name("DTX CoS tests", cos_tests,
+					 NULL, NULL);
+
+	pthread_key_delete(dss_tls_key);
+out:
+	daos_debug_fini();
+	return rc;
+}
@@ -40,7 +40,12 @@ srv_profile_start(char *path, int avg)
 		return rc;
 	}
 
-	return rc;
+	/* Sample CPU consumers along with the profile */
+	rc = sched_cpu_sample_start(dss_current_xstream());
+	if (rc)
+		D_WARN("start CPU sampling failed: rc "DF_RC"\n", DP_RC(rc));
+
+	return 0;
 }
 
 int
@@ -49,6 +54,7 @@ srv_profile_stop(void)
 	struct dss_module_info	*dmi = dss_get_module_info(); 
 	struct daos_profile *dp = dmi->dmi_dp;
 
+	sched_cpu_sample_stop(dss_current_xstream());
 	daos_profile_dump(dp);
 	daos_profile_destroy(dp);
 	dmi->dmi_dp = NULL;
@@ -7,10 +7,13 @@
 #define D_LOGFAC       DD_FAC(server)
 
 #include <execinfo.h>
+#include <dlfcn.h>
 #include <abt.h>
 #include <daos/common.h>
 #include <daos_errno.h>
 #include <daos_srv/vos.h>
+#include <gurt/atomic.h>
+#include <gurt/telemetry_producer.h>
 #include "srv_internal.h"
 
 struct sched_req_info {
@@ -37,12 +40,26 @@ struct sched_pool_info {
 	int			spi_gc_sleeping;
 	int			spi_ref;
 	uint32_t		spi_req_cnt;
+	/* Link to 'sched_info->si_drr_list' when pool has queued IO */
+	d_list_t		spi_drr_link;
+	/* Queued IO requests, used by SCHED_POLICY_ID_RR */
+	d_list_t		spi_io_list;
+	/* DRR deficit, in number of IO requests */
+	int64_t			spi_deficit;
+	/* Weight and latency target (msecs) cached from pool QoS table */
+	uint32_t		spi_weight;
+	uint32_t		spi_lat_ms;
+	uint32_t		spi_qos_gen;
+	/* Queue depth and queuing time, in pool's metrics directory */
+	struct d_tm_node_t	*spi_qd;
+	struct d_tm_node_t	*spi_wait;
 };
 
 struct sched_request {
 	/*
-	 * IO request links to 'sched_info->si_fifo_list', other types of
-	 * request link to each 'sched_req_info->sri_req_list' respectively.
+	 * IO request links to 'sched_info->si_fifo_list' (or to
+	 * 'sched_pool_info->spi_io_list' for SCHED_POLICY_ID_RR), other types
+	 * of request link to each 'sched_req_info->sri_req_list' respectively.
 	 * When request is not used, it's in 'sched_info->si_idle_list'.
 	 */
 	d_list_t		 sr_link;
@@ -58,29 +75,45 @@ struct sched_request {
 	unsigned int		 sr_abort:1;
 };
 
+/* Offloaded ULT waiting in 'sched_info->si_offload_list' */
+struct sched_offload {
+	d_list_t		  so_link;
+	void			(*so_func)(void *);
+	void			 *so_arg;
+};
+
 bool		sched_prio_disabled;
 unsigned int	sched_stats_intvl;
 unsigned int	sched_relax_intvl = SCHED_RELAX_INTVL_DEFAULT;
 unsigned int	sched_relax_mode;
 unsigned int	sched_unit_runtime_max = 32; /* ms */
-
-enum {
-	/* All requests for various pools are processed in FIFO */
-	SCHED_POLICY_FIFO	= 0,
-	/*
-	 * All requests are processed in RR based on certain ID (Client ID,
-	 * Pool ID, Container ID, JobID, UID, etc.)
-	 */
-	SCHED_POLICY_ID_RR,
-	/*
-	 * Request priority is based on certain ID (Client ID, Pool ID,
-	 * Container ID, JobID, UID, etc.)
-	 */
-	SCHED_POLICY_ID_PRIO,
-	SCHED_POLICY_MAX
+unsigned int	sched_policy = SCHED_POLICY_FIFO;
+bool		sched_offload_steal;
+bool		sched_cpu_prof;
+/* ULT function of RPC handlers, see dss_rpc_hdlr() */
+void		(*sched_rpc_func)(void *);
+
+/* IO requests granted to a pool of weight 1 in each DRR round */
+#define SCHED_DRR_QUANTUM	8
+#define SCHED_POOL_WEIGHT_MAX	100
+#define SCHED_POOL_QOS_MAX	64
+
+struct sched_pool_qos {
+	uuid_t		sq_pool_id;
+	uint32_t	sq_weight;
+	/* Queued IO older than this is kicked regardless of deficit */
+	uint32_t	sq_lat_ms;
 };
 
-static int	sched_policy;
+/*
+ * Per-pool QoS table shared by all xstreams, 'sched_qos_gen' is bumped on
+ * each change so that xstreams know when to refresh their cached copies.
+ */
+static struct sched_pool_qos	sched_qos[SCHED_POOL_QOS_MAX];
+static int			sched_qos_nr;
+static ATOMIC uint32_t		sched_qos_gen = 1;
+static pthread_rwlock_t		sched_qos_lock =
+				PTHREAD_RWLOCK_INITIALIZER;
 
 /*
  * Time threshold for giving IO up throttling. If space pressure stays in the
@@ -143,6 +176,108 @@ sched_set_throttle(unsigned int type, unsigned int percent)
 	return 0;
 }
 
+int
+sched_pool_qos_set(uuid_t pool_id, unsigned int weight, unsigned int lat_ms)
+{
+	int	i, rc = 0;
+
+	if (weight == 0 || weight > SCHED_POOL_WEIGHT_MAX) {
+		D_ERROR("Invalid pool weight: %u\n", weight);
+		return -DER_INVAL;
+	}
+
+	D_RWLOCK_WRLOCK(&sched_qos_lock);
+	for (i = 0; i < sched_qos_nr; i++) {
+		if (uuid_compare(sched_qos[i].sq_pool_id, pool_id) == 0)
+			break;
+	}
+
+	if (i == SCHED_POOL_QOS_MAX) {
+		D_ERROR("Too many pools with QoS settings, max:%d\n",
+			SCHED_POOL_QOS_MAX);
+		rc = -DER_OVERFLOW;
+		goto out;
+	} else if (i == sched_qos_nr) {
+		uuid_copy(sched_qos[i].sq_pool_id, pool_id);
+		sched_qos_nr++;
+	}
+
+	sched_qos[i].sq_weight = weight;
+	sched_qos[i].sq_lat_ms = lat_ms;
+	atomic_fetch_add(&sched_qos_gen, 1);
+
+	D_INFO("Pool "DF_UUID" QoS: weight %u, latency target %u msecs\n",
+	       DP_UUID(pool_id), weight, lat_ms);
+out:
+	D_RWLOCK_UNLOCK(&sched_qos_lock);
+	return rc;
+}
+
+/* Parse "<pool_uuid>:<weight>[:<lat_ms>],..." */
+int
+sched_pool_qos_parse(char *str)
+{
+	char		*dup, *tok, *sep, *saveptr = NULL;
+	uuid_t		 pool_id;
+	unsigned int	 weight, lat_ms;
+	int		 rc = 0;
+
+	D_STRNDUP(dup, str, strlen(str));
+	if (dup == NULL)
+		return -DER_NOMEM;
+
+	for (tok = strtok_r(dup, ",", &saveptr); tok != NULL;
+	     tok = strtok_r(NULL, ",", &saveptr)) {
+		sep = strchr(tok, ':');
+		if (sep == NULL)
+			goto invalid;
+		*sep = '\0';
+
+		if (uuid_parse(tok, pool_id) != 0)
+			goto invalid;
+
+		lat_ms = 0;
+		if (sscanf(sep + 1, "%u:%u", &weight, &lat_ms) < 1)
+			goto invalid;
+
+		rc = sched_pool_qos_set(pool_id, weight, lat_ms);
+		if (rc)
+			break;
+	}
+
+	D_FREE(dup);
+	return rc;
+invalid:
+	D_ERROR("Invalid pool QoS setting: %s\n", tok);
+	D_FREE(dup);
+	return -DER_INVAL;
+}
+
+/* Refresh the cached QoS settings when the QoS table is changed */
+static void
+spi_qos_refresh(struct sched_pool_info *spi)
+{
+	int	i;
+
+	if (spi->spi_qos_gen == atomic_load_relaxed(&sched_qos_gen))
+		return;
+
+	spi->spi_weight = 1;
+	spi->spi_lat_ms = 0;
+
+	D_RWLOCK_RDLOCK(&sched_qos_lock);
+	for (i = 0; i < sched_qos_nr; i++) {
+		if (uuid_compare(sched_qos[i].sq_pool_id,
+				 spi->spi_pool_id) == 0) {
+			spi->spi_weight = sched_qos[i].sq_weight;
+			spi->spi_lat_ms = sched_qos[i].sq_lat_ms;
+			break;
+		}
+	}
+	spi->spi_qos_gen = atomic_load_relaxed(&sched_qos_gen);
+	D_RWLOCK_UNLOCK(&sched_qos_lock);
+}
+
 struct pressure_ratio {
 	unsigned int	pr_free;	/* free space ratio */
 	unsigned int	pr_throttle;	/* update throttle ratio */
@@ -274,6 +409,8 @@ spi_rec_free(struct d_hash_table *htable, d_list_t *rlink)
 			  type, pool2req_cnt(spi, type));
 		D_ASSERT(d_list_empty(pool2req_list(spi, type)));
 	}
+	D_ASSERT(d_list_empty(&spi->spi_io_list));
+	D_ASSERT(d_list_empty(&spi->spi_drr_link));
 
 	D_FREE(spi);
 }
@@ -379,10 +516,12 @@ sched_info_fini(struct dss_xstream *dx)
 {
 	struct sched_info	*info = &dx->dx_sched_info;
 	struct sched_request	*req, *tmp;
+	struct sched_offload	*so, *so_tmp;
 
 	D_ASSERT(info->si_req_cnt == 0);
 	D_ASSERT(d_list_empty(&info->si_sleep_list));
 	D_ASSERT(d_list_empty(&info->si_fifo_list));
+	D_ASSERT(d_list_empty(&info->si_drr_list));
 
 	prune_purge_list(dx);
 
@@ -396,6 +535,16 @@ sched_info_fini(struct dss_xstream *dx)
 		d_list_del_init(&req->sr_link);
 		D_FREE(req);
 	}
+
+	d_list_for_each_entry_safe(so, so_tmp, &info->si_offload_list,
+				   so_link) {
+		D_ERROR("XS(%d): Offloaded ULT %p isn't executed.\n",
+			dx->dx_xs_id, so->so_func);
+		d_list_del_init(&so->so_link);
+		D_FREE(so);
+	}
+	D_SPIN_DESTROY(&info->si_offload_lock);
+	D_FREE(info->si_prof);
 }
 
 static int
@@ -417,6 +566,49 @@ prealloc_requests(struct sched_info *info, int cnt)
 	return 0;
 }
 
+static void
+sched_metrics_init(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	int			 rc;
+
+	rc = d_tm_add_metric(&info->si_tm_poll, D_TM_COUNTER,
+			     "CPU time on network and NVMe polling", "ms",
+			     "sched/cpu/poll/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create poll time metric: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&info->si_tm_relax, D_TM_COUNTER,
+			     "CPU time relaxed on idle", "ms",
+			     "sched/cpu/relax/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create relax time metric: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&info->si_tm_work, D_TM_COUNTER,
+			     "CPU time on executing ULTs", "ms",
+			     "sched/cpu/work/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create work time metric: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&info->si_tm_offload_local, D_TM_COUNTER,
+			     "offloaded ULTs executed by the target xstream",
+			     "ults", "sched/offload/local/xs_%u", dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create offload metric: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&info->si_tm_offload_stolen, D_TM_COUNTER,
+			     "offloaded ULTs stolen from sibling xstreams",
+			     "ults", "sched/offload/stolen/xs_%u",
+			     dx->dx_xs_id);
+	if (rc)
+		D_WARN("Failed to create offload metric: "DF_RC"\n",
+		       DP_RC(rc));
+}
+
 #define SCHED_PREALLOC_INIT_CNT		8192
 #define SCHED_PREALLOC_BATCH_CNT	1024
 
@@ -433,14 +625,36 @@ sched_info_init(struct dss_xstream *dx)
 	info->si_stats.ss_print_ts = 0;
 	info->si_stats.ss_watchdog_ts = 0;
 	info->si_stats.ss_last_unit = NULL;
+	info->si_stats.ss_net_poll_time = 0;
+	info->si_stats.ss_nvme_poll_time = 0;
+	info->si_stats.ss_tm_ts = info->si_cur_ts;
 	D_INIT_LIST_HEAD(&info->si_idle_list);
 	D_INIT_LIST_HEAD(&info->si_sleep_list);
 	D_INIT_LIST_HEAD(&info->si_fifo_list);
+	D_INIT_LIST_HEAD(&info->si_drr_list);
 	D_INIT_LIST_HEAD(&info->si_purge_list);
 	info->si_req_cnt = 0;
 	info->si_sleep_cnt = 0;
 	info->si_wait_cnt = 0;
 	info->si_stop = 0;
+	D_INIT_LIST_HEAD(&info->si_offload_list);
+	info->si_offload_cnt = 0;
+	info->si_steal_next = dx->dx_xs_id + 1;
+
+	rc = D_SPIN_INIT(&info->si_offload_lock, PTHREAD_PROCESS_PRIVATE);
+	if (rc)
+		return rc;
+
+	info->si_prof = NULL;
+	if (sched_cpu_prof) {
+		D_ALLOC_PTR(info->si_prof);
+		if (info->si_prof == NULL) {
+			D_SPIN_DESTROY(&info->si_offload_lock);
+			return -DER_NOMEM;
+		}
+	}
+
+	sched_metrics_init(dx);
 
 	rc = d_hash_table_create(D_HASH_FT_NOLOCK, 4,
 				 NULL, &sched_pool_hash_ops,
@@ -482,7 +696,11 @@ cur_pool_info(struct sched_info *info, uuid_t pool_uuid)
 		return NULL;
 	}
 	D_INIT_LIST_HEAD(&spi->spi_hash_link);
+	D_INIT_LIST_HEAD(&spi->spi_drr_link);
+	D_INIT_LIST_HEAD(&spi->spi_io_list);
 	uuid_copy(spi->spi_pool_id, pool_uuid);
+	spi->spi_weight = 1;
+	spi->spi_qos_gen = 0;
 
 	for (type = SCHED_REQ_UPDATE; type < SCHED_REQ_MAX; type++) {
 		list = pool2req_list(spi, type);
@@ -588,6 +806,10 @@ req_kickoff(struct dss_xstream *dx, struct sched_request *req)
 	D_ASSERT(info->si_req_cnt > 0);
 	info->si_req_cnt--;
 
+	d_tm_set_gauge(spi->spi_qd, spi->spi_req_cnt);
+	D_ASSERT(info->si_cur_ts >= req->sr_enqueue_ts);
+	d_tm_set_gauge(spi->spi_wait, info->si_cur_ts - req->sr_enqueue_ts);
+
 	d_list_del_init(&req->sr_link);
 	req_put(dx, req);
 
@@ -872,6 +1094,77 @@ policy_fifo_process(struct dss_xstream *dx)
 	process_req_list(dx, &info->si_fifo_list);
 }
 
+static void
+policy_drr_enqueue(struct dss_xstream *dx, struct sched_request *req,
+		   void *prio_data)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_pool_info	*spi = req->sr_pool_info;
+
+	d_list_add_tail(&req->sr_link, &spi->spi_io_list);
+	/* Activate the pool */
+	if (d_list_empty(&spi->spi_drr_link))
+		d_list_add_tail(&spi->spi_drr_link, &info->si_drr_list);
+}
+
+static inline bool
+is_req_overdue(struct sched_info *info, struct sched_pool_info *spi,
+	       struct sched_request *req)
+{
+	if (spi->spi_lat_ms == 0)
+		return false;
+
+	D_ASSERT(info->si_cur_ts >= req->sr_enqueue_ts);
+	return (info->si_cur_ts - req->sr_enqueue_ts) >= spi->spi_lat_ms;
+}
+
+/*
+ * Deficit round robin over the active pools, each pool earns a quantum in
+ * proportion to its weight per round, and each kicked IO request costs one.
+ * Requests waiting longer than the pool's latency target are kicked ahead
+ * of the deficit, the debt is paid back in following rounds.
+ */
+static void
+policy_drr_process(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_pool_info	*spi, *tmp;
+	struct sched_request	*req;
+	int64_t			 quantum;
+
+	d_list_for_each_entry_safe(spi, tmp, &info->si_drr_list,
+				   spi_drr_link) {
+		spi_qos_refresh(spi);
+		quantum = (int64_t)spi->spi_weight * SCHED_DRR_QUANTUM;
+		spi->spi_deficit += quantum;
+
+		while (!d_list_empty(&spi->spi_io_list)) {
+			req = d_list_entry(spi->spi_io_list.next,
+					   struct sched_request, sr_link);
+			if (spi->spi_deficit <= 0 && !info->si_stop &&
+			    !is_req_overdue(info, spi, req))
+				break;
+			/* Throttled by space pressure */
+			if (process_req(dx, req))
+				break;
+			spi->spi_deficit--;
+		}
+
+		/* Idle pool doesn't accumulate credit */
+		if (d_list_empty(&spi->spi_io_list)) {
+			d_list_del_init(&spi->spi_drr_link);
+			spi->spi_deficit = 0;
+			continue;
+		}
+		spi->spi_deficit = min(spi->spi_deficit, quantum);
+		spi->spi_deficit = max(spi->spi_deficit, -quantum);
+	}
+
+	/* Rotate the pool served first in next round */
+	if (!d_list_empty(&info->si_drr_list))
+		d_list_move_tail(info->si_drr_list.next, &info->si_drr_list);
+}
+
 struct sched_policy_ops {
 	void (*enqueue_io)(struct dss_xstream *dx, struct sched_request *req,
 			   void *prio_data);
@@ -884,8 +1177,8 @@ static struct sched_policy_ops	policy_ops[SCHED_POLICY_MAX] = {
 		.process_io = policy_fifo_process,
 	},
 	{	/* SCHED_POLICY_ID_RR */
-		.enqueue_io = NULL,
-		.process_io = NULL,
+		.enqueue_io = policy_drr_enqueue,
+		.process_io = policy_drr_process,
 	},
 	{	/* SCHED_POLICY_ID_PRIO */
 		.enqueue_io = NULL,
@@ -901,6 +1194,7 @@ process_all(struct dss_xstream *dx)
 
 	if (info->si_req_cnt == 0) {
 		D_ASSERT(d_list_empty(&info->si_fifo_list));
+		D_ASSERT(d_list_empty(&info->si_drr_list));
 		return;
 	}
 
@@ -954,6 +1248,8 @@ req_enqueue(struct dss_xstream *dx, struct sched_request *req)
 	sri->sri_req_cnt++;
 	spi->spi_req_cnt++;
 	info->si_req_cnt++;
+
+	d_tm_set_gauge(spi->spi_qd, spi->spi_req_cnt);
 }
 
 int
@@ -1178,6 +1474,189 @@ sched_req_put(struct sched_request *req)
 	}
 }
 
+void
+sched_pool_metrics_init(uuid_t pool_id, const char *path, int tgt_id)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct sched_pool_info	*spi;
+	int			 rc;
+
+	/* Requests are queued on VOS xstream only */
+	if (!dx->dx_main_xs)
+		return;
+
+	spi = cur_pool_info(&dx->dx_sched_info, pool_id);
+	if (spi == NULL)
+		return;
+
+	rc = d_tm_add_metric(&spi->spi_qd, D_TM_GAUGE,
+			     "requests queued in scheduler", "reqs",
+			     "%s/sched/qd/tgt_%u", path, tgt_id);
+	if (rc)
+		D_WARN("Failed to create sched QD metric: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&spi->spi_wait, D_TM_STATS_GAUGE,
+			     "request queuing time in scheduler", "ms",
+			     "%s/sched/wait/tgt_%u", path, tgt_id);
+	if (rc)
+		D_WARN("Failed to create sched wait metric: "DF_RC"\n",
+		       DP_RC(rc));
+}
+
+void
+sched_pool_metrics_fini(uuid_t pool_id)
+{
+	struct dss_xstream	*dx = dss_current_xstream();
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_pool_info	*spi;
+	d_list_t		*rlink;
+
+	if (!dx->dx_main_xs)
+		return;
+
+	rlink = d_hash_rec_find(info->si_pool_hash, pool_id, sizeof(uuid_t));
+	if (rlink == NULL)
+		return;
+
+	/* Metrics will be deleted along with the pool's metrics directory */
+	spi = sched_rlink2spi(rlink);
+	spi->spi_qd = NULL;
+	spi->spi_wait = NULL;
+	d_hash_rec_decref(info->si_pool_hash, rlink);
+}
+
+/*
+ * Queue an offloaded ULT on the default offload xstream, instead of creating
+ * the ULT there directly. The ULT is created by the owner xstream at its next
+ * schedule cycle, or by an idle sibling xstream on same NUMA node which steals
+ * it before that.
+ */
+int
+sched_offload_push(struct dss_xstream *dx, void (*func)(void *), void *arg)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_offload	*so;
+
+	if (info->si_stop)
+		return -DER_SHUTDOWN;
+
+	D_ALLOC_PTR(so);
+	if (so == NULL)
+		return -DER_NOMEM;
+
+	so->so_func = func;
+	so->so_arg = arg;
+
+	D_SPIN_LOCK(&info->si_offload_lock);
+	d_list_add_tail(&so->so_link, &info->si_offload_list);
+	info->si_offload_cnt++;
+	D_SPIN_UNLOCK(&info->si_offload_lock);
+
+	/* Atomic integer assignment from different xstream */
+	info->si_stats.ss_busy_ts = info->si_cur_ts;
+	return 0;
+}
+
+/* Owner pops the oldest item, thief steals the newest one */
+static struct sched_offload *
+offload_pop(struct sched_info *info, bool steal)
+{
+	struct sched_offload	*so = NULL;
+
+	/* Racy check to avoid locking the empty list */
+	if (info->si_offload_cnt == 0)
+		return NULL;
+
+	D_SPIN_LOCK(&info->si_offload_lock);
+	if (!d_list_empty(&info->si_offload_list)) {
+		if (steal)
+			so = d_list_entry(info->si_offload_list.prev,
+					  struct sched_offload, so_link);
+		else
+			so = d_list_entry(info->si_offload_list.next,
+					  struct sched_offload, so_link);
+		d_list_del_init(&so->so_link);
+		info->si_offload_cnt--;
+	}
+	D_SPIN_UNLOCK(&info->si_offload_lock);
+
+	return so;
+}
+
+static int
+offload_run(struct dss_xstream *dx, struct sched_offload *so)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	int			 rc;
+
+	rc = ABT_thread_create(dx->dx_pools[DSS_POOL_GENERIC], so->so_func,
+			       so->so_arg, ABT_THREAD_ATTR_NULL, NULL);
+	if (rc != ABT_SUCCESS) {
+		D_ERROR("XS(%d): create offloaded ULT failed: %d\n",
+			dx->dx_xs_id, rc);
+		/* Put it back to own list, retry in next cycle */
+		D_SPIN_LOCK(&info->si_offload_lock);
+		d_list_add(&so->so_link, &info->si_offload_list);
+		info->si_offload_cnt++;
+		D_SPIN_UNLOCK(&info->si_offload_lock);
+		return dss_abterr2der(rc);
+	}
+
+	D_FREE(so);
+	return 0;
+}
+
+static void
+offload_drain(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_offload	*so;
+	uint32_t		 cnt = info->si_offload_cnt;
+
+	/* Items pushed back on failure are retried in next cycle */
+	while (cnt-- > 0) {
+		so = offload_pop(info, false);
+		if (so == NULL || offload_run(dx, so) != 0)
+			break;
+		d_tm_inc_counter(info->si_tm_offload_local, 1);
+	}
+}
+
+static void
+offload_steal(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct dss_xstream	*victim;
+	struct sched_offload	*so;
+	int			 i, xs_id, xs_nr = dss_xstream_cnt();
+
+	for (i = 0; i < xs_nr; i++) {
+		xs_id = (info->si_steal_next + i) % xs_nr;
+		/* System xstreams don't take offloaded work */
+		if (xs_id < dss_sys_xs_nr || xs_id == dx->dx_xs_id)
+			continue;
+
+		victim = dss_get_xstream(xs_id);
+		if (victim == NULL || victim->dx_sched_info.si_stop ||
+		    victim->dx_numa_id != dx->dx_numa_id)
+			continue;
+
+		so = offload_pop(&victim->dx_sched_info, true);
+		if (so == NULL)
+			continue;
+
+		/* Start from the next victim in next steal */
+		info->si_steal_next = xs_id + 1;
+		if (offload_run(dx, so) == 0) {
+			d_tm_inc_counter(info->si_tm_offload_stolen, 1);
+			D_DEBUG(DB_TRACE, "XS(%d) stole ULT from XS(%d)\n",
+				dx->dx_xs_id, xs_id);
+		}
+		return;
+	}
+}
+
 void
 sched_stop(struct dss_xstream *dx)
 {
@@ -1186,6 +1665,7 @@ sched_stop(struct dss_xstream *dx)
 	info->si_stop = 1;
 	wakeup_all(dx);
 	process_all(dx);
+	offload_drain(dx);
 }
 
 void
@@ -1215,6 +1695,9 @@ struct sched_cycle {
 	uint32_t	sc_ults_tot;
 	uint32_t	sc_age_net;
 	uint32_t	sc_age_nvme;
+	/* Extra poll thresholds, adjusted on observed load */
+	uint32_t	sc_age_net_max;
+	uint32_t	sc_age_nvme_max;
 	unsigned int	sc_new_cycle:1,
 			sc_cycle_started:1;
 };
@@ -1223,6 +1706,8 @@ struct sched_data {
 	struct sched_cycle	 sd_cycle;
 	struct dss_xstream	*sd_dx;
 	uint32_t		 sd_event_freq;
+	/* Current CPU relax interval, in msecs */
+	uint32_t		 sd_relax_intvl;
 };
 
 /* #define SCHED_DEBUG */
@@ -1233,16 +1718,26 @@ sched_dump_data(struct sched_data *data)
 	struct dss_xstream	*dx = data->sd_dx;
 	struct sched_cycle	*cycle = &data->sd_cycle;
 
-	D_PRINT("XS(%d): comm:%d main:%d. age_net:%u, age_nvme:%u, "
+	D_PRINT("XS(%d): comm:%d main:%d. age_net:%u/%u, age_nvme:%u/%u, "
 		"new_cycle:%d cycle_started:%d total_ults:%u\n",
 		dx->dx_xs_id, dx->dx_comm, dx->dx_main_xs, cycle->sc_age_net,
-		cycle->sc_age_nvme, cycle->sc_new_cycle,
+		cycle->sc_age_net_max, cycle->sc_age_nvme,
+		cycle->sc_age_nvme_max, cycle->sc_new_cycle,
 		cycle->sc_cycle_started, cycle->sc_ults_tot);
 #endif
 }
 
-#define SCHED_AGE_NET_MAX		32
-#define SCHED_AGE_NVME_MAX		64
+/*
+ * Extra network/NVMe poll is scheduled after executing certain number of
+ * ULTs, the number is adjusted within these bounds according to if the
+ * recent polls found any work.
+ */
+#define SCHED_AGE_NET_MIN		8
+#define SCHED_AGE_NET_DEFAULT		32
+#define SCHED_AGE_NET_MAX		256
+#define SCHED_AGE_NVME_MIN		16
+#define SCHED_AGE_NVME_DEFAULT		64
+#define SCHED_AGE_NVME_MAX		512
 
 static int
 sched_init(ABT_sched sched, ABT_sched_config config)
@@ -1262,6 +1757,10 @@ sched_init(ABT_sched sched, ABT_sched_config config)
 		return ret;
 	}
 
+	data->sd_cycle.sc_age_net_max = SCHED_AGE_NET_DEFAULT;
+	data->sd_cycle.sc_age_nvme_max = SCHED_AGE_NVME_DEFAULT;
+	data->sd_relax_intvl = sched_relax_intvl;
+
 	ret = ABT_sched_set_data(sched, (void *)data);
 	return ret;
 }
@@ -1283,7 +1782,7 @@ need_net_poll(struct sched_cycle *cycle)
 	 * Need extra net poll when too many ULTs are processed in
 	 * current cycle.
 	 */
-	if (cycle->sc_age_net > SCHED_AGE_NET_MAX)
+	if (cycle->sc_age_net > cycle->sc_age_net_max)
 		return true;
 
 	return false;
@@ -1342,7 +1841,7 @@ need_nvme_poll(struct dss_xstream *dx, struct sched_cycle *cycle)
 	 * Need extra NVMe poll when too many ULTs are processed in
 	 * current cycle.
 	 */
-	if (cycle->sc_age_nvme > SCHED_AGE_NVME_MAX)
+	if (cycle->sc_age_nvme > cycle->sc_age_nvme_max)
 		return true;
 
 	/* TLS is destroyed on dss_srv_handler ULT exiting */
@@ -1425,6 +1924,86 @@ sched_pop_one(struct sched_data *data, ABT_pool pool, int pool_idx)
 	return unit;
 }
 
+struct sched_poll {
+	int		sp_pool_idx;
+	/* When the poll ULT is started, in nsecs */
+	uint64_t	sp_start;
+	/* ULTs and requests queued before the network poll */
+	size_t		sp_ults;
+	uint32_t	sp_reqs;
+};
+
+/* Poll more often when last poll found work, otherwise back off slowly */
+static inline uint32_t
+poll_age_adjust(uint32_t age_max, bool busy, uint32_t lo, uint32_t hi)
+{
+	if (busy)
+		return max(age_max / 2, lo);
+
+	return min(age_max + age_max / 8, hi);
+}
+
+static void
+sched_poll_prep(struct sched_data *data, ABT_pool *pools, int pool_idx,
+		struct sched_poll *sp)
+{
+	struct sched_info	*info = &data->sd_dx->dx_sched_info;
+	int			 ret;
+
+	sp->sp_pool_idx = pool_idx;
+	if (pool_idx == DSS_POOL_GENERIC)
+		return;
+
+	sp->sp_start = daos_get_ntime();
+	if (pool_idx != DSS_POOL_NET_POLL)
+		return;
+
+	sp->sp_reqs = info->si_req_cnt;
+	ret = ABT_pool_get_size(pools[DSS_POOL_GENERIC], &sp->sp_ults);
+	if (ret != ABT_SUCCESS)
+		sp->sp_ults = 0;
+}
+
+static void
+sched_poll_post(struct sched_data *data, ABT_pool *pools,
+		struct sched_poll *sp)
+{
+	struct dss_xstream	*dx = data->sd_dx;
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_cycle	*cycle = &data->sd_cycle;
+	uint64_t		 elapsed;
+	size_t			 ults;
+	bool			 busy;
+	int			 ret;
+
+	if (sp->sp_pool_idx == DSS_POOL_GENERIC)
+		return;
+
+	elapsed = daos_get_ntime() - sp->sp_start;
+	if (sp->sp_pool_idx == DSS_POOL_NVME_POLL) {
+		info->si_stats.ss_nvme_poll_time += elapsed;
+		cycle->sc_age_nvme_max = poll_age_adjust(cycle->sc_age_nvme_max,
+							 info->si_nvme_busy,
+							 SCHED_AGE_NVME_MIN,
+							 SCHED_AGE_NVME_MAX);
+		return;
+	}
+
+	/* Waiting on network events is accounted as relax time */
+	if (dx->dx_timeout == 0)
+		info->si_stats.ss_net_poll_time += elapsed;
+
+	/* Incoming RPCs are either queued as requests or started as ULTs */
+	ret = ABT_pool_get_size(pools[DSS_POOL_GENERIC], &ults);
+	if (ret != ABT_SUCCESS)
+		ults = 0;
+	busy = ults > sp->sp_ults || info->si_req_cnt > sp->sp_reqs;
+
+	cycle->sc_age_net_max = poll_age_adjust(cycle->sc_age_net_max, busy,
+						SCHED_AGE_NET_MIN,
+						SCHED_AGE_NET_MAX);
+}
+
 #define SCHED_IDLE_THRESH	8000UL	/* msecs */
 
 /*
@@ -1436,12 +2015,21 @@ sched_pop_one(struct sched_data *data, ABT_pool pool, int pool_idx)
  * There are also some periodical internal events from BIO, like hotplug
  * poller, health/io stats collecting, blobstore state transition, etc. It's
  * not easy to accurately predict the next occurrence of those events.
+ *
+ * When waiting on network, the relax interval is doubled on each idle cycle
+ * (up to SCHED_RELAX_SCALE_MAX times of the configured interval), since an
+ * incoming request wakes up the xstream anyway. It's restored to configured
+ * interval once the xstream gets busy.
  */
+#define SCHED_RELAX_SCALE_MAX	8
+
 static void
-sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
+sched_try_relax(struct sched_data *data, ABT_pool *pools, uint32_t running)
 {
+	struct dss_xstream	*dx = data->sd_dx;
 	struct sched_info	*info = &dx->dx_sched_info;
-	unsigned int		 sleep_time = sched_relax_intvl;
+	unsigned int		 sleep_time = data->sd_relax_intvl;
+	unsigned int		 relax_max;
 	size_t			 blocked;
 	int			 ret;
 
@@ -1458,11 +2046,11 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 	 * in this function.
 	 */
 	if (running != 0)
-		return;
+		goto busy;
 
 	/* There are queued requests to be processed */
 	if (info->si_req_cnt != 0)
-		return;
+		goto busy;
 
 	ret = ABT_pool_get_total_size(pools[DSS_POOL_GENERIC], &blocked);
 	if (ret != ABT_SUCCESS) {
@@ -1486,7 +2074,7 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 	 * ULT or long wait ULT.
 	 */
 	if (blocked > info->si_sleep_cnt + info->si_wait_cnt)
-		return;
+		goto busy;
 
 	/*
 	 * System is currently idle, but we only start relaxing when there is
@@ -1494,7 +2082,7 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 	 */
 	D_ASSERT(info->si_cur_ts >= info->si_stats.ss_busy_ts);
 	if (info->si_cur_ts - info->si_stats.ss_busy_ts < SCHED_IDLE_THRESH)
-		return;
+		goto busy;
 
 	/* Adjust sleep time according to the first sleeping ULT */
 	if (info->si_sleep_cnt > 0) {
@@ -1518,6 +2106,10 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 	if (sched_relax_mode != SCHED_RELAX_MODE_SLEEP && dx->dx_comm) {
 		/* convert to micro-seconds */
 		dx->dx_timeout = sleep_time * 1000;
+
+		relax_max = min(sched_relax_intvl * SCHED_RELAX_SCALE_MAX,
+				SCHED_RELAX_INTVL_MAX);
+		data->sd_relax_intvl = min(data->sd_relax_intvl * 2, relax_max);
 	} else {
 		ret = usleep(sleep_time * 1000);
 		if (ret)
@@ -1527,8 +2119,290 @@ sched_try_relax(struct dss_xstream *dx, ABT_pool *pools, uint32_t running)
 
 	/* Rough stats, interruption isn't taken into account */
 	info->si_stats.ss_relax_time += sleep_time;
+	return;
+busy:
+	data->sd_relax_intvl = sched_relax_intvl;
+}
+
+static void
+sched_metrics_update(struct sched_info *info)
+{
+	struct sched_stats	*stats = &info->si_stats;
+	uint64_t		 poll, busy;
+
+	poll = (stats->ss_net_poll_time + stats->ss_nvme_poll_time) /
+		NSEC_PER_MSEC;
+	busy = stats->ss_tot_time - min(stats->ss_tot_time,
+					stats->ss_relax_time);
+
+	d_tm_set_counter(info->si_tm_poll, poll);
+	d_tm_set_counter(info->si_tm_relax, stats->ss_relax_time);
+	d_tm_set_counter(info->si_tm_work, busy - min(busy, poll));
+	stats->ss_tm_ts = info->si_cur_ts;
+}
+
+/*
+ * Per-ULT type CPU accounting. RPC handler ULTs are accounted by opcode, other
+ * ULTs are accounted by ULT function. The CPU ticks are read on each unit
+ * switch, accumulated in a per-xstream table, and flushed to the per-engine
+ * telemetry counters periodically.
+ */
+#define SCHED_PROF_SLOTS	256	/* Power of 2 */
+#define SCHED_PROF_RPC		(1ULL << 63)
+#define SCHED_PROF_TM_MAX	512
+#define SCHED_PROF_TOP		10
+
+struct sched_prof_ent {
+	/* RPC opcode with SCHED_PROF_RPC set, or ULT function address */
+	uint64_t		 spe_key;
+	uint64_t		 spe_ticks;
+	uint64_t		 spe_runs;
+	/* Ticks already flushed to telemetry */
+	uint64_t		 spe_flushed;
+	/* Ticks when sampling started */
+	uint64_t		 spe_sampled;
+	struct d_tm_node_t	*spe_tm;
+};
+
+struct sched_prof {
+	struct sched_prof_ent	 sp_ents[SCHED_PROF_SLOTS];
+	uint32_t		 sp_ent_nr;
+	/* Ticks when sampling started, 0 if not sampling */
+	uint64_t		 sp_sample_start;
+};
+
+/* Per-engine counters shared by all xstreams */
+struct sched_prof_tm {
+	uint64_t		 spt_key;
+	struct d_tm_node_t	*spt_node;
+};
+
+static struct sched_prof_tm	sched_prof_tms[SCHED_PROF_TM_MAX];
+static int			sched_prof_tm_nr;
+static pthread_mutex_t		sched_prof_tm_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static inline uint64_t
+sched_ticks(void)
+{
+#if defined(__x86_64__)
+	return __builtin_ia32_rdtsc();
+#else
+	return daos_get_ntime();
+#endif
+}
+
+static inline bool
+prof_enabled(struct sched_prof *prof)
+{
+	return prof != NULL && (sched_cpu_prof || prof->sp_sample_start != 0);
+}
+
+static struct sched_prof_ent *
+prof_ent_get(struct sched_prof *prof, uint64_t key)
+{
+	struct sched_prof_ent	*ent;
+	uint32_t		 i, idx;
+
+	idx = d_hash_murmur64((unsigned char *)&key, sizeof(key), 0);
+	for (i = 0; i < SCHED_PROF_SLOTS; i++) {
+		ent = &prof->sp_ents[(idx + i) & (SCHED_PROF_SLOTS - 1)];
+		if (ent->spe_key == key)
+			return ent;
+		if (ent->spe_key != 0)
+			continue;
+		/* Leave some empty slots to bound the probing */
+		if (prof->sp_ent_nr >= SCHED_PROF_SLOTS * 3 / 4)
+			return NULL;
+
+		ent->spe_key = key;
+		prof->sp_ent_nr++;
+		return ent;
+	}
+	return NULL;
+}
+
+/* Telemetry path (relative to "sched/cpu/") or log name of a table entry */
+static void
+prof_key2name(uint64_t key, char *buf, size_t len)
+{
+	struct dss_module	*module;
+	Dl_info			 dli;
+	char			*name, *dot;
+	crt_opcode_t		 opc;
+
+	if (key & SCHED_PROF_RPC) {
+		opc = (crt_opcode_t)key;
+		module = dss_module_get(opc_get_mod_id(opc));
+		snprintf(buf, len, "rpc/%s/opc_%u",
+			 module != NULL ? module->sm_name : "cart",
+			 opc_get(opc));
+		return;
+	}
+
+	/* Name background ULTs by the library (module) they belong to */
+	if (dladdr((void *)(uintptr_t)key, &dli) == 0 ||
+	    dli.dli_fname == NULL) {
+		snprintf(buf, len, "ult/unknown");
+		return;
+	}
+
+	name = strrchr(dli.dli_fname, '/');
+	name = name != NULL ? name + 1 : (char *)dli.dli_fname;
+	if (strncmp(name, "lib", 3) == 0)
+		name += 3;
+	snprintf(buf, len, "ult/%s", name);
+	dot = strchr(buf, '.');
+	if (dot != NULL)
+		*dot = '\0';
+}
+
+static struct d_tm_node_t *
+prof_tm_get(uint64_t key)
+{
+	struct d_tm_node_t	*node = NULL;
+	char			 name[DSS_XS_NAME_LEN * 2];
+	uint64_t		 tm_key;
+	int			 i, rc;
+
+	/* Background ULTs of same module share one counter */
+	prof_key2name(key, name, sizeof(name));
+	tm_key = (key & SCHED_PROF_RPC) ? key :
+		 d_hash_string_u32(name, strlen(name));
+
+	D_MUTEX_LOCK(&sched_prof_tm_lock);
+	for (i = 0; i < sched_prof_tm_nr; i++) {
+		if (sched_prof_tms[i].spt_key == tm_key) {
+			node = sched_prof_tms[i].spt_node;
+			goto out;
+		}
+	}
+
+	if (sched_prof_tm_nr == SCHED_PROF_TM_MAX)
+		goto out;
+
+	rc = d_tm_add_metric(&node, D_TM_COUNTER, "CPU ticks consumed",
+			     "ticks", "sched/cpu/%s", name);
+	if (rc) {
+		D_WARN("Failed to create CPU metric %s: "DF_RC"\n", name,
+		       DP_RC(rc));
+		goto out;
+	}
+	sched_prof_tms[sched_prof_tm_nr].spt_key = tm_key;
+	sched_prof_tms[sched_prof_tm_nr].spt_node = node;
+	sched_prof_tm_nr++;
+out:
+	D_MUTEX_UNLOCK(&sched_prof_tm_lock);
+	return node;
+}
+
+static void
+sched_prof_flush(struct sched_prof *prof)
+{
+	struct sched_prof_ent	*ent;
+	int			 i;
+
+	if (prof == NULL || !sched_cpu_prof)
+		return;
+
+	for (i = 0; i < SCHED_PROF_SLOTS; i++) {
+		ent = &prof->sp_ents[i];
+		if (ent->spe_key == 0 || ent->spe_ticks == ent->spe_flushed)
+			continue;
+
+		if (ent->spe_tm == NULL)
+			ent->spe_tm = prof_tm_get(ent->spe_key);
+		d_tm_inc_counter(ent->spe_tm,
+				 ent->spe_ticks - ent->spe_flushed);
+		ent->spe_flushed = ent->spe_ticks;
+	}
+}
+
+/* Start sampling CPU consumers on current xstream */
+int
+sched_cpu_sample_start(struct dss_xstream *dx)
+{
+	struct sched_info	*info = &dx->dx_sched_info;
+	struct sched_prof	*prof;
+	int			 i;
+
+	if (info->si_prof == NULL) {
+		D_ALLOC_PTR(info->si_prof);
+		if (info->si_prof == NULL)
+			return -DER_NOMEM;
+	}
+
+	prof = info->si_prof;
+	for (i = 0; i < SCHED_PROF_SLOTS; i++)
+		prof->sp_ents[i].spe_sampled = prof->sp_ents[i].spe_ticks;
+	prof->sp_sample_start = sched_ticks();
+
+	return 0;
+}
+
+/* Stop sampling and dump the top CPU consumers to log */
+void
+sched_cpu_sample_stop(struct dss_xstream *dx)
+{
+	struct sched_prof	*prof = dx->dx_sched_info.si_prof;
+	struct sched_prof_ent	*ent, *top[SCHED_PROF_TOP] = { NULL };
+	uint64_t		 total, delta;
+	char			 name[DSS_XS_NAME_LEN * 2];
+	char			**strings;
+	void			*addr;
+	int			 i, j, k;
+
+	if (prof == NULL || prof->sp_sample_start == 0)
+		return;
+
+	total = sched_ticks() - prof->sp_sample_start;
+	prof->sp_sample_start = 0;
+	if (total == 0)
+		return;
+
+	/* Insertion sort into the top list */
+	for (i = 0; i < SCHED_PROF_SLOTS; i++) {
+		ent = &prof->sp_ents[i];
+		delta = ent->spe_ticks - ent->spe_sampled;
+		if (ent->spe_key == 0 || delta == 0)
+			continue;
+
+		for (j = 0; j < SCHED_PROF_TOP; j++) {
+			if (top[j] == NULL ||
+			    delta > top[j]->spe_ticks - top[j]->spe_sampled)
+				break;
+		}
+		if (j == SCHED_PROF_TOP)
+			continue;
+
+		for (k = SCHED_PROF_TOP - 1; k > j; k--)
+			top[k] = top[k - 1];
+		top[j] = ent;
+	}
+
+	D_INFO("XS(%d) top CPU consumers in "DF_U64" ticks:\n", dx->dx_xs_id,
+	       total);
+	for (i = 0; i < SCHED_PROF_TOP && top[i] != NULL; i++) {
+		ent = top[i];
+		delta = ent->spe_ticks - ent->spe_sampled;
+		prof_key2name(ent->spe_key, name, sizeof(name));
+
+		strings = NULL;
+		if (!(ent->spe_key & SCHED_PROF_RPC)) {
+			addr = (void *)(uintptr_t)ent->spe_key;
+			strings = backtrace_symbols(&addr, 1);
+		}
+
+		D_INFO("XS(%d) [%d] %s %s: "DF_U64" ticks (%u.%u%%)\n",
+		       dx->dx_xs_id, i, name,
+		       strings != NULL ? strings[0] : "",
+		       delta, (unsigned int)(delta * 100 / total),
+		       (unsigned int)(delta * 1000 / total % 10));
+		free(strings);
+	}
 }
 
+#define SCHED_TM_INTVL		1000	/* msecs */
+
 static void
 sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 {
@@ -1547,6 +2421,7 @@ sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 
 	wakeup_all(dx);
 	process_all(dx);
+	offload_drain(dx);
 
 	/* Get number of ULTS in generic ABT pool */
 	D_ASSERT(cycle->sc_ults_cnt[DSS_POOL_GENERIC] == 0);
@@ -1556,18 +2431,35 @@ sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 			dx->dx_xs_id, DSS_POOL_GENERIC, ret);
 		cnt = 0;
 	}
+
+	/* Help sibling xstreams on their offloaded work when idle */
+	if (sched_offload_steal && cnt == 0 && info->si_req_cnt == 0 &&
+	    !info->si_stop && dx->dx_xs_id >= dss_sys_xs_nr) {
+		offload_steal(dx);
+		ret = ABT_pool_get_size(pools[DSS_POOL_GENERIC], &cnt);
+		if (ret != ABT_SUCCESS)
+			cnt = 0;
+	}
 	cycle->sc_ults_cnt[DSS_POOL_GENERIC] = cnt;
 	cycle->sc_ults_tot += cycle->sc_ults_cnt[DSS_POOL_GENERIC];
 
 	if (sched_relax_mode != SCHED_RELAX_MODE_DISABLED)
-		sched_try_relax(dx, pools, cycle->sc_ults_tot);
+		sched_try_relax(data, pools, cycle->sc_ults_tot);
+
+	if (info->si_cur_ts - info->si_stats.ss_tm_ts >= SCHED_TM_INTVL) {
+		sched_metrics_update(info);
+		sched_prof_flush(info->si_prof);
+	}
 
 	if (sched_stats_intvl != 0 &&
 	    (info->si_stats.ss_print_ts + sched_stats_intvl) <
 	    info->si_cur_ts) {
-		D_PRINT("XS(%d) CPU time(ms): Total:"DF_U64", Relax:"DF_U64"\n",
-			dx->dx_xs_id, info->si_stats.ss_tot_time,
-			info->si_stats.ss_relax_time);
+		D_PRINT("XS(%d) CPU time(ms): Total:"DF_U64", Relax:"DF_U64", "
+			"Poll net:"DF_U64" nvme:"DF_U64"\n", dx->dx_xs_id,
+			info->si_stats.ss_tot_time,
+			info->si_stats.ss_relax_time,
+			info->si_stats.ss_net_poll_time / NSEC_PER_MSEC,
+			info->si_stats.ss_nvme_poll_time / NSEC_PER_MSEC);
 		info->si_stats.ss_print_ts = info->si_cur_ts;
 	}
 }
@@ -1575,8 +2467,58 @@ sched_start_cycle(struct sched_data *data, ABT_pool *pools)
 struct sched_unit {
 	uint64_t	 su_start;
 	void		*su_func_addr;
+	/* For CPU accounting, see sched_prof_prep() */
+	uint64_t	 su_prof_key;
+	uint64_t	 su_prof_ticks;
 };
 
+static void
+sched_prof_prep(struct dss_xstream *dx, ABT_unit unit, struct sched_unit *su)
+{
+	struct sched_prof	*prof = dx->dx_sched_info.si_prof;
+	ABT_thread		 thread;
+	void			(*thread_func)(void *);
+	void			*arg;
+
+	su->su_prof_key = 0;
+	if (!prof_enabled(prof))
+		return;
+
+	if (ABT_unit_get_thread(unit, &thread) != ABT_SUCCESS ||
+	    ABT_thread_get_thread_func(thread, &thread_func) != ABT_SUCCESS)
+		return;
+
+	if (thread_func == sched_rpc_func) {
+		/* The RPC is referenced by the handler ULT */
+		if (ABT_thread_get_arg(thread, &arg) != ABT_SUCCESS ||
+		    arg == NULL)
+			return;
+		su->su_prof_key = SCHED_PROF_RPC |
+				  ((crt_rpc_t *)arg)->cr_opc;
+	} else {
+		su->su_prof_key = (uint64_t)(uintptr_t)thread_func;
+	}
+	su->su_prof_ticks = sched_ticks();
+}
+
+static void
+sched_prof_post(struct dss_xstream *dx, struct sched_unit *su)
+{
+	struct sched_prof_ent	*ent;
+	uint64_t		 now;
+
+	if (su->su_prof_key == 0)
+		return;
+
+	now = sched_ticks();
+	ent = prof_ent_get(dx->dx_sched_info.si_prof, su->su_prof_key);
+	if (ent == NULL)
+		return;
+
+	ent->spe_ticks += now - su->su_prof_ticks;
+	ent->spe_runs++;
+}
+
 static inline bool
 watchdog_enabled(struct dss_xstream *dx)
 {
@@ -1649,6 +2591,8 @@ sched_run(ABT_sched sched)
 	ABT_unit		 unit;
 	uint32_t		 work_count = 0;
 	struct sched_unit	 su = { 0 };
+	struct sched_poll	 sp = { 0 };
+	int			 pool_idx;
 	int			 ret;
 
 	ABT_sched_get_data(sched, (void **)&data);
@@ -1664,13 +2608,15 @@ sched_run(ABT_sched sched)
 
 	while (1) {
 		/* Try to pick network poll ULT */
-		pool = pools[DSS_POOL_NET_POLL];
+		pool_idx = DSS_POOL_NET_POLL;
+		pool = pools[pool_idx];
 		unit = sched_pop_net_poll(data, pool);
 		if (unit != ABT_UNIT_NULL)
 			goto execute;
 
 		/* Try to pick NVMe poll ULT */
-		pool = pools[DSS_POOL_NVME_POLL];
+		pool_idx = DSS_POOL_NVME_POLL;
+		pool = pools[pool_idx];
 		unit = sched_pop_nvme_poll(data, pool);
 		if (unit != ABT_UNIT_NULL)
 			goto execute;
@@ -1679,8 +2625,9 @@ sched_run(ABT_sched sched)
 			goto start_cycle;
 
 		/* Try to pick a ULT from generic ABT pool */
-		pool = pools[DSS_POOL_GENERIC];
-		unit = sched_pop_one(data, pool, DSS_POOL_GENERIC);
+		pool_idx = DSS_POOL_GENERIC;
+		pool = pools[pool_idx];
+		unit = sched_pop_one(data, pool, pool_idx);
 		if (unit != ABT_UNIT_NULL)
 			goto execute;
 
@@ -1692,9 +2639,13 @@ sched_run(ABT_sched sched)
 execute:
 		D_ASSERT(pool != ABT_POOL_NULL);
 		sched_watchdog_prep(dx, unit, &su);
+		sched_poll_prep(data, pools, pool_idx, &sp);
+		sched_prof_prep(dx, unit, &su);
 
 		ABT_xstream_run_unit(unit, pool);
 
+		sched_prof_post(dx, &su);
+		sched_poll_post(data, pools, &sp);
 		sched_watchdog_post(dx, &su);
 start_cycle:
 		if (cycle->sc_new_cycle) {
@@ -221,6 +221,8 @@ dss_iv_resp_hdlr(crt_context_t *ctx, void *hdlr_arg,
 {
 	struct dss_xstream	*dx = (struct dss_xstream *)arg;
 
+	if (unlikely(sched_rpc_func != real_rpc_hdlr))
+		sched_rpc_func = real_rpc_hdlr;
 	/*
 	 * Current EC aggregation periodically update IV, use
 	 * PERIODIC flag to avoid interfering CPU relaxing.
@@ -243,6 +245,10 @@ dss_rpc_hdlr(crt_context_t *ctx, void *hdlr_arg,
 
 	if (DAOS_FAIL_CHECK(DAOS_FAIL_LOST_REQ))
 		return 0;
+
+	/* For telling RPC handler ULTs apart on CPU accounting */
+	if (unlikely(sched_rpc_func != real_rpc_hdlr))
+		sched_rpc_func = real_rpc_hdlr;
 	/*
 	 * The mod_id for the RPC originated from CART is 0xfe, and 'module'
 	 * will be NULL for this case.
@@ -267,7 +273,9 @@ dss_nvme_poll_ult(void *args)
 
 	D_ASSERT(dx->dx_main_xs);
 	while (!dss_xstream_exiting(dx)) {
-		bio_nvme_poll(dmi->dmi_nvme_ctxt);
+		/* Let scheduler adjust NVMe poll frequency on completions */
+		dx->dx_sched_info.si_nvme_busy =
+			bio_nvme_poll(dmi->dmi_nvme_ctxt) > 0;
 		ABT_thread_yield();
 	}
 }
@@ -518,6 +526,7 @@ static inline struct dss_xstream *
 dss_xstream_alloc(hwloc_cpuset_t cpus)
 {
 	struct dss_xstream	*dx;
+	hwloc_obj_t		obj;
 	int			i;
 	int			rc = 0;
 
@@ -547,6 +556,11 @@ dss_xstream_alloc(hwloc_cpuset_t cpus)
 		D_GOTO(err_future, rc = -DER_NOMEM);
 	}
 
+	obj = hwloc_get_next_obj_covering_cpuset_by_type(dss_topo, cpus,
+							 HWLOC_OBJ_NUMANODE,
+							 NULL);
+	dx->dx_numa_id = obj != NULL ? obj->logical_index : -1;
+
 	for (i = 0; i < DSS_POOL_CNT; i++)
 		dx->dx_pools[i] = ABT_POOL_NULL;
 
@@ -906,6 +920,31 @@ dss_xstreams_init(void)
 
 	d_getenv_int("DAOS_SCHED_UNIT_RUNTIME_MAX", &sched_unit_runtime_max);
 
+	env = getenv("DAOS_SCHED_POLICY");
+	if (env) {
+		sched_policy = sched_str2policy(env);
+		if (sched_policy == SCHED_POLICY_MAX) {
+			D_WARN("Invalid sched policy [%s]\n", env);
+			sched_policy = SCHED_POLICY_FIFO;
+		}
+	}
+	D_INFO("Sched policy is set to [%s]\n", sched_policy2str(sched_policy));
+
+	d_getenv_bool("DAOS_SCHED_CPU_PROF", &sched_cpu_prof);
+	if (sched_cpu_prof)
+		D_INFO("Per-ULT type CPU accounting is enabled.\n");
+
+	d_getenv_bool("DAOS_SCHED_OFFLOAD_STEAL", &sched_offload_steal);
+	if (sched_offload_steal)
+		D_INFO("Offloaded ULTs could be stolen by idle xstreams.\n");
+
+	d_getenv_int("DAOS_COLL_TREE_FANOUT", &dss_coll_fanout);
+	D_INFO("Thread collective fan-out is set to %u\n", dss_coll_fanout);
+
+	env = getenv("DAOS_SCHED_POOL_QOS");
+	if (env && sched_pool_qos_parse(env) != 0)
+		D_WARN("Invalid pool QoS [%s]\n", env);
+
 	/* start the execution streams */
 	D_DEBUG(DB_TRACE,
 		"%d cores total detected starting %d main xstreams\n",
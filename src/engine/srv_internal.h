@@ -27,24 +27,45 @@ enum {
 struct sched_stats {
 	uint64_t	ss_tot_time;	/* Total CPU time (ms) */
 	uint64_t	ss_relax_time;	/* CPU relax time (ms) */
+	uint64_t	ss_net_poll_time; /* Network poll CPU time (ns) */
+	uint64_t	ss_nvme_poll_time; /* NVMe poll CPU time (ns) */
+	uint64_t	ss_tm_ts;	/* Last metrics update timestamp (ms) */
 	uint64_t	ss_busy_ts;	/* Last busy timestamp (ms) */
 	uint64_t	ss_print_ts;	/* Last stats print timestamp (ms) */
 	uint64_t	ss_watchdog_ts;	/* Last watchdog print ts (ms) */
 	void		*ss_last_unit;	/* Last executed unit */
 };
 
+struct sched_prof;
+
 struct sched_info {
 	uint64_t		 si_cur_ts;	/* Current timestamp (ms) */
 	struct sched_stats	 si_stats;	/* Sched stats */
 	d_list_t		 si_idle_list;	/* All unused requests */
 	d_list_t		 si_sleep_list;	/* All sleeping requests */
 	d_list_t		 si_fifo_list;	/* All IO requests in FIFO */
+	d_list_t		 si_drr_list;	/* Pools with queued IO */
 	d_list_t		 si_purge_list;	/* Stale sched_pool_info */
 	struct d_hash_table	*si_pool_hash;	/* All sched_pool_info */
 	uint32_t		 si_req_cnt;	/* Total inuse request count */
 	int			 si_sleep_cnt;	/* Sleeping request count */
 	int			 si_wait_cnt;	/* Long wait request count */
-	unsigned int		 si_stop:1;
+	/* CPU time spent on polling, relaxing and working (ms) */
+	struct d_tm_node_t	*si_tm_poll;
+	struct d_tm_node_t	*si_tm_relax;
+	struct d_tm_node_t	*si_tm_work;
+	/* Offloaded work items, could be stolen by sibling xstreams */
+	d_list_t		 si_offload_list;
+	pthread_spinlock_t	 si_offload_lock;
+	uint32_t		 si_offload_cnt;
+	/* Next xstream to steal offloaded work from */
+	uint32_t		 si_steal_next;
+	struct d_tm_node_t	*si_tm_offload_local;
+	struct d_tm_node_t	*si_tm_offload_stolen;
+	/* Per-ULT type CPU accounting */
+	struct sched_prof	*si_prof;
+	unsigned int		 si_stop:1,
+				 si_nvme_busy:1; /* Last NVMe poll did work */
 };
 
 /** Per-xstream configuration data */
@@ -68,6 +89,8 @@ struct dss_xstream {
 	int			dx_tgt_id;
 	/* CART context id, invalid (-1) for the offload XS w/o CART context */
 	int			dx_ctx_id;
+	/* NUMA node the xstream is bound to, -1 if unknown */
+	int			dx_numa_id;
 	/* Cart progress timeout in micro-seconds */
 	unsigned int		dx_timeout;
 	bool			dx_main_xs;	/* true for main XS */
@@ -82,6 +105,8 @@ struct engine_metrics {
 	struct d_tm_node_t	*rank_id;
 	struct d_tm_node_t	*dead_rank_events;
 	struct d_tm_node_t	*last_event_time;
+	struct d_tm_node_t	*coll_latency;
+	struct d_tm_node_t	*coll_skew;
 };
 
 extern struct engine_metrics dss_engine_metrics;
@@ -180,18 +205,72 @@ sched_relax_str2mode(char *str)
 		return SCHED_RELAX_MODE_INVALID;
 }
 
+enum sched_policy_type {
+	/* All requests for various pools are processed in FIFO */
+	SCHED_POLICY_FIFO	= 0,
+	/*
+	 * All requests are processed in RR based on certain ID (Client ID,
+	 * Pool ID, Container ID, JobID, UID, etc.), the pool ID based
+	 * deficit round robin is implemented.
+	 */
+	SCHED_POLICY_ID_RR,
+	/*
+	 * Request priority is based on certain ID (Client ID, Pool ID,
+	 * Container ID, JobID, UID, etc.)
+	 */
+	SCHED_POLICY_ID_PRIO,
+	SCHED_POLICY_MAX
+};
+
+static inline char *
+sched_policy2str(enum sched_policy_type policy)
+{
+	switch (policy) {
+	case SCHED_POLICY_FIFO:
+		return "fifo";
+	case SCHED_POLICY_ID_RR:
+		return "pool_rr";
+	default:
+		return "invalid";
+	}
+}
+
+static inline enum sched_policy_type
+sched_str2policy(char *str)
+{
+	if (strcasecmp(str, "fifo") == 0)
+		return SCHED_POLICY_FIFO;
+	else if (strcasecmp(str, "pool_rr") == 0)
+		return SCHED_POLICY_ID_RR;
+	else
+		return SCHED_POLICY_MAX;
+}
+
 extern bool sched_prio_disabled;
 extern unsigned int sched_stats_intvl;
 extern unsigned int sched_relax_intvl;
 extern unsigned int sched_relax_mode;
 extern unsigned int sched_unit_runtime_max;
+extern unsigned int sched_policy;
+extern bool sched_offload_steal;
+extern bool sched_cpu_prof;
+extern void (*sched_rpc_func)(void *);
 
 void dss_sched_fini(struct dss_xstream *dx);
 int dss_sched_init(struct dss_xstream *dx);
 int sched_set_throttle(unsigned int type, unsigned int percent);
+int sched_pool_qos_parse(char *str);
 int sched_req_enqueue(struct dss_xstream *dx, struct sched_req_attr *attr,
 		      void (*func)(void *), void *arg);
 void sched_stop(struct dss_xstream *dx);
+/** Default fan-out degree of the thread collective tree */
+#define DSS_COLL_FANOUT_DEFAULT	4
+extern unsigned int dss_coll_fanout;
+
+int sched_offload_push(struct dss_xstream *dx, void (*func)(void *),
+		       void *arg);
+int sched_cpu_sample_start(struct dss_xstream *dx);
+void sched_cpu_sample_stop(struct dss_xstream *dx);
 
 
 static inline bool
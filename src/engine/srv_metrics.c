@@ -67,6 +67,22 @@ dss_engine_metrics_init(void)
 		return rc;
 	}
 
+	rc = d_tm_add_metric(&dss_engine_metrics.coll_latency,
+			     D_TM_STATS_GAUGE,
+			     "Latency of thread collective operations", "us",
+			     "sched/collective/latency");
+	if (rc != 0)
+		D_WARN("unable to add metric for collective latency: "
+		       DF_RC "\n", DP_RC(rc));
+
+	rc = d_tm_add_metric(&dss_engine_metrics.coll_skew, D_TM_STATS_GAUGE,
+			     "Completion skew across xstreams of thread "
+			     "collective operations", "us",
+			     "sched/collective/skew");
+	if (rc != 0)
+		D_WARN("unable to add metric for collective skew: "
+		       DF_RC "\n", DP_RC(rc));
+
 	return 0;
 }
 
@@ -9,6 +9,7 @@
 #include <abt.h>
 #include <daos/common.h>
 #include <daos_errno.h>
+#include <gurt/telemetry_producer.h>
 #include "srv_internal.h"
 
 /* ============== Thread collective functions ============================ */
@@ -40,6 +41,41 @@ struct collective_arg {
 	struct dss_future_arg		ca_future;
 };
 
+/** Fan-out degree of the collective tree, 0 or 1 for flat fan-out */
+unsigned int	dss_coll_fanout = DSS_COLL_FANOUT_DEFAULT;
+
+struct coll_tree_node;
+
+/**
+ * Tree-structured collective: each target ULT spawns the ULTs of its
+ * children before running the collective function, so ULT creation is
+ * spread over xstreams instead of being serialized on the caller. Return
+ * codes and reduce args are folded into the aggregator as soon as each
+ * target completes, overlapping with the execution on other targets.
+ */
+struct coll_tree_arg {
+	struct dss_coll_ops	*cta_ops;
+	struct dss_coll_args	*cta_args;
+	struct coll_tree_node	*cta_nodes;
+	ABT_mutex		 cta_mutex;
+	ABT_eventual		 cta_eventual;
+	unsigned int		 cta_flags;
+	int			 cta_node_nr;
+	/** Number of nodes not completed yet, protected by cta_mutex */
+	int			 cta_pending;
+	/** First error, read without lock for early abort */
+	int			 cta_rc;
+	int			 cta_failed;
+	/** Completion time (nsecs) of the first and the last node */
+	uint64_t		 cta_first_done;
+	uint64_t		 cta_last_done;
+};
+
+struct coll_tree_node {
+	struct coll_tree_arg	*ctn_arg;
+	int			 ctn_tgt;
+};
+
 static void
 collective_func(void *varg)
 {
@@ -83,6 +119,176 @@ collective_reduce(void **arg)
 	}
 }
 
+static bool
+coll_tgt_excluded(struct dss_coll_args *args, int tid)
+{
+	int	i;
+
+	for (i = 0; i < args->ca_exclude_tgts_cnt; i++)
+		if (args->ca_exclude_tgts[i] == tid)
+			return true;
+
+	return false;
+}
+
+static void
+coll_tree_done(struct coll_tree_node *node, int rc)
+{
+	struct coll_tree_arg		*cta = node->ctn_arg;
+	struct dss_stream_arg_type	*stream;
+	uint64_t			 now = daos_get_ntime();
+	bool				 done;
+
+	stream = &cta->cta_args->ca_stream_args.csa_streams[node->ctn_tgt];
+	stream->st_rc = rc;
+
+	ABT_mutex_lock(cta->cta_mutex);
+	if (rc != 0) {
+		if (cta->cta_rc == 0)
+			cta->cta_rc = rc;
+		cta->cta_failed++;
+	}
+	if (cta->cta_ops->co_reduce)
+		cta->cta_ops->co_reduce(cta->cta_args->ca_aggregator,
+					stream->st_arg);
+
+	if (cta->cta_first_done == 0)
+		cta->cta_first_done = now;
+	cta->cta_last_done = now;
+
+	D_ASSERT(cta->cta_pending > 0);
+	done = (--cta->cta_pending == 0);
+	ABT_mutex_unlock(cta->cta_mutex);
+
+	/* The caller may free @cta once the eventual is set */
+	if (done)
+		ABT_eventual_set(cta->cta_eventual, NULL, 0);
+}
+
+/* Complete the node @idx and all its descendants which won't be spawned */
+static void
+coll_tree_fail(struct coll_tree_arg *cta, int idx, int rc)
+{
+	int	first = (idx + 1) * dss_coll_fanout;
+	int	i;
+
+	for (i = first; i < first + dss_coll_fanout && i < cta->cta_node_nr;
+	     i++)
+		coll_tree_fail(cta, i, rc);
+
+	coll_tree_done(&cta->cta_nodes[idx], rc);
+}
+
+static void coll_tree_func(void *varg);
+
+/*
+ * Spawn ULTs for children of the node @idx, the caller is the virtual root
+ * with index -1. Children of node N are [(N + 1) * fanout, (N + 2) * fanout).
+ */
+static void
+coll_tree_spawn(struct coll_tree_arg *cta, int idx)
+{
+	struct coll_tree_node	*node;
+	struct dss_xstream	*dx;
+	int			 first = (idx + 1) * dss_coll_fanout;
+	int			 i;
+	int			 rc;
+
+	for (i = first; i < first + dss_coll_fanout && i < cta->cta_node_nr;
+	     i++) {
+		node = &cta->cta_nodes[i];
+		dx = dss_get_xstream(DSS_MAIN_XS_ID(node->ctn_tgt));
+		rc = sched_create_thread(dx, coll_tree_func, node,
+					 ABT_THREAD_ATTR_NULL, NULL,
+					 cta->cta_flags);
+		if (rc != 0) {
+			D_ERROR("Failed to spawn collective ULT on tgt %d: "
+				DF_RC"\n", node->ctn_tgt, DP_RC(rc));
+			coll_tree_fail(cta, i, rc);
+		}
+	}
+}
+
+static void
+coll_tree_func(void *varg)
+{
+	struct coll_tree_node	*node = varg;
+	struct coll_tree_arg	*cta = node->ctn_arg;
+	int			 rc;
+
+	coll_tree_spawn(cta, node - cta->cta_nodes);
+
+	if ((cta->cta_flags & DSS_ULT_FL_COLL_ABORT) && cta->cta_rc != 0)
+		rc = -DER_CANCELED;
+	else
+		rc = cta->cta_ops->co_func(cta->cta_args->ca_func_args);
+
+	coll_tree_done(node, rc);
+}
+
+static int
+collective_tree(struct dss_coll_ops *ops, struct dss_coll_args *args,
+		unsigned int flags)
+{
+	struct dss_coll_stream_args	*stream_args = &args->ca_stream_args;
+	struct coll_tree_arg		 cta = { 0 };
+	int				 tid;
+	int				 rc;
+
+	D_ALLOC_ARRAY(cta.cta_nodes, dss_tgt_nr);
+	if (cta.cta_nodes == NULL)
+		return -DER_NOMEM;
+
+	rc = ABT_mutex_create(&cta.cta_mutex);
+	if (rc != ABT_SUCCESS)
+		D_GOTO(out_nodes, rc = dss_abterr2der(rc));
+
+	rc = ABT_eventual_create(0, &cta.cta_eventual);
+	if (rc != ABT_SUCCESS)
+		D_GOTO(out_mutex, rc = dss_abterr2der(rc));
+
+	cta.cta_ops = ops;
+	cta.cta_args = args;
+	cta.cta_flags = flags;
+
+	for (tid = 0; tid < dss_tgt_nr; tid++) {
+		if (coll_tgt_excluded(args, tid)) {
+			D_DEBUG(DB_TRACE, "Skip tgt %d\n", tid);
+			if (ops->co_reduce)
+				ops->co_reduce(args->ca_aggregator,
+					stream_args->csa_streams[tid].st_arg);
+			continue;
+		}
+		cta.cta_nodes[cta.cta_node_nr].ctn_arg = &cta;
+		cta.cta_nodes[cta.cta_node_nr].ctn_tgt = tid;
+		cta.cta_node_nr++;
+	}
+
+	if (cta.cta_node_nr == 0)
+		D_GOTO(out_eventual, rc = 0);
+
+	cta.cta_pending = cta.cta_node_nr;
+	coll_tree_spawn(&cta, -1);
+	ABT_eventual_wait(cta.cta_eventual, NULL);
+
+	if (dss_engine_metrics.coll_skew != NULL)
+		d_tm_set_gauge(dss_engine_metrics.coll_skew,
+			       (cta.cta_last_done - cta.cta_first_done) /
+			       NSEC_PER_USEC);
+	D_DEBUG(DB_TRACE, "%d targets, %d failed, skew "DF_U64" us\n",
+		cta.cta_node_nr, cta.cta_failed,
+		(cta.cta_last_done - cta.cta_first_done) / NSEC_PER_USEC);
+	rc = cta.cta_rc;
+
+out_eventual:
+	ABT_eventual_free(&cta.cta_eventual);
+out_mutex:
+	ABT_mutex_free(&cta.cta_mutex);
+out_nodes:
+	D_FREE(cta.cta_nodes);
+	return rc;
+}
+
 static int
 dss_collective_reduce_internal(struct dss_coll_ops *ops,
 			       struct dss_coll_args *args, bool create_ult,
@@ -94,6 +300,7 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 	struct aggregator_arg_type	aggregator;
 	struct dss_xstream		*dx;
 	ABT_future			future;
+	uint64_t			start;
 	int				xs_nr;
 	int				rc;
 	int				tid;
@@ -115,6 +322,7 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 		return -DER_CANCELED;
 	}
 
+	start = daos_get_ntime();
 	xs_nr = dss_tgt_nr;
 	stream_args = &args->ca_stream_args;
 	D_ALLOC_ARRAY(stream_args->csa_streams, xs_nr);
@@ -150,25 +358,23 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 				D_GOTO(out_future, rc);
 		}
 
+	/* Tasklets can't spawn children from the tree, so stay flat */
+	if (create_ult && dss_coll_fanout > 1) {
+		rc = collective_tree(ops, args, flags);
+		goto out_latency;
+	}
+
 	rc = ABT_future_set(future, (void *)&aggregator);
 	D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
 	for (tid = 0; tid < xs_nr; tid++) {
 		stream			= &stream_args->csa_streams[tid];
 		stream->st_coll_args	= &carg;
 
-		if (args->ca_exclude_tgts_cnt) {
-			int i;
-
-			for (i = 0; i < args->ca_exclude_tgts_cnt; i++)
-				if (args->ca_exclude_tgts[i] == tid)
-					break;
-
-			if (i < args->ca_exclude_tgts_cnt) {
-				D_DEBUG(DB_TRACE, "Skip tgt %d\n", tid);
-				rc = ABT_future_set(future, (void *)stream);
-				D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
-				continue;
-			}
+		if (coll_tgt_excluded(args, tid)) {
+			D_DEBUG(DB_TRACE, "Skip tgt %d\n", tid);
+			rc = ABT_future_set(future, (void *)stream);
+			D_ASSERTF(rc == ABT_SUCCESS, "%d\n", rc);
+			continue;
 		}
 
 		dx = dss_get_xstream(DSS_MAIN_XS_ID(tid));
@@ -190,6 +396,10 @@ dss_collective_reduce_internal(struct dss_coll_ops *ops,
 
 	rc = aggregator.at_rc;
 
+out_latency:
+	if (dss_engine_metrics.coll_latency != NULL)
+		d_tm_set_gauge(dss_engine_metrics.coll_latency,
+			       (daos_get_ntime() - start) / NSEC_PER_USEC);
 out_future:
 	ABT_future_free(&future);
 
@@ -377,6 +587,17 @@ ult_create_internal(void (*func)(void *), void *arg, int xs_type, int tgt_idx,
 	if (dx == NULL)
 		return -DER_NONEXIST;
 
+	/*
+	 * Stateless offloaded ULT (caller doesn't track the ULT handle) could
+	 * be executed by any idle xstream on same NUMA node.
+	 */
+	if (sched_offload_steal && xs_type == DSS_XS_OFFLOAD && ult == NULL &&
+	    stack_size == 0 && !(flags & DSS_ULT_FL_PERIODIC)) {
+		if (sched_xstream_stopping())
+			return -DER_SHUTDOWN;
+		return sched_offload_push(dx, func, arg);
+	}
+
 	if (stack_size > 0) {
 		rc = ABT_thread_attr_create(&attr);
 		if (rc != ABT_SUCCESS)
@@ -27,7 +27,8 @@ struct cont_props {
 			 dcp_dedup_enabled:1,
 			 dcp_dedup_verify:1,
 			 dcp_compress_enabled:1,
-			 dcp_encrypt_enabled:1;
+			 dcp_encrypt_enabled:1,
+			 dcp_ec_pdelta:1;
 };
 
 void
@@ -98,6 +99,9 @@ daos_cont_rf2allowedfailures(int rf);
 uint32_t
 daos_cont_prop2ec_cell_sz(daos_prop_t *props);
 
+bool
+daos_cont_prop2ec_pdelta(daos_prop_t *props);
+
 /*
  * alloc'ed oid property
  */
@@ -47,6 +47,8 @@ daos_handle_t dc_cont_hdl2pool_hdl(daos_handle_t coh);
 struct daos_csummer *dc_cont_hdl2csummer(daos_handle_t coh);
 struct cont_props dc_cont_hdl2props(daos_handle_t coh);
 int dc_cont_hdl2redunfac(daos_handle_t coh);
+uint64_t dc_cont_hdl2capas(daos_handle_t coh);
+struct dc_obj_layout_cache *dc_cont_hdl2layout_cache(daos_handle_t coh);
 
 int dc_cont_local2global(daos_handle_t coh, d_iov_t *glob);
 int dc_cont_global2local(daos_handle_t poh, d_iov_t glob,
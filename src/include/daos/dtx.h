@@ -20,6 +20,15 @@
 /* The time (in second) threshold for batched DTX commit. */
 #define DTX_COMMIT_THRESHOLD_AGE	10
 
+/*
+ * VOS aggregation should try to avoid aggregating in the epoch range where
+ * lots of data records are pending to commit, so the highest aggregate epoch
+ * will be:
+ *
+ * current HLC - (DTX batched commit threshold + buffer period)
+ */
+#define DAOS_AGG_THRESHOLD	(DTX_COMMIT_THRESHOLD_AGE + 10) /* seconds */
+
 enum dtx_target_flags {
 	/* The target only contains read-only operations for the DTX. */
 	DTF_RDONLY			= (1 << 0),
@@ -252,6 +261,7 @@ struct dtx_epoch {
 
 /* dtx_epoch.oe_flags */
 #define DTX_EPOCH_UNCERTAIN	(1U << 0)	/**< oe_value is uncertain */
+#define DTX_EPOCH_SNAP_READ	(1U << 1)	/**< stable snapshot read */
 
 /** Does \a epoch contain a chosen TX epoch? */
 static inline bool
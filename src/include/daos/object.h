@@ -474,6 +474,12 @@ int dc_obj_fetch_md(daos_obj_id_t oid, struct daos_obj_md *md);
 int dc_obj_layout_get(daos_handle_t oh, struct daos_obj_layout **p_layout);
 int dc_obj_layout_refresh(daos_handle_t oh);
 int dc_obj_verify(daos_handle_t oh, daos_epoch_t *epochs, unsigned int nr);
+
+/** Per container cache of object layouts */
+struct dc_obj_layout_cache;
+
+int dc_obj_layout_cache_create(struct dc_obj_layout_cache **cache);
+void dc_obj_layout_cache_destroy(struct dc_obj_layout_cache *cache);
 daos_handle_t dc_obj_hdl2cont_hdl(daos_handle_t oh);
 
 int dc_tx_open(tse_task_t *task);
@@ -486,6 +492,7 @@ int dc_tx_local_open(daos_handle_t coh, daos_epoch_t epoch,
 		     uint32_t flags, daos_handle_t *th);
 int dc_tx_local_close(daos_handle_t th);
 int dc_tx_hdl2epoch(daos_handle_t th, daos_epoch_t *epoch);
+int dc_tx_wcq_flush(tse_task_t *task);
 
 /** Decode shard number from enumeration anchor */
 static inline uint32_t
@@ -741,5 +748,8 @@ dc_obj_metrics_incr_completecntr(int opc, int rc) {
 int dc_obj_metrics_init();
 void dc_obj_metrics_fini();
 int dc_obj_metrics_get_rpccntrs(daos_metrics_obj_rpc_cntrs_t *cntrs);
+int dc_obj_metrics_get_layout_cntrs(daos_metrics_obj_layout_cntrs_t *cntrs);
+int dc_obj_metrics_get_ec_cntrs(daos_metrics_obj_ec_cntrs_t *cntrs);
+int dc_obj_metrics_get_ec_recov_cntrs(daos_metrics_obj_ec_recov_cntrs_t *cntrs);
 int dc_obj_metrics_reset();
 #endif /* __DD_OBJ_H__ */
@@ -58,6 +58,7 @@ struct daos_task_args {
 		daos_cont_list_snap_t	cont_list_snap;
 		daos_cont_create_snap_t	cont_create_snap;
 		daos_cont_destroy_snap_t cont_destroy_snap;
+		daos_cont_flush_t	cont_flush;
 
 		/** Transaction */
 		daos_tx_open_t		tx_open;
@@ -251,4 +252,11 @@ dc_obj_list_obj_task_create(daos_handle_t oh, daos_handle_t th,
 
 void *
 dc_task_get_args(tse_task_t *task);
+
+/**
+ * Check whether \a task is bound to the per-thread private event, that is,
+ * the API caller is blocked until the task completes.
+ */
+bool
+dc_task_is_blocking(tse_task_t *task);
 #endif
@@ -29,6 +29,20 @@ enum {
 	 * released or repurposed after corresponding operations complete.
 	 */
 	DAOS_TF_ZERO_COPY	= (1 << 1),
+	/**
+	 * Read-only transaction bound to a stable epoch that lags the current
+	 * HLC by DTX_COMMIT_THRESHOLD_AGE seconds, at which all modifications
+	 * are expected to have been committed. Reads neither update the read
+	 * timestamps nor run the epoch uncertainty checks on the servers.
+	 * Instead, the servers make modifications at or below the stable
+	 * epoch restart, and fail reads with -DER_TX_RESTART once aggregation
+	 * may have covered the epoch, i.e. when the transaction stays open
+	 * for more than about ten seconds. daos_tx_restart() then moves the
+	 * transaction to a newer stable epoch. Modifications more recent than
+	 * the stable epoch are invisible to the transaction. Implies
+	 * DAOS_TF_RDONLY.
+	 */
+	DAOS_TF_SNAP_READ	= (1 << 2),
 };
 
 /**
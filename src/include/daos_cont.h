@@ -30,13 +30,19 @@ extern "C" {
  *
  * DAOS_COO_FORCE skips the check to see if the pool meets the redundancy
  * factor/level requirements of the container.
+ *
+ * DAOS_COO_WCOMB enables client side write combining: small non-transactional
+ * updates against the same target are batched and sent via one RPC. Each
+ * update still completes independently, after its batch has been committed,
+ * see daos_cont_flush().
  */
 #define DAOS_COO_RO		(1U << 0)
 #define DAOS_COO_RW		(1U << 1)
 #define DAOS_COO_NOSLIP		(1U << 2)
 #define DAOS_COO_FORCE		(1U << 3)
+#define DAOS_COO_WCOMB		(1U << 4)
 
-#define DAOS_COO_NBITS	(4)
+#define DAOS_COO_NBITS	(5)
 #define DAOS_COO_MASK	((1U << DAOS_COO_NBITS) - 1)
 
 /** Container information */
@@ -548,6 +554,22 @@ daos_cont_alloc_oids(daos_handle_t coh, daos_size_t num_oids, uint64_t *oid,
 int
 daos_cont_aggregate(daos_handle_t coh, daos_epoch_t epoch, daos_event_t *ev);
 
+/**
+ * Send all the updates that are pending in the client write-combining queue
+ * of the container opened with DAOS_COO_WCOMB. The updates pending in the
+ * same event queue (or the same thread for blocking mode) as \a ev are
+ * waited for, their failure is reported via both their own completion events
+ * and this call.
+ *
+ * \param[in]	coh	Container handle
+ * \param[in]	ev	Completion event, it is optional and can be NULL.
+ *			The function will run in blocking mode if \a ev is NULL.
+ *
+ * \return		0 if Success, negative if failed.
+ */
+int
+daos_cont_flush(daos_handle_t coh, daos_event_t *ev);
+
 /**
  * Rollback to a specific persistent snapshot.
  *
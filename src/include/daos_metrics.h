@@ -20,7 +20,7 @@ extern "C" {
 
 /** DAOS Metrics Major and Minor Version */
 #define DAOS_METRICS_MAJOR_VERSION	0x1
-#define DAOS_METRICS_MINOR_VERSION	0x0
+#define DAOS_METRICS_MINOR_VERSION	0x1
 
 /** counters */
 typedef struct {
@@ -37,6 +37,9 @@ enum daos_metrics_cntr_grp {
 	DAOS_METRICS_POOL_RPC_CNTR = 1,
 	DAOS_METRICS_CONT_RPC_CNTR = 2,
 	DAOS_METRICS_OBJ_RPC_CNTR  = 3,
+	DAOS_METRICS_OBJ_LAYOUT_CNTR = 4,
+	DAOS_METRICS_OBJ_EC_CNTR   = 5,
+	DAOS_METRICS_OBJ_EC_RECOV_CNTR = 6,
 };
 
 /** RPC counters associated with DAOS Pool */
@@ -107,6 +110,42 @@ typedef struct {
 	daos_metrics_cntr_t orc_cpd_cnt;
 } daos_metrics_obj_rpc_cntrs_t;
 
+/** Counters of the client object layout cache */
+typedef struct {
+	/** Object layouts found in the cache */
+	unsigned long lcc_hit;
+	/** Object layouts calculated by placement */
+	unsigned long lcc_miss;
+	/** Cached layouts dropped because of pool map change */
+	unsigned long lcc_inval;
+} daos_metrics_obj_layout_cntrs_t;
+
+/** Counters of the client EC encoding, for encode throughput */
+typedef struct {
+	/** Full stripes encoded */
+	unsigned long ecc_stripes;
+	/** Full stripes encoded by the EC encoding workers */
+	unsigned long ecc_offloaded;
+	/** Bytes of data encoded */
+	unsigned long ecc_bytes;
+	/** Time spent on encoding in nanoseconds */
+	unsigned long ecc_nsec;
+} daos_metrics_obj_ec_cntrs_t;
+
+/** Counters of the client EC degraded fetch */
+typedef struct {
+	/** Degraded fetches that recovered data from the other shards */
+	unsigned long erc_fetches;
+	/** Full stripes reconstructed */
+	unsigned long erc_stripes;
+	/** Full stripes served by the reconstructed stripe cache */
+	unsigned long erc_cache_hit;
+	/** Full stripes not found in the reconstructed stripe cache */
+	unsigned long erc_cache_miss;
+	/** Full stripes evicted from the reconstructed stripe cache */
+	unsigned long erc_cache_evict;
+} daos_metrics_obj_ec_recov_cntrs_t;
+
 /** Structure to be used to obtain the daos client counters metrics */
 typedef struct {
 	/** Counter metric group */
@@ -119,6 +158,12 @@ typedef struct {
 		daos_metrics_cont_rpc_cntrs_t arc_cont_cntrs;
 		/** mc_grp == DAOS_METRICS_OBJ_RPC_CNTR **/
 		daos_metrics_obj_rpc_cntrs_t  arc_obj_cntrs;
+		/** mc_grp == DAOS_METRICS_OBJ_LAYOUT_CNTR **/
+		daos_metrics_obj_layout_cntrs_t arc_layout_cntrs;
+		/** mc_grp == DAOS_METRICS_OBJ_EC_CNTR **/
+		daos_metrics_obj_ec_cntrs_t arc_ec_cntrs;
+		/** mc_grp == DAOS_METRICS_OBJ_EC_RECOV_CNTR **/
+		daos_metrics_obj_ec_recov_cntrs_t arc_ec_recov_cntrs;
 	}u;
 } daos_metrics_ucntrs_t;
 
@@ -196,6 +196,12 @@ enum daos_cont_props {
 	DAOS_PROP_CO_ALLOCED_OID,
 	/** EC cell size, it can overwrite DAOS_PROP_EC_CELL_SZ of pool */
 	DAOS_PROP_CO_EC_CELL_SZ,
+	/**
+	 * Ship parity deltas instead of full parity on EC aggregation of
+	 * partial stripes. Value = ON/OFF
+	 * Default: DAOS_PROP_CO_EC_PDELTA_OFF
+	 */
+	DAOS_PROP_CO_EC_PDELTA,
 	DAOS_PROP_CO_MAX,
 };
 
@@ -244,6 +250,12 @@ enum {
 	DAOS_PROP_CO_CSUM_SV_ON
 };
 
+/** container EC parity delta */
+enum {
+	DAOS_PROP_CO_EC_PDELTA_OFF,
+	DAOS_PROP_CO_EC_PDELTA_ON
+};
+
 /** container deduplication */
 enum {
 	DAOS_PROP_CO_DEDUP_OFF,
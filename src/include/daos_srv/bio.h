@@ -746,6 +746,28 @@ void bio_log_csum_err(struct bio_xs_context *b, int tgt_id);
 /* Too many blob IO queued, need to schedule a NVMe poll? */
 bool bio_need_nvme_poll(struct bio_xs_context *xs);
 
+/*
+ * Invalidate the NVMe read cache for the blocks being freed, it must be
+ * called before the freed blocks can be reused.
+ *
+ * \param ioctxt	[IN]	I/O context
+ * \param off		[IN]	Offset in bytes within the blob
+ * \param len		[IN]	Length in bytes
+ */
+void bio_rcache_invalidate(struct bio_io_context *ioctxt, uint64_t off,
+			   uint64_t len);
+
+/*
+ * Check if the NVMe device used by the xstream is degrading, i.e. new media
+ * or I/O errors were reported recently, or the recent I/O latency is much
+ * higher than the long term average.
+ *
+ * \param xs_ctxt	[IN]	Per-xstream NVMe context
+ *
+ * \return		true if the device is degrading
+ */
+bool bio_xs_degraded(struct bio_xs_context *xs_ctxt);
+
 /*
  * Replace a device.
  *
@@ -104,12 +104,14 @@ struct ds_cont_child {
 	uint64_t		sc_ec_agg_eph_boundry;
 	/* The current EC aggregate epoch for this xstream */
 	uint64_t		sc_ec_agg_eph;
-	/* The objects with committable DTXs in DRAM. */
-	daos_handle_t		 sc_dtx_cos_hdl;
-	/* The DTX COS-btree. */
-	struct btr_root		 sc_dtx_cos_btr;
+	/* The objects with committable DTXs in DRAM, indexed by oid + dkey. */
+	struct d_hash_table	*sc_dtx_cos_hash;
+	/* The committable DTXs in DRAM, indexed by DTX identifier. */
+	struct d_hash_table	*sc_dtx_cos_xid_hash;
 	/* The global list for committable DTXs. */
 	d_list_t		 sc_dtx_cos_list;
+	/* The DTXs known as committable on their leaders, for DTX refresh. */
+	struct dtx_id		*sc_dtx_cmt_cache;
 	/* The pool map version for the latest DTX resync on the container. */
 	uint32_t		 sc_dtx_resync_ver;
 	/* the pool map version of updating DAOS_PROP_CO_STATUS prop */
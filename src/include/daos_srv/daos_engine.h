@@ -354,6 +354,37 @@ bool sched_req_is_aborted(struct sched_request *req);
  */
 int sched_req_space_check(struct sched_request *req);
 
+/**
+ * Set the QoS of a pool for the pool round robin sched policy.
+ *
+ * \param[in] pool_id	Pool UUID
+ * \param[in] weight	Share of IO requests against other pools, [1, 100]
+ * \param[in] lat_ms	Queued IO older than this (msecs) is kicked ahead of
+ *			its share, 0 means no latency target
+ *
+ * \retval		Zero on success, negative value on error
+ */
+int sched_pool_qos_set(uuid_t pool_id, unsigned int weight,
+		       unsigned int lat_ms);
+
+/**
+ * Create per-pool scheduler metrics (queue depth & queuing time) under pool
+ * metrics directory, called on each target xstream.
+ *
+ * \param[in] pool_id	Pool UUID
+ * \param[in] path	Pool metrics directory
+ * \param[in] tgt_id	VOS target ID
+ */
+void sched_pool_metrics_init(uuid_t pool_id, const char *path, int tgt_id);
+
+/**
+ * Detach per-pool scheduler metrics before pool metrics directory is
+ * deleted, called on each target xstream.
+ *
+ * \param[in] pool_id	Pool UUID
+ */
+void sched_pool_metrics_fini(uuid_t pool_id);
+
 /**
  * Wrapper of ABT_cond_wait(), inform scheduler that it's going
  * to be blocked for a relative long time.
@@ -483,6 +514,11 @@ int dss_parameters_set(unsigned int key_id, uint64_t value);
 enum dss_ult_flags {
 	/* Periodically created ULTs */
 	DSS_ULT_FL_PERIODIC	= (1 << 0),
+	/*
+	 * Thread collective: once any target failed, skip the collective
+	 * function on targets not started yet and return -DER_CANCELED.
+	 */
+	DSS_ULT_FL_COLL_ABORT	= (1 << 1),
 };
 
 int dss_ult_create(void (*func)(void *), void *arg, int xs_type, int tgt_id,
@@ -14,7 +14,7 @@
 #include <daos_srv/pool.h>
 #include <daos_srv/container.h>
 
-#define DTX_REFRESH_MAX 4
+#define DTX_REFRESH_MAX 16
 
 struct dtx_share_peer {
 	d_list_t		dsp_link;
@@ -134,6 +134,14 @@ struct dtx_handle {
 struct dtx_sub_status {
 	struct daos_shard_tgt		dss_tgt;
 	int				dss_result;
+	/* The count of DTXs piggybacked on the dispatched RPC for commit. */
+	int				dss_pb_cnt;
+	/* The DTX array sent via the dispatched RPC, the first ones are the
+	 * dth_dti_cos, followed by dss_pb_cnt piggybacked DTXs.
+	 */
+	struct dtx_id			*dss_pb_dtis;
+	/* The CoS keys for the piggybacked DTXs. */
+	struct dtx_cos_key		*dss_pb_dcks;
 };
 
 struct dtx_leader_handle;
@@ -225,6 +233,9 @@ dtx_list_cos(struct ds_cont_child *cont, daos_unit_oid_t *oid,
 int
 dtx_leader_exec_ops(struct dtx_leader_handle *dlh, dtx_sub_func_t func,
 		    dtx_agg_cb_t agg_cb, void *agg_cb_arg, void *func_arg);
+int
+dtx_leader_piggyback(struct dtx_leader_handle *dlh, struct ds_cont_child *cont,
+		     int idx, struct dtx_id **dtis);
 
 int dtx_batched_commit_register(struct ds_cont_child *cont);
 
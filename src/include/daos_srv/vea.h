@@ -50,6 +50,8 @@ struct vea_resrvd_ext {
 	uint64_t		 vre_blk_off;
 	/* Hint offset before the reserve */
 	uint64_t		 vre_hint_off;
+	/* I/O stream hint offset before the reserve */
+	uint64_t		 vre_stream_off;
 	/* Hint sequence to detect interleaved reserve -> publish */
 	uint64_t		 vre_hint_seq;
 	/* Total reserved blocks */
@@ -113,6 +115,13 @@ struct vea_attr {
 	uint64_t	va_free_blks;	/* Free blocks available for alloc */
 };
 
+/*
+ * Buckets of the free extent size histogram, bucket i counts the free
+ * extents with block count in (16^(i-1), 16^i], the last bucket counts
+ * all the larger ones.
+ */
+#define VEA_FRAGS_HIST_CNT	6
+
 /* VEA statistics */
 struct vea_stat {
 	uint64_t	vs_free_persistent;	/* Persistent free blocks */
@@ -123,7 +132,10 @@ struct vea_stat {
 	uint64_t	vs_resrv_large;	/* Number of large reserve */
 	uint64_t	vs_resrv_small;	/* Number of small reserve */
 	uint64_t	vs_resrv_vec;	/* Number of vector reserve */
+	uint64_t	vs_resrv_bitmap;/* Number of bitmap reserve */
 	uint32_t	vs_largest_blks;/* Largest free frag size in blocks */
+	/* Free frags histogram by size, see VEA_FRAGS_HIST_CNT */
+	uint64_t	vs_frags_hist[VEA_FRAGS_HIST_CNT];
 };
 
 struct vea_space_info;
@@ -219,6 +231,27 @@ void vea_hint_unload(struct vea_hint_context *thc);
 int vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
 		struct vea_hint_context *hint, d_list_t *resrvd_list);
 
+/**
+ * Same as vea_reserve(), but keeps the reservations of the sequential writer
+ * identified by @key (e.g. hash of object ID) contiguous by its own in-memory
+ * allocation cursor, instead of appending to the shared I/O stream. Cursors
+ * are kept in a small LRU table in @hint and aren't persistent, the stream
+ * hint is still published by vea_tx_publish() as usual.
+ *
+ * \param vsi         [IN]	In-memory compound index
+ * \param blk_cnt     [IN]	Total block count to be reserved
+ * \param hint        [IN]	Hint data
+ * \param key         [IN]	Writer key, zero means no per-writer cursor
+ * \param resrvd_list [OUT]	List for storing the reserved extents
+ *
+ * \return			Zero on success, reserved extent(s) will be
+ *				added in the @resrvd_list; Appropriated
+ *				negative value on error
+ */
+int vea_reserve_key(struct vea_space_info *vsi, uint32_t blk_cnt,
+		    struct vea_hint_context *hint, uint64_t key,
+		    d_list_t *resrvd_list);
+
 /**
  * Cancel the reserved extent(s)
  *
@@ -300,6 +333,20 @@ int vea_get_ext_vector(struct vea_space_info *vsi, uint64_t blk_off,
 int vea_query(struct vea_space_info *vsi, struct vea_attr *attr,
 	      struct vea_stat *stat);
 
+/**
+ * Check if an allocated extent is isolated by free extents on both sides,
+ * relocating such extent would coalesce the free extents around it. It's
+ * used by the defragmentation to pick up the extents worth relocating.
+ *
+ * \param vsi       [IN]	In-memory compound index
+ * \param blk_off   [IN]	Block offset of the allocated extent
+ * \param blk_cnt   [IN]	Block count of the allocated extent
+ *
+ * \return			True if the extent is isolated
+ */
+bool vea_ext_isolated(struct vea_space_info *vsi, uint64_t blk_off,
+		      uint32_t blk_cnt);
+
 /**
  * Pause or resume flushing the free extents in aging buffer
  *
@@ -398,6 +398,21 @@ vos_cont_close(daos_handle_t coh);
 int
 vos_cont_query(daos_handle_t coh, vos_cont_info_t *cinfo);
 
+/**
+ * Pin the epoch of a stable snapshot read, which doesn't update the read
+ * timestamps. Once pinned, modifications under a DTX at or below \a epoch
+ * are rejected with -DER_TX_RESTART.
+ *
+ * \param coh	[IN]	Container open handle.
+ * \param epoch	[IN]	Epoch of the snapshot read.
+ *
+ * \return		Zero on success.
+ *			-DER_TX_RESTART if aggregation has covered or is
+ *			covering \a epoch, the read must be restarted.
+ */
+int
+vos_cont_snap_read(daos_handle_t coh, daos_epoch_t epoch);
+
 /**
  * Aggregates all epochs within the epoch range \a epr.
  * Data in all these epochs will be aggregated to the last epoch
@@ -538,6 +538,12 @@ typedef struct {
 	daos_epoch_range_t	epr;
 } daos_cont_destroy_snap_t;
 
+/** Container flush args */
+typedef struct {
+	/** Container open handle. */
+	daos_handle_t		coh;
+} daos_cont_flush_t;
+
 /** Transaction Open args */
 typedef struct {
 	/** Container open handle. */
@@ -11,6 +11,7 @@
 #define D_LOGFAC	DD_FAC(object)
 
 #include <daos/common.h>
+#include <daos/container.h>
 #include <daos_task.h>
 #include <daos_types.h>
 #include "obj_rpc.h"
@@ -539,6 +540,309 @@ codec_get(struct obj_reasb_req *reasb_req, daos_obj_id_t oid)
 	return reasb_req->orr_codec;
 }
 
+unsigned int	dc_obj_ec_encode_threads;
+unsigned int	dc_obj_ec_encode_batch = DC_OBJ_EC_ENCODE_BATCH_DEF;
+
+/**
+ * Client EC encoding workers. The full stripes of a large update are split
+ * into batches of dc_obj_ec_encode_batch stripes, which are encoded by the
+ * workers and the caller in parallel. The caller waits for all batches to
+ * be encoded before the parity is used, so without any worker the encoding
+ * is the same as done inline.
+ */
+struct obj_ec_encode_pool {
+	pthread_mutex_t		 eep_lock;
+	/* signaled when a request is queued or the pool is stopped */
+	pthread_cond_t		 eep_work_cond;
+	/* signaled when all stripes of a request are encoded */
+	pthread_cond_t		 eep_done_cond;
+	/* requests with stripes not taken by anyone yet */
+	d_list_t		 eep_reqs;
+	pthread_t		*eep_threads;
+	uint32_t		 eep_thread_nr;
+	bool			 eep_stop;
+};
+
+static struct obj_ec_encode_pool ec_encode_pool;
+
+/** Position of a full stripe in the user sgl */
+struct obj_ec_stripe_pos {
+	uint32_t		 esp_iov_idx;
+	uint64_t		 esp_iov_off;
+};
+
+struct obj_ec_encode_req {
+	d_list_t		 eer_link;
+	struct obj_ec_codec	*eer_codec;
+	struct daos_oclass_attr	*eer_oca;
+	daos_iod_t		*eer_iod;
+	d_sg_list_t		*eer_sgl;
+	struct obj_ec_recx_array *eer_recxs;
+	struct obj_ec_stripe_pos *eer_stripes;
+	uint64_t		 eer_cell_bytes;
+	uint32_t		 eer_stripe_nr;
+	/* the next stripe to be taken */
+	uint32_t		 eer_next;
+	/* number of stripes encoded */
+	uint32_t		 eer_done;
+	/* number of stripes encoded by the workers */
+	uint32_t		 eer_offloaded;
+	int			 eer_rc;
+};
+
+static int
+obj_ec_encode_stripes(struct obj_ec_encode_req *req, uint32_t start,
+		      uint32_t nr)
+{
+	struct obj_ec_stripe_pos *pos;
+	unsigned int		 p = req->eer_oca->u.ec.e_p;
+	unsigned char		*parity_buf[p];
+	uint32_t		 i, m;
+	int			 rc;
+
+	for (i = start; i < start + nr; i++) {
+		pos = &req->eer_stripes[i];
+		for (m = 0; m < p; m++)
+			parity_buf[m] = req->eer_recxs->oer_pbufs[m] +
+					i * req->eer_cell_bytes;
+		rc = obj_ec_stripe_encode(req->eer_iod, req->eer_sgl,
+					  pos->esp_iov_idx, pos->esp_iov_off,
+					  req->eer_codec, req->eer_oca,
+					  req->eer_cell_bytes, parity_buf);
+		if (rc) {
+			D_ERROR("stripe encoding failed rc %d.\n", rc);
+			return rc;
+		}
+	}
+
+	return 0;
+}
+
+/** Take a batch of stripes of @req, called with eep_lock held. */
+static bool
+obj_ec_encode_take(struct obj_ec_encode_req *req, uint32_t *start,
+		   uint32_t *nr)
+{
+	if (req->eer_next >= req->eer_stripe_nr)
+		return false;
+
+	*start = req->eer_next;
+	*nr = min(dc_obj_ec_encode_batch, req->eer_stripe_nr - req->eer_next);
+	req->eer_next += *nr;
+	/* nothing left for the workers */
+	if (req->eer_next == req->eer_stripe_nr)
+		d_list_del_init(&req->eer_link);
+
+	return true;
+}
+
+/** Account the encoded stripes of @req, called with eep_lock held. */
+static void
+obj_ec_encode_done(struct obj_ec_encode_req *req, uint32_t nr, int rc)
+{
+	if (rc != 0 && req->eer_rc == 0)
+		req->eer_rc = rc;
+
+	req->eer_done += nr;
+	if (req->eer_done == req->eer_stripe_nr)
+		pthread_cond_broadcast(&ec_encode_pool.eep_done_cond);
+}
+
+static void *
+obj_ec_encode_worker(void *arg)
+{
+	struct obj_ec_encode_pool	*pool = arg;
+	struct obj_ec_encode_req	*req;
+	uint32_t			 start;
+	uint32_t			 nr;
+	int				 rc;
+
+	D_MUTEX_LOCK(&pool->eep_lock);
+	while (!pool->eep_stop) {
+		if (d_list_empty(&pool->eep_reqs)) {
+			pthread_cond_wait(&pool->eep_work_cond,
+					  &pool->eep_lock);
+			continue;
+		}
+
+		req = d_list_entry(pool->eep_reqs.next,
+				   struct obj_ec_encode_req, eer_link);
+		obj_ec_encode_take(req, &start, &nr);
+		D_MUTEX_UNLOCK(&pool->eep_lock);
+
+		rc = obj_ec_encode_stripes(req, start, nr);
+
+		D_MUTEX_LOCK(&pool->eep_lock);
+		req->eer_offloaded += nr;
+		obj_ec_encode_done(req, nr, rc);
+	}
+	D_MUTEX_UNLOCK(&pool->eep_lock);
+
+	return NULL;
+}
+
+/** Encode the stripes of @req by the workers and the caller. */
+static int
+obj_ec_encode_offload(struct obj_ec_encode_req *req)
+{
+	struct obj_ec_encode_pool	*pool = &ec_encode_pool;
+	uint32_t			 start;
+	uint32_t			 nr;
+	int				 rc;
+
+	D_MUTEX_LOCK(&pool->eep_lock);
+	d_list_add_tail(&req->eer_link, &pool->eep_reqs);
+	pthread_cond_broadcast(&pool->eep_work_cond);
+
+	while (obj_ec_encode_take(req, &start, &nr)) {
+		D_MUTEX_UNLOCK(&pool->eep_lock);
+		rc = obj_ec_encode_stripes(req, start, nr);
+		D_MUTEX_LOCK(&pool->eep_lock);
+		obj_ec_encode_done(req, nr, rc);
+	}
+
+	while (req->eer_done < req->eer_stripe_nr)
+		pthread_cond_wait(&pool->eep_done_cond, &pool->eep_lock);
+	D_MUTEX_UNLOCK(&pool->eep_lock);
+
+	if (obj_ec_cntrs != NULL)
+		__atomic_add_fetch(&obj_ec_cntrs->ecc_offloaded,
+				   req->eer_offloaded, __ATOMIC_RELAXED);
+
+	return req->eer_rc;
+}
+
+int
+obj_ec_encode_pool_init(void)
+{
+	struct obj_ec_encode_pool	*pool = &ec_encode_pool;
+	int				 rc;
+
+	D_INIT_LIST_HEAD(&pool->eep_reqs);
+	pool->eep_thread_nr = 0;
+	pool->eep_stop = false;
+	if (dc_obj_ec_encode_threads == 0)
+		return 0;
+
+	rc = D_MUTEX_INIT(&pool->eep_lock, NULL);
+	if (rc != 0)
+		return rc;
+
+	rc = pthread_cond_init(&pool->eep_work_cond, NULL);
+	if (rc != 0)
+		D_GOTO(out_lock, rc = daos_errno2der(rc));
+
+	rc = pthread_cond_init(&pool->eep_done_cond, NULL);
+	if (rc != 0)
+		D_GOTO(out_work, rc = daos_errno2der(rc));
+
+	D_ALLOC_ARRAY(pool->eep_threads, dc_obj_ec_encode_threads);
+	if (pool->eep_threads == NULL)
+		D_GOTO(out_done, rc = -DER_NOMEM);
+
+	for (; pool->eep_thread_nr < dc_obj_ec_encode_threads;
+	     pool->eep_thread_nr++) {
+		rc = pthread_create(&pool->eep_threads[pool->eep_thread_nr],
+				    NULL, obj_ec_encode_worker, pool);
+		if (rc != 0) {
+			D_ERROR("failed to create EC encoding worker: %d\n",
+				rc);
+			obj_ec_encode_pool_fini();
+			return daos_errno2der(rc);
+		}
+	}
+
+	D_DEBUG(DB_IO, "started %u EC encoding workers\n",
+		pool->eep_thread_nr);
+	return 0;
+
+out_done:
+	pthread_cond_destroy(&pool->eep_done_cond);
+out_work:
+	pthread_cond_destroy(&pool->eep_work_cond);
+out_lock:
+	D_MUTEX_DESTROY(&pool->eep_lock);
+	return rc;
+}
+
+void
+obj_ec_encode_pool_fini(void)
+{
+	struct obj_ec_encode_pool	*pool = &ec_encode_pool;
+	uint32_t			 i;
+
+	if (pool->eep_threads == NULL)
+		return;
+
+	D_MUTEX_LOCK(&pool->eep_lock);
+	pool->eep_stop = true;
+	pthread_cond_broadcast(&pool->eep_work_cond);
+	D_MUTEX_UNLOCK(&pool->eep_lock);
+
+	for (i = 0; i < pool->eep_thread_nr; i++)
+		pthread_join(pool->eep_threads[i], NULL);
+
+	D_ASSERT(d_list_empty(&pool->eep_reqs));
+	D_FREE(pool->eep_threads);
+	pool->eep_thread_nr = 0;
+	pthread_cond_destroy(&pool->eep_done_cond);
+	pthread_cond_destroy(&pool->eep_work_cond);
+	D_MUTEX_DESTROY(&pool->eep_lock);
+}
+
+/**
+ * Locate all full stripes in the user sgl, then encode them by the EC
+ * encoding workers.
+ */
+static int
+obj_ec_recx_encode_offload(struct obj_ec_codec *codec,
+			   struct daos_oclass_attr *oca, daos_iod_t *iod,
+			   d_sg_list_t *sgl,
+			   struct obj_ec_recx_array *recx_array,
+			   uint64_t cell_bytes)
+{
+	struct obj_ec_encode_req req = { 0 };
+	struct obj_ec_recx	*ec_recx;
+	uint64_t		 stripe_bytes = cell_bytes * oca->u.ec.e_k;
+	uint32_t		 iov_idx = 0;
+	uint64_t		 iov_off = 0, last_off = 0;
+	uint32_t		 i, j, n = 0;
+	int			 rc;
+
+	D_ALLOC_ARRAY(req.eer_stripes, recx_array->oer_stripe_total);
+	if (req.eer_stripes == NULL)
+		return -DER_NOMEM;
+
+	for (i = 0; i < recx_array->oer_nr; i++) {
+		ec_recx = &recx_array->oer_recxs[i];
+		daos_sgl_move(sgl, iov_idx, iov_off,
+			      ec_recx->oer_byte_off - last_off);
+		last_off = ec_recx->oer_byte_off;
+		for (j = 0; j < ec_recx->oer_stripe_nr; j++) {
+			D_ASSERT(n < recx_array->oer_stripe_total);
+			req.eer_stripes[n].esp_iov_idx = iov_idx;
+			req.eer_stripes[n].esp_iov_off = iov_off;
+			n++;
+			daos_sgl_move(sgl, iov_idx, iov_off, stripe_bytes);
+			last_off += stripe_bytes;
+		}
+	}
+	D_ASSERT(n == recx_array->oer_stripe_total);
+
+	D_INIT_LIST_HEAD(&req.eer_link);
+	req.eer_codec = codec;
+	req.eer_oca = oca;
+	req.eer_iod = iod;
+	req.eer_sgl = sgl;
+	req.eer_recxs = recx_array;
+	req.eer_cell_bytes = cell_bytes;
+	req.eer_stripe_nr = n;
+
+	rc = obj_ec_encode_offload(&req);
+	D_FREE(req.eer_stripes);
+	return rc;
+}
+
 /**
  * Encode the data in full stripe recx_array, the result parity stored in
  * struct obj_ec_recx_array::oer_pbufs.
@@ -557,11 +861,14 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 	uint32_t		 encoded_nr = 0;
 	uint32_t		 recx_nr, stripe_nr;
 	uint32_t		 i, j, m;
+	uint64_t		 start = 0;
 	bool			 singv;
 	int			 rc = 0;
 
 	if (recx_array->oer_stripe_total == 0)
 		D_GOTO(out, rc = 0);
+	if (obj_ec_cntrs != NULL)
+		start = daos_get_ntime();
 	singv = (iod->iod_type == DAOS_IOD_SINGLE);
 	if (singv) {
 		cell_bytes = obj_ec_singv_cell_bytes(iod->iod_size, oca);
@@ -574,6 +881,14 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 	}
 	stripe_bytes = cell_bytes * oca->u.ec.e_k;
 
+	if (!singv && ec_encode_pool.eep_thread_nr > 0 &&
+	    recx_array->oer_stripe_total > dc_obj_ec_encode_batch) {
+		rc = obj_ec_recx_encode_offload(codec, oca, iod, sgl,
+						recx_array, cell_bytes);
+		encoded_nr = recx_array->oer_stripe_total;
+		goto out;
+	}
+
 	/* calculate EC parity for each full_stripe */
 	for (i = 0; i < recx_nr; i++) {
 		if (singv) {
@@ -601,8 +916,10 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 				D_ERROR("stripe encoding failed rc %d.\n", rc);
 				goto out;
 			}
-			if (singv)
+			if (singv) {
+				encoded_nr = 1;
 				break;
+			}
 			encoded_nr++;
 			daos_sgl_move(sgl, iov_idx, iov_off, stripe_bytes);
 			last_off += stripe_bytes;
@@ -610,6 +927,14 @@ obj_ec_recx_encode(struct obj_ec_codec *codec, struct daos_oclass_attr *oca,
 	}
 
 out:
+	if (rc == 0 && encoded_nr > 0 && obj_ec_cntrs != NULL) {
+		__atomic_add_fetch(&obj_ec_cntrs->ecc_stripes, encoded_nr,
+				   __ATOMIC_RELAXED);
+		__atomic_add_fetch(&obj_ec_cntrs->ecc_bytes,
+				   encoded_nr * stripe_bytes, __ATOMIC_RELAXED);
+		__atomic_add_fetch(&obj_ec_cntrs->ecc_nsec,
+				   daos_get_ntime() - start, __ATOMIC_RELAXED);
+	}
 	return rc;
 }
 
@@ -2209,6 +2534,300 @@ out:
 	return rc;
 }
 
+unsigned int	dc_obj_ec_recov_cache_mb = DC_OBJ_EC_RECOV_CACHE_MB_DEF;
+
+/**
+ * Cache of the full stripes reconstructed by EC degraded fetch, so that hot
+ * stripes are not reconstructed again from all the surviving shards by each
+ * fetch while a target is down. A stripe is keyed by container, object,
+ * dkey, akey, stripe number, record size and the parity epoch it is fetched
+ * at, only its data cells are kept. The content at a fetched epoch never
+ * changes, so entries are never stale, they are evicted in LRU order to keep
+ * the cache within dc_obj_ec_recov_cache_mb.
+ */
+struct obj_ec_recov_cache {
+	pthread_mutex_t		 erc_lock;
+	struct d_hash_table	*erc_htable;
+	/* cached stripes, the most recently used one at head */
+	d_list_t		 erc_lru;
+	uint64_t		 erc_size;
+	uint64_t		 erc_size_max;
+};
+
+static struct obj_ec_recov_cache ec_recov_cache;
+
+#define EC_RCACHE_HASH_BITS	12
+
+struct obj_ec_rcache_key {
+	uuid_t			 erk_cont;
+	daos_obj_id_t		 erk_oid;
+	uint64_t		 erk_stripe;
+	daos_epoch_t		 erk_epoch;
+	uint64_t		 erk_rec_size;
+	uint32_t		 erk_dkey_len;
+	uint32_t		 erk_akey_len;
+	/* followed by dkey and akey */
+	char			 erk_keys[0];
+};
+
+struct obj_ec_rcache_entry {
+	d_list_t		 ere_hlink;
+	d_list_t		 ere_lru;
+	struct obj_ec_rcache_key *ere_key;
+	uint32_t		 ere_ksize;
+	uint64_t		 ere_size;
+	/* data cells of the stripe */
+	void			*ere_buf;
+};
+
+static inline struct obj_ec_rcache_entry *
+ec_rcache_link2entry(d_list_t *link)
+{
+	return container_of(link, struct obj_ec_rcache_entry, ere_hlink);
+}
+
+static bool
+ec_rcache_key_cmp(struct d_hash_table *htable, d_list_t *link,
+		  const void *key, unsigned int ksize)
+{
+	struct obj_ec_rcache_entry *ere = ec_rcache_link2entry(link);
+
+	return ere->ere_ksize == ksize && memcmp(ere->ere_key, key, ksize) == 0;
+}
+
+static uint32_t
+ec_rcache_key_hash(struct d_hash_table *htable, const void *key,
+		   unsigned int ksize)
+{
+	return d_hash_string_u32(key, ksize);
+}
+
+static d_hash_table_ops_t ec_rcache_hops = {
+	.hop_key_cmp	= ec_rcache_key_cmp,
+	.hop_key_hash	= ec_rcache_key_hash,
+};
+
+/** Drop @ere from the cache, called with erc_lock held. */
+static void
+ec_rcache_entry_del(struct obj_ec_recov_cache *cache,
+		    struct obj_ec_rcache_entry *ere)
+{
+	d_hash_rec_delete_at(cache->erc_htable, &ere->ere_hlink);
+	d_list_del(&ere->ere_lru);
+	cache->erc_size -= ere->ere_size;
+	D_FREE(ere);
+}
+
+int
+obj_ec_recov_cache_init(void)
+{
+	struct obj_ec_recov_cache	*cache = &ec_recov_cache;
+	int				 rc;
+
+	D_INIT_LIST_HEAD(&cache->erc_lru);
+	cache->erc_size = 0;
+	cache->erc_size_max = (uint64_t)dc_obj_ec_recov_cache_mb << 20;
+	if (cache->erc_size_max == 0)
+		return 0;
+
+	rc = D_MUTEX_INIT(&cache->erc_lock, NULL);
+	if (rc != 0)
+		return rc;
+
+	rc = d_hash_table_create(D_HASH_FT_NOLOCK, EC_RCACHE_HASH_BITS, NULL,
+				 &ec_rcache_hops, &cache->erc_htable);
+	if (rc != 0) {
+		D_MUTEX_DESTROY(&cache->erc_lock);
+		return rc;
+	}
+
+	return 0;
+}
+
+void
+obj_ec_recov_cache_fini(void)
+{
+	struct obj_ec_recov_cache	*cache = &ec_recov_cache;
+	struct obj_ec_rcache_entry	*ere, *tmp;
+
+	if (cache->erc_htable == NULL)
+		return;
+
+	d_list_for_each_entry_safe(ere, tmp, &cache->erc_lru, ere_lru)
+		ec_rcache_entry_del(cache, ere);
+	D_ASSERT(cache->erc_size == 0);
+	d_hash_table_destroy(cache->erc_htable, true);
+	cache->erc_htable = NULL;
+	D_MUTEX_DESTROY(&cache->erc_lock);
+}
+
+/** Size of the data cells and of the whole stripe in @rtask buffer */
+static void
+ec_rcache_stripe_sz(struct obj_reasb_req *reasb_req,
+		    struct obj_ec_recov_task *rtask, uint64_t *data_sz,
+		    uint64_t *stripe_sz)
+{
+	struct daos_oclass_attr	*oca = reasb_req->orr_oca;
+	uint64_t		 cell_sz;
+
+	cell_sz = obj_ec_cell_rec_nr(oca) * rtask->ert_iod.iod_size;
+	*data_sz = cell_sz * obj_ec_data_tgt_nr(oca);
+	*stripe_sz = cell_sz * obj_ec_tgt_nr(oca);
+}
+
+static struct obj_ec_rcache_key *
+ec_rcache_key_alloc(daos_handle_t coh, daos_obj_id_t oid, daos_key_t *dkey,
+		    struct obj_ec_recov_task *rtask, uint32_t *ksize)
+{
+	struct obj_ec_rcache_key	*key;
+	daos_key_t			*akey = &rtask->ert_iod.iod_name;
+	int				 rc;
+
+	*ksize = sizeof(*key) + dkey->iov_len + akey->iov_len;
+	D_ALLOC(key, *ksize);
+	if (key == NULL)
+		return NULL;
+
+	rc = dc_cont_hdl2uuid(coh, NULL, &key->erk_cont);
+	if (rc != 0) {
+		D_FREE(key);
+		return NULL;
+	}
+	key->erk_oid = oid;
+	key->erk_epoch = rtask->ert_epoch;
+	key->erk_rec_size = rtask->ert_iod.iod_size;
+	key->erk_dkey_len = dkey->iov_len;
+	key->erk_akey_len = akey->iov_len;
+	memcpy(key->erk_keys, dkey->iov_buf, dkey->iov_len);
+	memcpy(&key->erk_keys[dkey->iov_len], akey->iov_buf, akey->iov_len);
+
+	return key;
+}
+
+/**
+ * Fill the stripe buffer of @rtask from the reconstructed stripe cache.
+ * Returns true if all its stripes are cached, then the task doesn't need to
+ * fetch and reconstruct them again.
+ */
+bool
+obj_ec_recov_cache_fill(struct obj_reasb_req *reasb_req, daos_handle_t coh,
+			daos_key_t *dkey, struct obj_ec_recov_task *rtask)
+{
+	struct obj_ec_recov_cache	*cache = &ec_recov_cache;
+	struct obj_ec_rcache_key	*key;
+	struct obj_ec_rcache_entry	*ere;
+	daos_recx_t			*recx = rtask->ert_iod.iod_recxs;
+	d_list_t			*link;
+	void				*buf;
+	uint64_t			 stripe_rec_nr;
+	uint64_t			 data_sz, stripe_sz;
+	uint32_t			 i, stripe_nr;
+	bool				 hit = true;
+
+	if (cache->erc_htable == NULL ||
+	    rtask->ert_iod.iod_type != DAOS_IOD_ARRAY || recx == NULL ||
+	    rtask->ert_iod.iod_size == 0)
+		return false;
+
+	if (rtask->ert_ckey == NULL) {
+		rtask->ert_ckey = ec_rcache_key_alloc(coh, reasb_req->orr_oid,
+						      dkey, rtask,
+						      &rtask->ert_cksize);
+		if (rtask->ert_ckey == NULL)
+			return false;
+	}
+
+	key = rtask->ert_ckey;
+	stripe_rec_nr = obj_ec_stripe_rec_nr(reasb_req->orr_oca);
+	stripe_nr = recx->rx_nr / stripe_rec_nr;
+	ec_rcache_stripe_sz(reasb_req, rtask, &data_sz, &stripe_sz);
+	buf = rtask->ert_sgl.sg_iovs[0].iov_buf;
+
+	D_MUTEX_LOCK(&cache->erc_lock);
+	for (i = 0; i < stripe_nr; i++) {
+		key->erk_stripe = recx->rx_idx / stripe_rec_nr + i;
+		link = d_hash_rec_find(cache->erc_htable, key,
+				       rtask->ert_cksize);
+		if (link == NULL) {
+			hit = false;
+			break;
+		}
+		ere = ec_rcache_link2entry(link);
+		D_ASSERT(ere->ere_size == data_sz);
+		memcpy(buf + i * stripe_sz, ere->ere_buf, data_sz);
+		d_list_move(&ere->ere_lru, &cache->erc_lru);
+	}
+	D_MUTEX_UNLOCK(&cache->erc_lock);
+
+	if (hit) {
+		rtask->ert_cached = 1;
+		obj_ec_recov_cntr_add(erc_cache_hit, stripe_nr);
+		D_DEBUG(DB_IO, DF_OID" %u stripes from EC stripe cache\n",
+			DP_OID(reasb_req->orr_oid), stripe_nr);
+	} else {
+		obj_ec_recov_cntr_add(erc_cache_miss, stripe_nr);
+	}
+
+	return hit;
+}
+
+/** Add the reconstructed stripe @stripe_idx of @rtask to the cache */
+static void
+obj_ec_recov_cache_add(struct obj_reasb_req *reasb_req,
+		       struct obj_ec_recov_task *rtask, uint32_t stripe_idx,
+		       void *stripe_buf)
+{
+	struct obj_ec_recov_cache	*cache = &ec_recov_cache;
+	struct obj_ec_rcache_entry	*ere;
+	uint64_t			 data_sz, stripe_sz;
+	uint64_t			 evicted = 0;
+	int				 rc;
+
+	if (cache->erc_htable == NULL || rtask->ert_ckey == NULL)
+		return;
+
+	ec_rcache_stripe_sz(reasb_req, rtask, &data_sz, &stripe_sz);
+	if (data_sz > cache->erc_size_max)
+		return;
+
+	D_ALLOC(ere, sizeof(*ere) + rtask->ert_cksize + data_sz);
+	if (ere == NULL)
+		return;
+
+	ere->ere_key = (struct obj_ec_rcache_key *)(ere + 1);
+	ere->ere_ksize = rtask->ert_cksize;
+	ere->ere_size = data_sz;
+	ere->ere_buf = (void *)ere->ere_key + ere->ere_ksize;
+	memcpy(ere->ere_key, rtask->ert_ckey, ere->ere_ksize);
+	ere->ere_key->erk_stripe = rtask->ert_iod.iod_recxs->rx_idx /
+				   obj_ec_stripe_rec_nr(reasb_req->orr_oca) +
+				   stripe_idx;
+	memcpy(ere->ere_buf, stripe_buf, data_sz);
+
+	D_MUTEX_LOCK(&cache->erc_lock);
+	rc = d_hash_rec_insert(cache->erc_htable, ere->ere_key, ere->ere_ksize,
+			       &ere->ere_hlink, true);
+	if (rc != 0) {
+		/* cached by another fetch meanwhile */
+		D_MUTEX_UNLOCK(&cache->erc_lock);
+		D_FREE(ere);
+		return;
+	}
+	d_list_add(&ere->ere_lru, &cache->erc_lru);
+	cache->erc_size += data_sz;
+
+	while (cache->erc_size > cache->erc_size_max) {
+		ere = d_list_entry(cache->erc_lru.prev,
+				   struct obj_ec_rcache_entry, ere_lru);
+		ec_rcache_entry_del(cache, ere);
+		evicted++;
+	}
+	D_MUTEX_UNLOCK(&cache->erc_lock);
+
+	if (evicted != 0)
+		obj_ec_recov_cntr_add(erc_cache_evict, evicted);
+}
+
 static void
 obj_ec_recov_task_fini(struct obj_reasb_req *reasb_req)
 {
@@ -2223,6 +2842,7 @@ obj_ec_recov_task_fini(struct obj_reasb_req *reasb_req)
 		d_sgl_fini(&fail_info->efi_recov_tasks[i].ert_sgl, false);
 		if (daos_handle_is_valid(fail_info->efi_recov_tasks[i].ert_th))
 			dc_tx_local_close(fail_info->efi_recov_tasks[i].ert_th);
+		D_FREE(fail_info->efi_recov_tasks[i].ert_ckey);
 	}
 	D_FREE(fail_info->efi_recov_tasks);
 }
@@ -2606,6 +3226,8 @@ obj_ec_recov_data(struct obj_reasb_req *reasb_req, daos_obj_id_t oid,
 	uint64_t			 stripe_rec_nr =
 						obj_ec_stripe_rec_nr(oca);
 	struct daos_recx_ep		*recx_ep;
+	struct obj_ec_recov_task	*rtask;
+	uint32_t			 tidx = 0;
 	bool				 singv;
 
 	for (i = 0; i < iod_nr; i++) {
@@ -2633,6 +3255,8 @@ obj_ec_recov_data(struct obj_reasb_req *reasb_req, daos_obj_id_t oid,
 		buf_stripe = stripe_sgl->sg_iovs[0].iov_buf;
 		recx_nr = singv ? 1 : stripe_list->re_nr;
 		for (j = 0; j < recx_nr; j++) {
+			D_ASSERT(tidx < fail_info->efi_recov_ntasks);
+			rtask = &fail_info->efi_recov_tasks[tidx++];
 			if (singv) {
 				stripe_nr = 1;
 				if (obj_ec_singv_one_tgt(iod->iod_size,
@@ -2643,11 +3267,19 @@ obj_ec_recov_data(struct obj_reasb_req *reasb_req, daos_obj_id_t oid,
 				stripe_nr = recx_ep->re_recx.rx_nr /
 					    stripe_rec_nr;
 			}
+			if (rtask->ert_cached) {
+				/* data cells filled from the stripe cache */
+				buf_stripe += stripe_total_sz * stripe_nr;
+				continue;
+			}
 			for (sidx = 0; sidx < stripe_nr; sidx++) {
 				obj_ec_recov_stripe(codec, oca, buf_stripe,
 						    cell_sz);
+				obj_ec_recov_cache_add(reasb_req, rtask, sidx,
+						       buf_stripe);
 				buf_stripe += stripe_total_sz;
 			}
+			obj_ec_recov_cntr_add(erc_stripes, stripe_nr);
 		}
 		obj_ec_recov_fill_back(iod, sgl, recov_list, stripe_list,
 				       stripe_sgl, stripe_total_sz,
@@ -35,6 +35,31 @@ dc_obj_init(void)
 		D_DEBUG(DB_IO, "Full dtx mode by default\n");
 	}
 
+	d_getenv_int("DAOS_WCOMB_MAX_REQS", &dc_tx_wcq_max_reqs);
+	d_getenv_int("DAOS_WCOMB_MAX_SIZE", &dc_tx_wcq_max_size);
+	d_getenv_int("DAOS_WCOMB_DELAY", &dc_tx_wcq_delay);
+	D_DEBUG(DB_IO, "Write combining: max reqs %u, max size %u, delay %u\n",
+		dc_tx_wcq_max_reqs, dc_tx_wcq_max_size, dc_tx_wcq_delay);
+
+	d_getenv_int("DAOS_LAYOUT_CACHE_BITS", &dc_obj_layout_cache_bits);
+	if (dc_obj_layout_cache_bits > DC_OBJ_LAYOUT_CACHE_BITS_MAX)
+		dc_obj_layout_cache_bits = DC_OBJ_LAYOUT_CACHE_BITS_MAX;
+	D_DEBUG(DB_IO, "Object layout cache bits %u\n",
+		dc_obj_layout_cache_bits);
+
+	d_getenv_int("DAOS_EC_ENCODE_THREADS", &dc_obj_ec_encode_threads);
+	if (dc_obj_ec_encode_threads > DC_OBJ_EC_ENCODE_THREADS_MAX)
+		dc_obj_ec_encode_threads = DC_OBJ_EC_ENCODE_THREADS_MAX;
+	d_getenv_int("DAOS_EC_ENCODE_BATCH", &dc_obj_ec_encode_batch);
+	if (dc_obj_ec_encode_batch == 0)
+		dc_obj_ec_encode_batch = DC_OBJ_EC_ENCODE_BATCH_DEF;
+	D_DEBUG(DB_IO, "EC encoding: threads %u, batch %u stripes\n",
+		dc_obj_ec_encode_threads, dc_obj_ec_encode_batch);
+
+	d_getenv_int("DAOS_EC_RECOV_CACHE_MB", &dc_obj_ec_recov_cache_mb);
+	D_DEBUG(DB_IO, "EC reconstructed stripe cache %u MiB\n",
+		dc_obj_ec_recov_cache_mb);
+
 	rc = obj_utils_init();
 	if (rc)
 		D_GOTO(out, rc);
@@ -58,6 +83,25 @@ dc_obj_init(void)
 		D_GOTO(out_class, rc);
 	}
 
+	rc = obj_ec_encode_pool_init();
+	if (rc) {
+		D_ERROR("failed to start EC encoding workers: "DF_RC"\n",
+			DP_RC(rc));
+		obj_ec_codec_fini();
+		daos_rpc_unregister(&obj_proto_fmt);
+		D_GOTO(out_class, rc);
+	}
+
+	rc = obj_ec_recov_cache_init();
+	if (rc) {
+		D_ERROR("failed to init EC reconstructed stripe cache: "
+			DF_RC"\n", DP_RC(rc));
+		obj_ec_encode_pool_fini();
+		obj_ec_codec_fini();
+		daos_rpc_unregister(&obj_proto_fmt);
+		D_GOTO(out_class, rc);
+	}
+
 	D_GOTO(out, rc = 0);
 
 out_class:
@@ -75,6 +119,8 @@ void
 dc_obj_fini(void)
 {
 	daos_rpc_unregister(&obj_proto_fmt);
+	obj_ec_recov_cache_fini();
+	obj_ec_encode_pool_fini();
 	obj_ec_codec_fini();
 	obj_class_fini();
 	obj_utils_fini();
@@ -12,6 +12,7 @@
 
 #include <daos/object.h>
 #include <daos/container.h>
+#include <daos/lru.h>
 #include <daos/cont_props.h>
 #include <daos/pool.h>
 #include <daos/task.h>
@@ -116,6 +117,14 @@ struct obj_auxi_args {
 
 /** DAOS metrics obj rpc counters */
 daos_metrics_cntr_t   *obj_rpc_cntrs;
+/** DAOS metrics obj layout cache counters */
+static daos_metrics_obj_layout_cntrs_t *obj_layout_cntrs;
+/** DAOS metrics obj EC encoding counters */
+daos_metrics_obj_ec_cntrs_t *obj_ec_cntrs;
+/** DAOS metrics obj EC degraded fetch counters */
+daos_metrics_obj_ec_recov_cntrs_t *obj_ec_recov_cntrs;
+
+unsigned int	dc_obj_layout_cache_bits = DC_OBJ_LAYOUT_CACHE_BITS_DEF;
 
 /**
  * task memory space should enough to use -
@@ -232,6 +241,8 @@ obj_free(struct d_hlink *hlink)
 	obj_layout_free(obj);
 	if (obj->cob_time_fetch_leader != NULL)
 		D_FREE(obj->cob_time_fetch_leader);
+	if (obj->cob_time_degraded != NULL)
+		D_FREE(obj->cob_time_degraded);
 	D_SPIN_DESTROY(&obj->cob_spin);
 	D_RWLOCK_DESTROY(&obj->cob_lock);
 	D_FREE(obj);
@@ -305,15 +316,223 @@ dc_obj_hdl2cont_hdl(daos_handle_t oh)
 	return hdl;
 }
 
+/**
+ * Object layouts are cached per container and keyed by object ID and pool
+ * map version, so opening the same object again does not recalculate its
+ * placement. The cache is bounded by dc_obj_layout_cache_bits, and all the
+ * cached layouts are dropped when a newer pool map version is seen.
+ */
+struct dc_obj_layout_cache {
+	pthread_mutex_t		 olc_lock;
+	struct daos_lru_cache	*olc_lru;
+	/* the latest pool map version of the cached layouts */
+	uint32_t		 olc_map_ver;
+};
+
+struct obj_layout_key {
+	daos_obj_id_t		 olk_oid;
+	uint32_t		 olk_ver;
+	uint32_t		 olk_padding;
+};
+
+struct obj_layout_entry {
+	struct daos_llink	 ole_llink;
+	struct obj_layout_key	 ole_key;
+	struct pl_obj_layout	*ole_layout;
+};
+
+#define obj_layout_cntr_add(cntr, val)					\
+	do {								\
+		if (obj_layout_cntrs != NULL)				\
+			__atomic_add_fetch(&obj_layout_cntrs->cntr, val,\
+					   __ATOMIC_RELAXED);		\
+	} while (0)
+
+static int
+obj_layout_lop_alloc(void *key, unsigned int ksize, void *args,
+		     struct daos_llink **llink_p)
+{
+	struct pl_obj_layout	*src = args;
+	struct obj_layout_entry	*ole;
+	int			 rc;
+
+	D_ALLOC_PTR(ole);
+	if (ole == NULL)
+		return -DER_NOMEM;
+
+	/* copy the layout, so the caller always owns the one it passed in */
+	rc = pl_obj_layout_alloc(src->ol_grp_size, src->ol_grp_nr,
+				 &ole->ole_layout);
+	if (rc != 0) {
+		D_FREE(ole);
+		return rc;
+	}
+
+	ole->ole_layout->ol_ver = src->ol_ver;
+	memcpy(ole->ole_layout->ol_shards, src->ol_shards,
+	       sizeof(*src->ol_shards) * src->ol_nr);
+	ole->ole_key = *(struct obj_layout_key *)key;
+	*llink_p = &ole->ole_llink;
+
+	return 0;
+}
+
+static bool
+obj_layout_lop_cmp_key(const void *key, unsigned int ksize,
+		       struct daos_llink *llink)
+{
+	struct obj_layout_entry	*ole;
+
+	D_ASSERT(ksize == sizeof(struct obj_layout_key));
+
+	ole = container_of(llink, struct obj_layout_entry, ole_llink);
+	return memcmp(key, &ole->ole_key, sizeof(ole->ole_key)) == 0;
+}
+
+static uint32_t
+obj_layout_lop_rec_hash(struct daos_llink *llink)
+{
+	struct obj_layout_entry	*ole;
+
+	ole = container_of(llink, struct obj_layout_entry, ole_llink);
+	return d_hash_string_u32((const char *)&ole->ole_key,
+				 sizeof(ole->ole_key));
+}
+
+static void
+obj_layout_lop_free(struct daos_llink *llink)
+{
+	struct obj_layout_entry	*ole;
+
+	ole = container_of(llink, struct obj_layout_entry, ole_llink);
+	pl_obj_layout_free(ole->ole_layout);
+	D_FREE(ole);
+}
+
+static struct daos_llink_ops obj_layout_lru_ops = {
+	.lop_free_ref	= obj_layout_lop_free,
+	.lop_alloc_ref	= obj_layout_lop_alloc,
+	.lop_cmp_keys	= obj_layout_lop_cmp_key,
+	.lop_rec_hash	= obj_layout_lop_rec_hash,
+};
+
+int
+dc_obj_layout_cache_create(struct dc_obj_layout_cache **cache_p)
+{
+	struct dc_obj_layout_cache	*cache;
+	int				 rc;
+
+	*cache_p = NULL;
+	if (dc_obj_layout_cache_bits == 0)
+		return 0;
+
+	D_ALLOC_PTR(cache);
+	if (cache == NULL)
+		return -DER_NOMEM;
+
+	rc = D_MUTEX_INIT(&cache->olc_lock, NULL);
+	if (rc != 0)
+		goto free;
+
+	rc = daos_lru_cache_create(dc_obj_layout_cache_bits, D_HASH_FT_NOLOCK,
+				   &obj_layout_lru_ops, &cache->olc_lru);
+	if (rc != 0) {
+		D_ERROR("Failed to create object layout cache: "DF_RC"\n",
+			DP_RC(rc));
+		D_MUTEX_DESTROY(&cache->olc_lock);
+		goto free;
+	}
+
+	*cache_p = cache;
+	return 0;
+free:
+	D_FREE(cache);
+	return rc;
+}
+
+void
+dc_obj_layout_cache_destroy(struct dc_obj_layout_cache *cache)
+{
+	if (cache == NULL)
+		return;
+
+	daos_lru_cache_destroy(cache->olc_lru);
+	D_MUTEX_DESTROY(&cache->olc_lock);
+	D_FREE(cache);
+}
+
+static bool
+obj_layout_cache_stale_cond(struct daos_llink *llink, void *arg)
+{
+	struct obj_layout_entry	*ole;
+
+	ole = container_of(llink, struct obj_layout_entry, ole_llink);
+	return ole->ole_key.olk_ver < *(uint32_t *)arg;
+}
+
+/**
+ * Find the cached layout of the object with the pool map version in its
+ * metadata, or insert @layout into the cache if it is not NULL. The cached
+ * layout is held until obj_layout_cache_release().
+ */
+static int
+obj_layout_cache_hold(struct dc_obj_layout_cache *cache,
+		      struct daos_obj_md *md, struct pl_obj_layout *layout,
+		      struct obj_layout_entry **ole_p)
+{
+	struct obj_layout_key	 key = { 0 };
+	struct daos_llink	*llink;
+	uint32_t		 count;
+	int			 rc;
+
+	key.olk_oid = md->omd_id;
+	key.olk_ver = md->omd_ver;
+
+	D_MUTEX_LOCK(&cache->olc_lock);
+	if (cache->olc_map_ver < key.olk_ver) {
+		/* pool map has been refreshed, drop the stale layouts */
+		count = cache->olc_lru->dlc_count;
+		daos_lru_cache_evict(cache->olc_lru,
+				     obj_layout_cache_stale_cond,
+				     &key.olk_ver);
+		cache->olc_map_ver = key.olk_ver;
+		obj_layout_cntr_add(lcc_inval,
+				    count - cache->olc_lru->dlc_count);
+	} else if (cache->olc_map_ver > key.olk_ver) {
+		/* racing with a pool map refresh, do not cache it */
+		D_GOTO(out, rc = -DER_NONEXIST);
+	}
+
+	rc = daos_lru_ref_hold(cache->olc_lru, &key, sizeof(key), layout,
+			       &llink);
+	if (rc == 0)
+		*ole_p = container_of(llink, struct obj_layout_entry,
+				      ole_llink);
+out:
+	D_MUTEX_UNLOCK(&cache->olc_lock);
+	return rc;
+}
+
+static void
+obj_layout_cache_release(struct dc_obj_layout_cache *cache,
+			 struct obj_layout_entry *ole)
+{
+	D_MUTEX_LOCK(&cache->olc_lock);
+	daos_lru_ref_release(cache->olc_lru, &ole->ole_llink);
+	D_MUTEX_UNLOCK(&cache->olc_lock);
+}
+
 static int
 obj_layout_create(struct dc_object *obj, bool refresh)
 {
-	struct pl_obj_layout	*layout = NULL;
-	struct dc_pool		*pool;
-	struct pl_map		*map;
-	uint32_t		old;
-	int			i;
-	int			rc;
+	struct dc_obj_layout_cache	*cache = NULL;
+	struct obj_layout_entry		*ole = NULL;
+	struct pl_obj_layout		*layout = NULL;
+	struct dc_pool			*pool;
+	struct pl_map			*map;
+	uint32_t			 old;
+	int				 i;
+	int				 rc;
 
 	pool = dc_hdl2pool(dc_cont_hdl2pool_hdl(obj->cob_coh));
 	if (pool == NULL) {
@@ -321,15 +540,23 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 		D_GOTO(out, rc = -DER_NO_HDL);
 	}
 
+	obj->cob_md.omd_ver = dc_pool_get_version(pool);
+	cache = dc_cont_hdl2layout_cache(obj->cob_coh);
+	if (cache != NULL &&
+	    obj_layout_cache_hold(cache, &obj->cob_md, NULL, &ole) == 0) {
+		dc_pool_put(pool);
+		obj_layout_cntr_add(lcc_hit, 1);
+		layout = ole->ole_layout;
+		D_GOTO(cached, rc = 0);
+	}
+
 	map = pl_map_find(pool->dp_pool, obj->cob_md.omd_id);
+	dc_pool_put(pool);
 	if (map == NULL) {
 		D_DEBUG(DB_PL, "Cannot find valid placement map\n");
-		dc_pool_put(pool);
 		D_GOTO(out, rc = -DER_INVAL);
 	}
 
-	obj->cob_md.omd_ver = dc_pool_get_version(pool);
-	dc_pool_put(pool);
 	rc = pl_obj_place(map, &obj->cob_md, NULL, &layout);
 	pl_map_decref(map);
 	if (rc != 0) {
@@ -338,6 +565,18 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 	}
 	D_DEBUG(DB_PL, "Place object on %d targets ver %d\n", layout->ol_nr,
 		layout->ol_ver);
+
+	if (cache != NULL) {
+		obj_layout_cntr_add(lcc_miss, 1);
+		/* the cache keeps its own copy, failing to cache is fine */
+		if (layout->ol_nr <= DC_OBJ_LAYOUT_CACHE_SHARDS_MAX &&
+		    obj_layout_cache_hold(cache, &obj->cob_md, layout,
+					  &ole) == 0) {
+			pl_obj_layout_free(layout);
+			layout = ole->ole_layout;
+		}
+	}
+cached:
 	D_ASSERT(layout->ol_nr == layout->ol_grp_size * layout->ol_grp_nr);
 
 	if (refresh)
@@ -366,6 +605,15 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 			D_GOTO(out, rc = -DER_NOMEM);
 	}
 
+	if (obj->cob_grp_size > 1 && old < obj->cob_grp_nr) {
+		if (obj->cob_time_degraded != NULL)
+			D_FREE(obj->cob_time_degraded);
+
+		D_ALLOC_ARRAY(obj->cob_time_degraded, obj->cob_shards_nr);
+		if (obj->cob_time_degraded == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+	}
+
 	for (i = 0; i < layout->ol_nr; i++) {
 		struct dc_obj_shard *obj_shard;
 
@@ -376,7 +624,9 @@ obj_layout_create(struct dc_object *obj, bool refresh)
 		obj_shard->do_rebuilding = layout->ol_shards[i].po_rebuilding;
 	}
 out:
-	if (layout)
+	if (ole != NULL)
+		obj_layout_cache_release(cache, ole);
+	else if (layout)
 		pl_obj_layout_free(layout);
 	return rc;
 }
@@ -513,14 +763,43 @@ obj_get_grp_size(struct dc_object *obj)
 }
 
 /* Get a valid shard from an object group */
+/*
+ * If a shard is reported as on a degrading target (see ORRF_TGT_DEGRADED)
+ * within the OBJ_DEGRADED_INTERVAL (in seconds), then the fetch will prefer
+ * other healthy replicas in the same redundancy group.
+ */
+#define		OBJ_DEGRADED_INTERVAL	10
+
+void
+obj_shard_degraded_set(struct dc_object *obj, unsigned int shard)
+{
+	D_RWLOCK_RDLOCK(&obj->cob_lock);
+	if (obj->cob_time_degraded != NULL && shard < obj->cob_shards_nr) {
+		D_DEBUG(DB_IO, DF_OID" shard %u is on degrading target\n",
+			DP_OID(obj->cob_md.omd_id), shard);
+		daos_gettime_coarse(&obj->cob_time_degraded[shard]);
+	}
+	D_RWLOCK_UNLOCK(&obj->cob_lock);
+}
+
+static bool
+obj_shard_is_degraded(struct dc_object *obj, int shard, uint64_t now)
+{
+	return obj->cob_time_degraded != NULL &&
+	       obj->cob_time_degraded[shard] != 0 &&
+	       OBJ_DEGRADED_INTERVAL >= now - obj->cob_time_degraded[shard];
+}
+
 static int
 obj_grp_valid_shard_get(struct dc_object *obj, int grp_idx,
 			unsigned int map_ver,
 			struct obj_auxi_tgt_list *failed_list)
 {
+	uint64_t now = 0;
 	int grp_start;
 	int idx;
 	int grp_size;
+	int degraded = -1;
 	int i = 0;
 
 	grp_size = obj_get_grp_size(obj);
@@ -568,17 +847,31 @@ obj_grp_valid_shard_get(struct dc_object *obj, int grp_idx,
 			continue;
 
 		/* Skip the invalid shards and targets */
-		if (obj->cob_shards->do_shards[index].do_target_id != -1 ||
-		    obj->cob_shards->do_shards[index].do_shard != -1) {
-			idx = index;
-			break;
+		if (obj->cob_shards->do_shards[index].do_target_id == -1 &&
+		    obj->cob_shards->do_shards[index].do_shard == -1)
+			continue;
+
+		/* Prefer the replicas on healthy targets */
+		if (obj->cob_time_degraded != NULL && now == 0)
+			daos_gettime_coarse(&now);
+		if (obj_shard_is_degraded(obj, index, now)) {
+			if (degraded == -1)
+				degraded = index;
+			continue;
 		}
+
+		idx = index;
+		break;
 	}
 
 	D_RWLOCK_UNLOCK(&obj->cob_lock);
 
-	if (i == grp_size)
-		return -DER_NONEXIST;
+	if (i == grp_size) {
+		if (degraded == -1)
+			return -DER_NONEXIST;
+		/* All valid replicas are degrading, use the first one. */
+		idx = degraded;
+	}
 
 	return idx;
 }
@@ -1651,6 +1944,7 @@ obj_ec_recov_cb(tse_task_t *task, struct dc_object *obj,
 
 	D_ASSERT(fail_info->efi_recov_ntasks > 0 &&
 		 fail_info->efi_recov_tasks != NULL);
+	obj_ec_recov_cntr_add(erc_fetches, 1);
 	D_INIT_LIST_HEAD(&task_list);
 	for (i = 0; i < fail_info->efi_recov_ntasks; i++) {
 		recov_task = &fail_info->efi_recov_tasks[i];
@@ -1660,6 +1954,11 @@ obj_ec_recov_cb(tse_task_t *task, struct dc_object *obj,
 		 */
 		if (recov_task->ert_epoch == DAOS_EPOCH_MAX)
 			recov_task->ert_epoch = crt_hlc_get();
+		/* stripes reconstructed by earlier degraded fetch */
+		if (recov_task->ert_cached ||
+		    obj_ec_recov_cache_fill(reasb_req, coh, args->dkey,
+					    recov_task))
+			continue;
 		rc = dc_tx_local_open(coh, recov_task->ert_epoch, 0, &th);
 		if (rc) {
 			D_ERROR("task %p "DF_OID" dc_tx_local_open failed "
@@ -4462,6 +4761,11 @@ dc_obj_update_task(tse_task_t *task)
 		goto comp;
 	}
 
+	/* combine small update with others for the same target */
+	rc = dc_tx_wcq_attach(obj, map_ver, task);
+	if (rc != 0)
+		goto comp;
+
 	/* submit the update */
 	return dc_obj_update(task, &epoch, map_ver, args, obj);
 comp:
@@ -5748,6 +6052,24 @@ dc_obj_metrics_init()
 	if (obj_rpc_cntrs == NULL) {
 		D_GOTO(out, rc = -DER_NOMEM);
 	}
+	D_ALLOC_PTR(obj_layout_cntrs);
+	if (obj_layout_cntrs == NULL) {
+		D_FREE(obj_rpc_cntrs);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+	D_ALLOC_PTR(obj_ec_cntrs);
+	if (obj_ec_cntrs == NULL) {
+		D_FREE(obj_layout_cntrs);
+		D_FREE(obj_rpc_cntrs);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
+	D_ALLOC_PTR(obj_ec_recov_cntrs);
+	if (obj_ec_recov_cntrs == NULL) {
+		D_FREE(obj_ec_cntrs);
+		D_FREE(obj_layout_cntrs);
+		D_FREE(obj_rpc_cntrs);
+		D_GOTO(out, rc = -DER_NOMEM);
+	}
 out:
 	return rc;
 }
@@ -5755,10 +6077,74 @@ out:
 void
 dc_obj_metrics_fini()
 {
+	D_FREE(obj_ec_recov_cntrs);
+	D_FREE(obj_ec_cntrs);
+	D_FREE(obj_layout_cntrs);
 	D_FREE(obj_rpc_cntrs);
 	return;
 }
 
+int
+dc_obj_metrics_get_layout_cntrs(daos_metrics_obj_layout_cntrs_t *cntrs)
+{
+	int rc = 0;
+
+	if (obj_layout_cntrs == NULL) {
+		D_GOTO(out, rc = -DER_UNINIT);
+	}
+	cntrs->lcc_hit = __atomic_load_n(&obj_layout_cntrs->lcc_hit,
+					__ATOMIC_RELAXED);
+	cntrs->lcc_miss = __atomic_load_n(&obj_layout_cntrs->lcc_miss,
+					__ATOMIC_RELAXED);
+	cntrs->lcc_inval = __atomic_load_n(&obj_layout_cntrs->lcc_inval,
+					__ATOMIC_RELAXED);
+out:
+	return rc;
+}
+
+int
+dc_obj_metrics_get_ec_cntrs(daos_metrics_obj_ec_cntrs_t *cntrs)
+{
+	int rc = 0;
+
+	if (obj_ec_cntrs == NULL) {
+		D_GOTO(out, rc = -DER_UNINIT);
+	}
+	cntrs->ecc_stripes = __atomic_load_n(&obj_ec_cntrs->ecc_stripes,
+					     __ATOMIC_RELAXED);
+	cntrs->ecc_offloaded = __atomic_load_n(&obj_ec_cntrs->ecc_offloaded,
+					       __ATOMIC_RELAXED);
+	cntrs->ecc_bytes = __atomic_load_n(&obj_ec_cntrs->ecc_bytes,
+					   __ATOMIC_RELAXED);
+	cntrs->ecc_nsec = __atomic_load_n(&obj_ec_cntrs->ecc_nsec,
+					  __ATOMIC_RELAXED);
+out:
+	return rc;
+}
+
+int
+dc_obj_metrics_get_ec_recov_cntrs(daos_metrics_obj_ec_recov_cntrs_t *cntrs)
+{
+	daos_metrics_obj_ec_recov_cntrs_t	*c = obj_ec_recov_cntrs;
+	int					 rc = 0;
+
+	if (c == NULL) {
+		D_GOTO(out, rc = -DER_UNINIT);
+	}
+	cntrs->erc_fetches = __atomic_load_n(&c->erc_fetches,
+					     __ATOMIC_RELAXED);
+	cntrs->erc_stripes = __atomic_load_n(&c->erc_stripes,
+					     __ATOMIC_RELAXED);
+	cntrs->erc_cache_hit = __atomic_load_n(&c->erc_cache_hit,
+					       __ATOMIC_RELAXED);
+	cntrs->erc_cache_miss = __atomic_load_n(&c->erc_cache_miss,
+						__ATOMIC_RELAXED);
+	cntrs->erc_cache_evict = __atomic_load_n(&c->erc_cache_evict,
+						 __ATOMIC_RELAXED);
+out:
+	return rc;
+}
+
 int
 dc_obj_metrics_get_rpccntrs(daos_metrics_obj_rpc_cntrs_t *cntrs)
 {
@@ -5796,6 +6182,36 @@ dc_obj_metrics_reset()
 	{
 		dc_metrics_clr_cntr(&obj_rpc_cntrs[i]);
 	}
+	if (obj_layout_cntrs != NULL) {
+		__atomic_store_n(&obj_layout_cntrs->lcc_hit, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_layout_cntrs->lcc_miss, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_layout_cntrs->lcc_inval, 0,
+				 __ATOMIC_RELAXED);
+	}
+	if (obj_ec_cntrs != NULL) {
+		__atomic_store_n(&obj_ec_cntrs->ecc_stripes, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_cntrs->ecc_offloaded, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_cntrs->ecc_bytes, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_cntrs->ecc_nsec, 0,
+				 __ATOMIC_RELAXED);
+	}
+	if (obj_ec_recov_cntrs != NULL) {
+		__atomic_store_n(&obj_ec_recov_cntrs->erc_fetches, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_recov_cntrs->erc_stripes, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_recov_cntrs->erc_cache_hit, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_recov_cntrs->erc_cache_miss, 0,
+				 __ATOMIC_RELAXED);
+		__atomic_store_n(&obj_ec_recov_cntrs->erc_cache_evict, 0,
+				 __ATOMIC_RELAXED);
+	}
 out:
 	return rc;
 }
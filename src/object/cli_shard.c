@@ -799,6 +799,9 @@ dc_rw_cb(tse_task_t *task, void *arg)
 	}
 
 	rc = obj_reply_get_status(rw_args->rpc);
+	if (opc == DAOS_OBJ_RPC_FETCH && orwo->orw_flags & ORRF_TGT_DEGRADED)
+		obj_shard_degraded_set(rw_args->shard_args->auxi.obj,
+				       rw_args->shard_args->auxi.shard);
 	/*
 	 * orwo->orw_epoch may be set even when the status is nonzero (e.g.,
 	 * -DER_TX_RESTART and -DER_INPROGRESS).
@@ -1121,6 +1124,8 @@ dc_obj_shard_rw(struct dc_obj_shard *shard, enum obj_rpc_opc opc,
 
 	if (auxi->epoch.oe_flags & DTX_EPOCH_UNCERTAIN)
 		flags |= ORF_EPOCH_UNCERTAIN;
+	if (auxi->epoch.oe_flags & DTX_EPOCH_SNAP_READ)
+		flags |= ORF_SNAP_READ;
 
 	rc = dc_cont_hdl2uuid(shard->do_co_hdl, &cont_hdl_uuid, &cont_uuid);
 	if (rc != 0)
@@ -1786,13 +1791,15 @@ dc_obj_shard_list(struct dc_obj_shard *obj_shard, enum obj_rpc_opc opc,
 	oei->oei_map_ver	= args->la_auxi.map_ver;
 	if (args->la_auxi.epoch.oe_flags & DTX_EPOCH_UNCERTAIN)
 		oei->oei_flags |= ORF_EPOCH_UNCERTAIN;
+	if (args->la_auxi.epoch.oe_flags & DTX_EPOCH_SNAP_READ)
+		oei->oei_flags |= ORF_SNAP_READ;
 	if (obj_args->eprs != NULL && opc == DAOS_OBJ_RPC_ENUMERATE) {
 		oei->oei_epr = *obj_args->eprs;
 		/*
 		 * If an epoch range is specified, we shall not assume any
 		 * epoch uncertainty.
 		 */
-		oei->oei_flags &= ~ORF_EPOCH_UNCERTAIN;
+		oei->oei_flags &= ~(ORF_EPOCH_UNCERTAIN | ORF_SNAP_READ);
 	} else {
 		/*
 		 * Note that we reuse oei_epr as "epoch_first" and "epoch" to
@@ -2216,6 +2223,8 @@ dc_obj_shard_query_key(struct dc_obj_shard *shard, struct dtx_epoch *epoch,
 		okqi->okqi_akey		= *akey;
 	if (epoch->oe_flags & DTX_EPOCH_UNCERTAIN)
 		okqi->okqi_flags	= ORF_EPOCH_UNCERTAIN;
+	if (epoch->oe_flags & DTX_EPOCH_SNAP_READ)
+		okqi->okqi_flags	|= ORF_SNAP_READ;
 	if (obj_is_ec(obj))
 		okqi->okqi_flags	|= ORF_EC;
 	uuid_copy(okqi->okqi_pool_uuid, pool->dp_pool);
@@ -226,7 +226,11 @@ struct obj_ec_recov_task {
 	d_sg_list_t		ert_sgl;
 	daos_epoch_t		ert_epoch;
 	daos_handle_t		ert_th;		/* read-only tx handle */
-	uint32_t		ert_snapshot:1;	/* For snapshot flag */
+	/* key of the stripes in the reconstructed stripe cache */
+	struct obj_ec_rcache_key *ert_ckey;
+	uint32_t		ert_cksize;
+	uint32_t		ert_snapshot:1,	/* For snapshot flag */
+				ert_cached:1;	/* served by stripe cache */
 };
 
 /** EC obj IO failure information */
@@ -676,6 +680,13 @@ obj_ec_parity_lists_match(struct daos_recx_ep_list *lists_1,
 }
 
 /* cli_ec.c */
+int obj_ec_encode_pool_init(void);
+void obj_ec_encode_pool_fini(void);
+int obj_ec_recov_cache_init(void);
+void obj_ec_recov_cache_fini(void);
+bool obj_ec_recov_cache_fill(struct obj_reasb_req *reasb_req,
+			     daos_handle_t coh, daos_key_t *dkey,
+			     struct obj_ec_recov_task *rtask);
 int obj_ec_req_reasb(daos_iod_t *iods, d_sg_list_t *sgls, daos_obj_id_t oid,
 		     struct daos_oclass_attr *oca,
 		     struct obj_reasb_req *reasb_req,
@@ -46,6 +46,54 @@ extern bool	cli_bypass_rpc;
 /** Switch of server-side IO dispatch */
 extern unsigned int	srv_io_mode;
 
+/** Default limits of the client write-combining queue */
+#define DC_TX_WCQ_MAX_REQS_DEF	16
+#define DC_TX_WCQ_MAX_SIZE_DEF	(32 << 10)
+#define DC_TX_WCQ_DELAY_DEF	500	/* usecs */
+
+/** Max updates combined into one CPD RPC, 0 or 1 disables combining */
+extern unsigned int	dc_tx_wcq_max_reqs;
+/** Max data size (in bytes) combined into one CPD RPC */
+extern unsigned int	dc_tx_wcq_max_size;
+/** How long (in usecs) the first update waits for others to combine */
+extern unsigned int	dc_tx_wcq_delay;
+
+/** Default and max size bits of the per container object layout cache */
+#define DC_OBJ_LAYOUT_CACHE_BITS_DEF	10
+#define DC_OBJ_LAYOUT_CACHE_BITS_MAX	20
+/** Layouts with more shards are not cached to bound the cache memory */
+#define DC_OBJ_LAYOUT_CACHE_SHARDS_MAX	256
+
+/** power2(bits) layouts are cached per container, 0 disables the cache */
+extern unsigned int	dc_obj_layout_cache_bits;
+
+/** Default number of full stripes per EC encoding batch */
+#define DC_OBJ_EC_ENCODE_BATCH_DEF	8
+/** Max number of client EC encoding workers */
+#define DC_OBJ_EC_ENCODE_THREADS_MAX	64
+
+/** Number of client EC encoding workers, 0 means encoding inline */
+extern unsigned int	dc_obj_ec_encode_threads;
+/** Number of full stripes encoded by a worker at a time */
+extern unsigned int	dc_obj_ec_encode_batch;
+/** DAOS metrics obj EC encoding counters, NULL if metrics is disabled */
+extern daos_metrics_obj_ec_cntrs_t *obj_ec_cntrs;
+
+/** Default memory budget in MiB of the reconstructed EC stripe cache */
+#define DC_OBJ_EC_RECOV_CACHE_MB_DEF	64
+
+/** Memory budget of the reconstructed EC stripe cache, 0 disables it */
+extern unsigned int	dc_obj_ec_recov_cache_mb;
+/** DAOS metrics obj EC degraded fetch counters, NULL if metrics is disabled */
+extern daos_metrics_obj_ec_recov_cntrs_t *obj_ec_recov_cntrs;
+
+#define obj_ec_recov_cntr_add(cntr, val)				\
+	do {								\
+		if (obj_ec_recov_cntrs != NULL)				\
+			__atomic_add_fetch(&obj_ec_recov_cntrs->cntr,	\
+					   val, __ATOMIC_RELAXED);	\
+	} while (0)
+
 /** client object shard */
 struct dc_obj_shard {
 	/** refcount */
@@ -104,6 +152,11 @@ struct dc_object {
 	 * being asked to fetch from leader.
 	 */
 	uint64_t		*cob_time_fetch_leader;
+	/**
+	 * The array for the latest time (in second) of each shard being
+	 * reported as on a degrading target.
+	 */
+	uint64_t		*cob_time_degraded;
 	/** shard object ptrs */
 	struct dc_obj_layout	*cob_shards;
 };
@@ -297,6 +350,11 @@ struct obj_tls {
 	/** Measure update/fetch latency based on I/O size (type = gauge) */
 	struct d_tm_node_t	*ot_update_lat[NR_LATENCY_BUCKETS];
 	struct d_tm_node_t	*ot_fetch_lat[NR_LATENCY_BUCKETS];
+
+	/** Number of inflight local updates, for degraded target throttling */
+	uint32_t		 ot_update_inflight;
+	/** Count number of throttled updates on degraded target (counter) */
+	struct d_tm_node_t	*ot_update_throttled;
 };
 
 struct obj_ec_parity {
@@ -515,6 +573,7 @@ int obj_get_replicas(struct dc_object *obj);
 int obj_shard_open(struct dc_object *obj, unsigned int shard,
 		   unsigned int map_ver, struct dc_obj_shard **shard_ptr);
 int obj_dkey2grpidx(struct dc_object *obj, uint64_t hash, unsigned int map_ver);
+void obj_shard_degraded_set(struct dc_object *obj, unsigned int shard);
 int obj_pool_query_task(tse_sched_t *sched, struct dc_object *obj,
 			unsigned int map_ver, tse_task_t **taskp);
 bool obj_csum_dedup_candidate(struct cont_props *props, daos_iod_t *iods,
@@ -901,6 +960,9 @@ dc_tx_attach(daos_handle_t th, struct dc_object *obj, enum obj_rpc_opc opc,
 int
 dc_tx_convert(struct dc_object *obj, enum obj_rpc_opc opc, tse_task_t *task);
 
+int
+dc_tx_wcq_attach(struct dc_object *obj, uint32_t map_ver, tse_task_t *task);
+
 /* obj_enum.c */
 int
 fill_oid(daos_unit_oid_t oid, struct dss_enum_arg *arg);
@@ -36,7 +36,7 @@
  * These are for daos_rpc::dr_opc and DAOS_RPC_OPCODE(opc, ...) rather than
  * crt_req_create(..., opc, ...). See daos_rpc.h.
  */
-#define DAOS_OBJ_VERSION 4
+#define DAOS_OBJ_VERSION 6
 /* LIST of internal RPCS in form of:
  * OPCODE, flags, FMT, handler, corpc_hdlr and name
  */
@@ -166,6 +166,18 @@ enum obj_rpc_flags {
 	ORF_EC_RECOV		= (1 << 17),
 	/* EC data recovery from snapshot */
 	ORF_EC_RECOV_SNAP	= (1 << 18),
+	/* EC aggregate bulk carries the parity delta against the parity of
+	 * obj_ec_agg_in::ea_par_epoch, rather than the new parity.
+	 */
+	ORF_EC_AGG_PDELTA	= (1 << 19),
+	/* Stable snapshot read of DAOS_TF_SNAP_READ TX */
+	ORF_SNAP_READ		= (1 << 20),
+};
+
+/* Reply flags for obj_rw_out::orw_flags */
+enum obj_rpc_reply_flags {
+	/* The replied target is on a degrading NVMe device. */
+	ORRF_TGT_DEGRADED	= (1 << 0),
 };
 
 /* common for update/fetch */
@@ -198,6 +210,8 @@ enum obj_rpc_flags {
 	((int32_t)		(orw_ret)		CRT_VAR) \
 	((uint32_t)		(orw_map_version)	CRT_VAR) \
 	((uint64_t)		(orw_epoch)		CRT_VAR) \
+	((uint32_t)		(orw_flags)		CRT_VAR) \
+	((uint32_t)		(orw_padding)		CRT_VAR) \
 	((daos_size_t)		(orw_iod_sizes)		CRT_ARRAY) \
 	((daos_size_t)		(orw_data_sizes)	CRT_ARRAY) \
 	((d_sg_list_t)		(orw_sgls)		CRT_ARRAY) \
@@ -344,7 +358,9 @@ CRT_RPC_DECLARE(obj_migrate, DAOS_ISEQ_OBJ_MIGRATE, DAOS_OSEQ_OBJ_MIGRATE)
 	((daos_epoch_range_t)	(ea_epoch_range)	CRT_VAR)	\
 	((uint64_t)		(ea_stripenum)		CRT_VAR)	\
 	((crt_bulk_t)		(ea_bulk)		CRT_VAR)	\
-	((uint32_t)		(ea_map_ver)		CRT_VAR)
+	((uint32_t)		(ea_map_ver)		CRT_VAR)	\
+	((uint32_t)		(ea_flags)		CRT_VAR)	\
+	((uint64_t)		(ea_par_epoch)		CRT_VAR)
 
 
 #define DAOS_OSEQ_OBJ_EC_AGG	/* output fields */		 \
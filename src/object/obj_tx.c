@@ -263,6 +263,19 @@ dc_tx_hdl_unlink(struct dc_tx *tx)
 	daos_hhash_link_delete(&tx->tx_hlink);
 }
 
+/*
+ * Stable epoch of DAOS_TF_SNAP_READ TX, below the committed horizon. Then it
+ * is handled as the TX against snapshot: fixed epoch without DTX identifier,
+ * no read timestamps or uncertainty. The servers protect the epoch against
+ * late modifications and reply -DER_TX_RESTART once aggregation may cover it,
+ * see vos_cont_snap_read().
+ */
+static inline daos_epoch_t
+dc_tx_snap_read_epoch(void)
+{
+	return crt_hlc_get() - crt_sec2hlc(DTX_COMMIT_THRESHOLD_AGE);
+}
+
 static int
 dc_tx_alloc(daos_handle_t coh, daos_epoch_t epoch, uint64_t flags,
 	    struct dc_tx **ptx)
@@ -843,9 +856,16 @@ dc_tx_open(tse_task_t *task)
 	D_ASSERTF(args != NULL,
 		  "Task Argument OPC does not match DC OPC (open)\n");
 
-	rc = dc_tx_alloc(args->coh, 0, args->flags, &tx);
-	if (rc == 0)
+	if (args->flags & DAOS_TF_SNAP_READ)
+		rc = dc_tx_alloc(args->coh, dc_tx_snap_read_epoch(),
+				 args->flags | DAOS_TF_RDONLY, &tx);
+	else
+		rc = dc_tx_alloc(args->coh, 0, args->flags, &tx);
+	if (rc == 0) {
+		if (tx->tx_flags & DAOS_TF_SNAP_READ)
+			tx->tx_epoch.oe_flags = DTX_EPOCH_SNAP_READ;
 		*args->th = dc_tx_ptr2hdl(tx);
+	}
 
 	tse_task_complete(task, rc);
 
@@ -2043,13 +2063,20 @@ dc_tx_restart_end(struct dc_tx *tx)
 	D_ASSERTF(tx->tx_status == TX_RESTARTING, "%d\n", tx->tx_status);
 	tx->tx_status = TX_OPEN;
 	tx->tx_pm_ver = 0;
-	tx->tx_epoch.oe_value = 0;
+	if (tx->tx_flags & DAOS_TF_SNAP_READ) {
+		/* Move to a newer stable epoch that is not aggregated yet. */
+		tx->tx_epoch.oe_value = dc_tx_snap_read_epoch();
+		tx->tx_epoch.oe_first = tx->tx_epoch.oe_value;
+	} else {
+		tx->tx_epoch.oe_value = 0;
+	}
 }
 
 /**
  * Restart a transaction that has encountered a -DER_TX_RESTART. This shall not
  * be used to restart a transaction created by dc_tx_open_snap or
  * dc_tx_local_open, either of which shall not encounter -DER_TX_RESTART.
+ * A DAOS_TF_SNAP_READ transaction is restarted at a newer stable epoch.
  */
 int
 dc_tx_restart(tse_task_t *task)
@@ -2075,7 +2102,8 @@ dc_tx_restart(tse_task_t *task)
 
 		D_MUTEX_LOCK(&tx->tx_lock);
 
-		D_ASSERT(!tx->tx_fixed_epoch);
+		D_ASSERT(!tx->tx_fixed_epoch ||
+			 tx->tx_flags & DAOS_TF_SNAP_READ);
 
 		rc = dc_tx_restart_begin(tx, &backoff);
 		if (rc != 0)
@@ -3057,3 +3085,390 @@ out:
 
 	return rc;
 }
+
+/*
+ * Client side write-combining queue (WCQ).
+ *
+ * For the container opened with DAOS_COO_WCOMB, small non-transactional
+ * updates against the same object redundancy group are attached to a shared
+ * internal TX, then sent together via one CPD RPC when the TX is committed.
+ * Every combined update task depends on the TX commit task, so it completes,
+ * with the commit result, only after the whole batch has been committed.
+ *
+ * A batch is sealed and committed when it reaches dc_tx_wcq_max_reqs or
+ * dc_tx_wcq_max_size, when it has been pending for dc_tx_wcq_delay usecs,
+ * or via daos_cont_flush(). The batch never crosses schedulers since task
+ * dependency requires the same scheduler.
+ */
+struct dc_tx_wcq_batch {
+	/* Link into dc_tx_wcq_list, empty once the batch is sealed. */
+	d_list_t		 dwb_link;
+	/* Link into the private list of the flush that sealed the batch. */
+	d_list_t		 dwb_flush_link;
+	daos_handle_t		 dwb_coh;
+	daos_obj_id_t		 dwb_oid;
+	uint32_t		 dwb_grp_idx;
+	/* Combined updates count and the total data size. */
+	uint32_t		 dwb_nr;
+	uint32_t		 dwb_cap;
+	daos_size_t		 dwb_size;
+	/* Held by the timer task, the commit task and the flush. */
+	int			 dwb_refs;
+	tse_sched_t		*dwb_sched;
+	struct dc_tx		*dwb_tx;
+	tse_task_t		*dwb_commit;
+	/* The combined update tasks, for re-attaching on restart. */
+	tse_task_t		**dwb_tasks;
+};
+
+unsigned int	dc_tx_wcq_max_reqs = DC_TX_WCQ_MAX_REQS_DEF;
+unsigned int	dc_tx_wcq_max_size = DC_TX_WCQ_MAX_SIZE_DEF;
+unsigned int	dc_tx_wcq_delay = DC_TX_WCQ_DELAY_DEF;
+
+static D_LIST_HEAD(dc_tx_wcq_list);
+static pthread_mutex_t dc_tx_wcq_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static void
+dc_tx_wcq_batch_put(struct dc_tx_wcq_batch *dwb)
+{
+	int	refs;
+
+	D_MUTEX_LOCK(&dc_tx_wcq_lock);
+	D_ASSERT(dwb->dwb_refs > 0);
+	refs = --dwb->dwb_refs;
+	D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+	if (refs == 0) {
+		D_ASSERT(d_list_empty(&dwb->dwb_link));
+		D_FREE(dwb->dwb_tasks);
+		D_FREE(dwb);
+	}
+}
+
+/* Seal the batch, then no more update can join it. Hold dc_tx_wcq_lock. */
+static bool
+dc_tx_wcq_seal(struct dc_tx_wcq_batch *dwb)
+{
+	if (d_list_empty(&dwb->dwb_link))
+		return false;
+
+	d_list_del_init(&dwb->dwb_link);
+
+	return true;
+}
+
+static int
+dc_tx_wcq_commit_cb(tse_task_t *task, void *data)
+{
+	struct dc_tx_wcq_batch	*dwb = *(struct dc_tx_wcq_batch **)data;
+	struct dc_tx		*tx = dwb->dwb_tx;
+	int			 rc = task->dt_result;
+	int			 i;
+
+	if (rc == -DER_TX_RESTART) {
+		uint32_t	backoff;
+
+		D_MUTEX_LOCK(&tx->tx_lock);
+		rc = dc_tx_restart_begin(tx, &backoff);
+		if (rc != 0) {
+			D_MUTEX_UNLOCK(&tx->tx_lock);
+			D_ERROR("Fail to restart combined TX "DF_DTI": "DF_RC
+				"\n", DP_DTI(&tx->tx_id), DP_RC(rc));
+			goto out;
+		}
+
+		/* It is internal TX, end the restart before the backoff. */
+		dc_tx_restart_end(tx);
+		tx->tx_pm_ver = dc_pool_get_version(tx->tx_pool);
+
+		for (i = 0; i < dwb->dwb_nr && rc == 0; i++) {
+			daos_obj_update_t	*up;
+			struct dc_object	*obj;
+
+			up = dc_task_get_args(dwb->dwb_tasks[i]);
+			obj = obj_hdl2ptr(up->oh);
+			rc = dc_tx_add_update(tx, &obj, up->flags, up->dkey,
+					      up->nr, up->iods, up->sgls);
+			if (obj != NULL)
+				obj_decref(obj);
+		}
+		D_MUTEX_UNLOCK(&tx->tx_lock);
+
+		if (rc != 0) {
+			D_ERROR("Fail to re-attach combined TX "DF_DTI": "DF_RC
+				"\n", DP_DTI(&tx->tx_id), DP_RC(rc));
+			goto out;
+		}
+
+		rc = tse_task_register_comp_cb(task, dc_tx_wcq_commit_cb,
+					       &dwb, sizeof(dwb));
+		if (rc != 0) {
+			D_ERROR("Fail to re-add CB for combined TX: "DF_RC"\n",
+				DP_RC(rc));
+			goto out;
+		}
+
+		return tse_task_reinit_with_delay(task, backoff);
+	}
+
+out:
+	D_DEBUG(DB_IO, "Combined %u updates via TX "DF_DTI": "DF_RC"\n",
+		dwb->dwb_nr, DP_DTI(&tx->tx_id), DP_RC(rc));
+
+	dc_tx_close_internal(tx);
+	dc_tx_wcq_batch_put(dwb);
+
+	return rc;
+}
+
+static int
+dc_tx_wcq_timer(tse_task_t *task)
+{
+	struct dc_tx_wcq_batch	*dwb = tse_task_get_priv(task);
+	bool			 sealed;
+
+	D_MUTEX_LOCK(&dc_tx_wcq_lock);
+	sealed = dc_tx_wcq_seal(dwb);
+	D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+	/* Otherwise, it has already been sealed because of size or flush. */
+	if (sealed)
+		dc_task_schedule(dwb->dwb_commit, true);
+
+	dc_tx_wcq_batch_put(dwb);
+	tse_task_complete(task, 0);
+
+	return 0;
+}
+
+static int
+dc_tx_wcq_batch_create(struct dc_object *obj, uint32_t grp_idx,
+		       tse_sched_t *sched)
+{
+	struct dc_tx_wcq_batch	*dwb;
+	daos_tx_commit_t	*args;
+	tse_task_t		*timer = NULL;
+	int			 rc;
+
+	D_ALLOC_PTR(dwb);
+	if (dwb == NULL)
+		return -DER_NOMEM;
+
+	D_INIT_LIST_HEAD(&dwb->dwb_link);
+	D_INIT_LIST_HEAD(&dwb->dwb_flush_link);
+	dwb->dwb_coh = obj->cob_coh;
+	dwb->dwb_oid = obj->cob_md.omd_id;
+	dwb->dwb_grp_idx = grp_idx;
+	dwb->dwb_sched = sched;
+	dwb->dwb_refs = 1;
+
+	/* Caller's buffers are kept until the combined update completes. */
+	rc = dc_tx_alloc(obj->cob_coh, 0, DAOS_TF_ZERO_COPY, &dwb->dwb_tx);
+	if (rc != 0)
+		goto out_free;
+
+	dwb->dwb_tx->tx_pm_ver = dc_pool_get_version(dwb->dwb_tx->tx_pool);
+
+	rc = dc_task_create(dc_tx_commit, sched, NULL, &dwb->dwb_commit);
+	if (rc != 0)
+		goto out_tx;
+
+	args = dc_task_get_args(dwb->dwb_commit);
+	args->th = dc_tx_ptr2hdl(dwb->dwb_tx);
+	args->flags = 0;
+
+	rc = tse_task_register_comp_cb(dwb->dwb_commit, dc_tx_wcq_commit_cb,
+				       &dwb, sizeof(dwb));
+	if (rc != 0) {
+		tse_task_complete(dwb->dwb_commit, rc);
+		goto out_tx;
+	}
+
+	/* From now on, completing the commit task releases the TX and dwb. */
+
+	rc = tse_task_create(dc_tx_wcq_timer, sched, dwb, &timer);
+	if (rc != 0) {
+		tse_task_complete(dwb->dwb_commit, rc);
+		return rc;
+	}
+
+	dwb->dwb_refs++;
+
+	D_MUTEX_LOCK(&dc_tx_wcq_lock);
+	d_list_add_tail(&dwb->dwb_link, &dc_tx_wcq_list);
+	D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+	tse_task_schedule_with_delay(timer, false, dc_tx_wcq_delay);
+
+	return 0;
+
+out_tx:
+	dc_tx_close_internal(dwb->dwb_tx);
+out_free:
+	D_FREE(dwb);
+	return rc;
+}
+
+/**
+ * Attach the non-transactional update \a task to the write-combining queue.
+ *
+ * \return	1 if the update has been combined, then \a task will be
+ *		completed when the batch is committed, the reference on
+ *		\a obj is consumed;
+ *		0 if the update cannot be combined, the caller should submit
+ *		it as usual, the reference on \a obj is kept;
+ *		negative value on failure, the reference on \a obj is consumed.
+ */
+int
+dc_tx_wcq_attach(struct dc_object *obj, uint32_t map_ver, tse_task_t *task)
+{
+	daos_obj_update_t	*up = dc_task_get_args(task);
+	tse_sched_t		*sched = tse_task2sched(task);
+	struct dc_tx_wcq_batch	*dwb = NULL;
+	struct dc_tx_wcq_batch	*tmp;
+	daos_size_t		 size;
+	bool			 sealed = false;
+	int			 grp_idx;
+	int			 rc;
+
+	if (dc_tx_wcq_max_reqs <= 1 || srv_io_mode != DIM_DTX_FULL_ENABLED ||
+	    up->flags & DAOS_COND_MASK || up->sgls == NULL ||
+	    daos_obj_is_echo(obj->cob_md.omd_id) || dc_task_is_blocking(task))
+		return 0;
+
+	if (!(dc_cont_hdl2capas(obj->cob_coh) & DAOS_COO_WCOMB))
+		return 0;
+
+	size = daos_sgls_buf_size(up->sgls, up->nr);
+	if (size > OBJ_BULK_LIMIT)
+		return 0;
+
+	grp_idx = obj_dkey2grpidx(obj, obj_dkey2hash(obj->cob_md.omd_id,
+						     up->dkey), map_ver);
+	if (grp_idx < 0)
+		return 0;
+
+again:
+	D_MUTEX_LOCK(&dc_tx_wcq_lock);
+	d_list_for_each_entry(tmp, &dc_tx_wcq_list, dwb_link) {
+		if (tmp->dwb_sched == sched && tmp->dwb_grp_idx == grp_idx &&
+		    tmp->dwb_coh.cookie == obj->cob_coh.cookie &&
+		    daos_oid_cmp(tmp->dwb_oid, obj->cob_md.omd_id) == 0) {
+			dwb = tmp;
+			break;
+		}
+	}
+
+	if (dwb == NULL) {
+		/* Completing the commit task on failure takes the lock. */
+		D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+		rc = dc_tx_wcq_batch_create(obj, grp_idx, sched);
+		if (rc != 0) {
+			D_DEBUG(DB_IO, "Cannot combine update for "DF_OID": "
+				DF_RC"\n", DP_OID(obj->cob_md.omd_id),
+				DP_RC(rc));
+			return 0;
+		}
+
+		goto again;
+	}
+
+	if (dwb->dwb_nr == dwb->dwb_cap) {
+		tse_task_t	**tasks;
+		uint32_t	  cap = max(dwb->dwb_cap << 1, 8);
+
+		D_REALLOC_ARRAY(tasks, dwb->dwb_tasks, dwb->dwb_cap, cap);
+		if (tasks == NULL)
+			D_GOTO(out, rc = -DER_NOMEM);
+
+		dwb->dwb_tasks = tasks;
+		dwb->dwb_cap = cap;
+	}
+
+	/* The commit task is not scheduled until the batch is sealed. */
+	rc = dc_task_depend(task, 1, &dwb->dwb_commit);
+	if (rc != 0)
+		goto out;
+
+	D_MUTEX_LOCK(&dwb->dwb_tx->tx_lock);
+	rc = dc_tx_add_update(dwb->dwb_tx, &obj, up->flags, up->dkey, up->nr,
+			      up->iods, up->sgls);
+	D_MUTEX_UNLOCK(&dwb->dwb_tx->tx_lock);
+	if (rc != 0)
+		goto out;
+
+	dwb->dwb_tasks[dwb->dwb_nr++] = task;
+	dwb->dwb_size += size;
+
+	if (dwb->dwb_nr >= dc_tx_wcq_max_reqs ||
+	    dwb->dwb_size >= dc_tx_wcq_max_size)
+		sealed = dc_tx_wcq_seal(dwb);
+
+	rc = 1;
+
+out:
+	D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+	if (sealed)
+		dc_task_schedule(dwb->dwb_commit, true);
+
+	if (obj != NULL)
+		obj_decref(obj);
+
+	return rc;
+}
+
+int
+dc_tx_wcq_flush(tse_task_t *task)
+{
+	daos_cont_flush_t	*args = dc_task_get_args(task);
+	tse_sched_t		*sched = tse_task2sched(task);
+	struct dc_tx_wcq_batch	*dwb;
+	struct dc_tx_wcq_batch	*tmp;
+	d_list_t		 sealed;
+	int			 deps = 0;
+	int			 rc = 0;
+	int			 rc1;
+
+	D_INIT_LIST_HEAD(&sealed);
+
+	D_MUTEX_LOCK(&dc_tx_wcq_lock);
+	d_list_for_each_entry_safe(dwb, tmp, &dc_tx_wcq_list, dwb_link) {
+		if (dwb->dwb_coh.cookie != args->coh.cookie)
+			continue;
+
+		dc_tx_wcq_seal(dwb);
+		dwb->dwb_refs++;
+		d_list_add_tail(&dwb->dwb_flush_link, &sealed);
+	}
+	D_MUTEX_UNLOCK(&dc_tx_wcq_lock);
+
+	while ((dwb = d_list_pop_entry(&sealed, struct dc_tx_wcq_batch,
+				       dwb_flush_link)) != NULL) {
+		/*
+		 * Wait for the batches that are driven by our scheduler. Only
+		 * the one that sealed the batch schedules its commit, so the
+		 * commit cannot have completed yet and the dependency is
+		 * really added when dc_task_depend() succeeds.
+		 */
+		if (dwb->dwb_sched == sched) {
+			rc1 = dc_task_depend(task, 1, &dwb->dwb_commit);
+			if (rc1 == 0)
+				deps++;
+			else if (rc == 0)
+				rc = rc1;
+		}
+
+		dc_task_schedule(dwb->dwb_commit, false);
+		dc_tx_wcq_batch_put(dwb);
+	}
+
+	/* Otherwise, it will be completed when all the commits are done. */
+	if (deps == 0)
+		tse_task_complete(task, rc);
+	else if (rc != 0)
+		task->dt_result = rc;
+
+	return 0;
+}
@@ -25,6 +25,10 @@
  *		- Peer parity is fetched.
  *		- Parity is incrementally updated.
  *		- Updated parity is transferred to peer parity target(s).
+ *		- If the container enables DAOS_PROP_CO_EC_PDELTA, peer parity
+ *		  is not fetched. Only the parity delta is computed for peers
+ *		  and transferred, peer parity target(s) apply it to their
+ *		  parity of the prior parity epoch.
  *	- If half or more of the cells are update by replicas:
  *		- All cells not filled by local replicas are fetched.
  *		- New parity is generated from entire stripe.
@@ -95,6 +99,7 @@ struct ec_agg_stripe {
 	unsigned int	as_extent_cnt;  /* number of replica extents         */
 	unsigned int	as_offset;      /* start offset in stripe            */
 	bool		as_has_holes;   /* stripe includes holes             */
+	bool		as_pdelta;      /* peer parity buffers hold deltas   */
 };
 
 /* Aggregation state for an object.
@@ -309,6 +314,7 @@ agg_clear_extents(struct ec_agg_entry *entry)
 	entry->ae_cur_stripe.as_hi_epoch = 0UL;
 	entry->ae_cur_stripe.as_stripe_fill = 0;
 	entry->ae_cur_stripe.as_has_holes = carry_is_hole ? true : false;
+	entry->ae_cur_stripe.as_pdelta = false;
 }
 
 /* Returns the stripe number for the stripe containing ex_lo.
@@ -967,6 +973,25 @@ out:
 	return rc;
 }
 
+/* Zero the peer parity cells, so the incremental parity update generates
+ * the parity deltas for the peer parity targets.
+ */
+static void
+agg_zero_peer_parity(struct ec_agg_entry *entry)
+{
+	unsigned char	*buf;
+	uint64_t	 cell_b = ec_age2cs_b(entry);
+	uint32_t	 p = ec_age2p(entry);
+	uint32_t	 pidx = ec_age2pidx(entry);
+	int		 i;
+
+	buf = entry->ae_sgl.sg_iovs[AGG_IOV_PARITY].iov_buf;
+	for (i = 0; i < p; i++) {
+		if (i != pidx)
+			memset(&buf[i * cell_b], 0, cell_b);
+	}
+}
+
 /** Pre-process the diff data to zero the non-existed replica extends */
 static void
 agg_diff_preprocess(struct ec_agg_entry *entry, unsigned char *diff,
@@ -1115,7 +1140,9 @@ agg_process_partial_stripe_ult(void *arg)
 	if (rc)
 		goto out;
 
-	if (p > 1 && !stripe_ud->asu_recalc) {
+	if (entry->ae_cur_stripe.as_pdelta) {
+		agg_zero_peer_parity(entry);
+	} else if (p > 1 && !stripe_ud->asu_recalc) {
 		rc = agg_fetch_remote_parity(entry);
 		if (rc)
 			goto out;
@@ -1138,6 +1165,7 @@ static int
 agg_process_partial_stripe(struct ec_agg_entry *entry)
 {
 	struct ec_agg_stripe_ud	 stripe_ud = { 0 };
+	struct ec_agg_param	*agg_param;
 	struct ec_agg_extent	*extent;
 	int			*status;
 	uint8_t			*bit_map = NULL;
@@ -1193,6 +1221,12 @@ agg_process_partial_stripe(struct ec_agg_entry *entry)
 	} else
 		bit_map = tbit_map;
 
+	/* Incremental update with p > 1, ship the parity delta to peers */
+	agg_param = container_of(entry, struct ec_agg_param, ap_agg_entry);
+	entry->ae_cur_stripe.as_pdelta = !stripe_ud.asu_recalc &&
+		ec_age2p(entry) > 1 &&
+		agg_param->ap_pool_info.api_props.dcp_ec_pdelta;
+
 	rc = agg_prep_sgl(entry);
 	if (rc)
 		goto out;
@@ -1317,6 +1351,8 @@ agg_peer_update_ult(void *arg)
 			agg_param->ap_pool_info.api_pool->sp_map_version;
 		ec_agg_in->ea_iod_csums.ca_arrays = NULL;
 		ec_agg_in->ea_iod_csums.ca_count = 0;
+		ec_agg_in->ea_flags = 0;
+		ec_agg_in->ea_par_epoch = 0;
 		iod_csums = NULL;
 		iod.iod_nr = 0;
 		if (stripe_ud->asu_write_par) {
@@ -1341,7 +1377,14 @@ agg_peer_update_ult(void *arg)
 			}
 			ec_agg_in->ea_bulk = bulk_hdl;
 
-			if (csummer != NULL) {
+			/* The peer checksums the parity after applying the
+			 * delta to its old parity.
+			 */
+			if (entry->ae_cur_stripe.as_pdelta) {
+				ec_agg_in->ea_flags |= ORF_EC_AGG_PDELTA;
+				ec_agg_in->ea_par_epoch =
+					entry->ae_par_extent.ape_epoch;
+			} else if (csummer != NULL) {
 				rc = daos_csummer_calc_iods(csummer, &sgl, &iod,
 							    NULL, 1, false,
 							    NULL, 0,
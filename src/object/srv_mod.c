@@ -158,6 +158,13 @@ obj_tls_init(int xs_id, int tgt_id)
 		}
 	}
 
+	rc = d_tm_add_metric(&tls->ot_update_throttled, D_TM_COUNTER,
+			     "updates throttled on degraded target", "ops",
+			     "io/ops/update/throttled/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create throttled update counter: "DF_RC"\n",
+		       DP_RC(rc));
+
 	return tls;
 }
 
@@ -29,6 +29,11 @@
 #include "obj_rpc.h"
 #include "obj_internal.h"
 
+/* Max concurrent local updates on a degrading target */
+#define OBJ_DEGRADED_UPDATE_MAX	8
+/* Max time in milliseconds to throttle an update on a degrading target */
+#define OBJ_DEGRADED_WAIT_MAX	100
+
 static int
 obj_verify_bio_csum(daos_obj_id_t oid, daos_iod_t *iods,
 		    struct dcs_iod_csums *iod_csums, struct bio_desc *biod,
@@ -147,6 +152,11 @@ obj_rw_reply(crt_rpc_t *rpc, int status, uint64_t epoch,
 		orwo->orw_epoch = epoch;
 	}
 
+	/* Hint the client to read from other replicas if possible. */
+	if (obj_rpc_is_fetch(rpc) &&
+	    bio_xs_degraded(dss_get_module_info()->dmi_nvme_ctxt))
+		orwo->orw_flags |= ORRF_TGT_DEGRADED;
+
 	D_DEBUG(DB_IO, "rpc %p opc %d send reply, pmv %d, epoch "DF_X64
 		", status %d\n", rpc, opc_get(rpc->cr_opc),
 		ioc->ioc_map_ver, orwo->orw_epoch, status);
@@ -1616,6 +1626,40 @@ out:
 	return rc;
 }
 
+/*
+ * Lower the write admission on a degrading target: when the NVMe device is
+ * degrading, only allow OBJ_DEGRADED_UPDATE_MAX local updates to proceed
+ * concurrently, others wait for a bounded time. It may sleep, so it must be
+ * called before the DTX is started.
+ */
+static struct obj_tls *
+obj_update_admit(void)
+{
+	struct obj_tls	*tls = obj_tls_get();
+	int		 waits = 0;
+
+	while (tls->ot_update_inflight >= OBJ_DEGRADED_UPDATE_MAX &&
+	       waits < OBJ_DEGRADED_WAIT_MAX &&
+	       bio_xs_degraded(dss_get_module_info()->dmi_nvme_ctxt)) {
+		if (waits == 0)
+			d_tm_inc_counter(tls->ot_update_throttled, 1);
+		dss_sleep(1);
+		waits++;
+	}
+	tls->ot_update_inflight++;
+
+	return tls;
+}
+
+static void
+obj_update_done(struct obj_tls *tls)
+{
+	if (tls != NULL) {
+		D_ASSERT(tls->ot_update_inflight > 0);
+		tls->ot_update_inflight--;
+	}
+}
+
 static int
 obj_local_rw(crt_rpc_t *rpc, struct obj_io_context *ioc,
 	     daos_iod_t *split_iods, struct dcs_iod_csums *split_csums,
@@ -1958,6 +2002,33 @@ orf_to_dtx_epoch_flags(enum obj_rpc_flags orf_flags)
 	return flags;
 }
 
+/*
+ * A stable snapshot read (ORF_SNAP_READ) doesn't update the read timestamps,
+ * so pin its epoch at the container level instead, and restart the read once
+ * the VOS or EC aggregation has covered, or may be covering, the epoch. It is
+ * called both before and after the read, because aggregation can start while
+ * the read yields.
+ */
+static int
+obj_snap_read_check(struct obj_io_context *ioc, uint32_t orf_flags,
+		    daos_epoch_t epoch)
+{
+	struct ds_cont_child	*cont = ioc->ioc_coc;
+
+	if (!(orf_flags & ORF_SNAP_READ))
+		return 0;
+
+	/* Aggregation never goes beyond HLC - DAOS_AGG_THRESHOLD. */
+	if (epoch <= crt_hlc_get() - crt_sec2hlc(DAOS_AGG_THRESHOLD) ||
+	    epoch <= cont->sc_ec_agg_eph) {
+		D_DEBUG(DB_IO, "snapshot read at "DF_X64" is aggregated, EC "
+			DF_X64"\n", epoch, cont->sc_ec_agg_eph);
+		return -DER_TX_RESTART;
+	}
+
+	return vos_cont_snap_read(ioc->ioc_vos_coh, epoch);
+}
+
 void
 ds_obj_ec_rep_handler(crt_rpc_t *rpc)
 {
@@ -2040,6 +2111,115 @@ out:
 	obj_ioc_end(&ioc, rc);
 }
 
+/* Applies the parity delta of the EC aggregate RPC to the local parity of
+ * the prior parity epoch, and writes the result as the new parity.
+ */
+static int
+obj_ec_agg_apply_delta(crt_rpc_t *rpc, struct obj_io_context *ioc)
+{
+	struct obj_ec_agg_in	*oea = crt_req_get(rpc);
+	struct daos_csummer	*csummer = ioc->ioc_coc->sc_csummer;
+	struct dcs_iod_csums	*iod_csums = NULL;
+	daos_iod_t		 iod = oea->ea_iod;
+	d_sg_list_t		 sgl = { 0 };
+	d_sg_list_t		*p_sgl = &sgl;
+	struct bio_sglist	*bsgl;
+	daos_handle_t		 ioh = DAOS_HDL_INVAL;
+	d_iov_t			 iov;
+	unsigned char		*buf;
+	unsigned char		*vects[3];
+	uint64_t		 cell_b;
+	int			 rc;
+
+	if (iod.iod_nr != 1 || iod.iod_recxs == NULL || iod.iod_size == 0)
+		return -DER_INVAL;
+
+	cell_b = iod.iod_recxs[0].rx_nr * iod.iod_size;
+	D_ALLOC(buf, cell_b * 3);
+	if (buf == NULL)
+		return -DER_NOMEM;
+
+	vects[0] = buf;
+	vects[1] = &buf[cell_b];
+	vects[2] = &buf[cell_b * 2];
+	sgl.sg_iovs = &iov;
+	sgl.sg_nr = 1;
+
+	d_iov_set(&iov, vects[1], cell_b);
+	rc = obj_bulk_transfer(rpc, CRT_BULK_GET, false, &oea->ea_bulk, NULL,
+			       DAOS_HDL_INVAL, &p_sgl, 1, NULL);
+	if (rc) {
+		D_ERROR(DF_UOID" bulk transfer failed: "DF_RC".\n",
+			DP_UOID(oea->ea_oid), DP_RC(rc));
+		goto out;
+	}
+
+	/* The delta can only be applied on top of a complete parity cell,
+	 * any hole in the old parity would turn into garbage parity.
+	 */
+	rc = vos_fetch_begin(ioc->ioc_coc->sc_hdl, oea->ea_oid,
+			     oea->ea_par_epoch, &oea->ea_dkey, 1, &iod, 0,
+			     NULL, &ioh, NULL);
+	if (rc == 0) {
+		bsgl = vos_iod_sgl_at(ioh, 0);
+		if (iod.iod_size == 0 || bsgl == NULL ||
+		    bsgl->bs_nr_out == 0 || bio_sgl_holes(bsgl) != 0)
+			rc = -DER_NONEXIST;
+		vos_fetch_end(ioh, NULL, rc);
+	}
+
+	if (rc == 0) {
+		d_iov_set(&iov, vects[0], cell_b);
+		rc = vos_obj_fetch(ioc->ioc_coc->sc_hdl, oea->ea_oid,
+				   oea->ea_par_epoch, 0, &oea->ea_dkey, 1,
+				   &iod, &sgl);
+	}
+	if (rc) {
+		D_ERROR(DF_UOID" fetch parity at "DF_X64" failed: "DF_RC"\n",
+			DP_UOID(oea->ea_oid), oea->ea_par_epoch, DP_RC(rc));
+		goto out;
+	}
+
+	/* The delta is already multiplied by the coefficients of this
+	 * parity cell, applying it with gf_vect_mad() by coefficient 1
+	 * is the plain XOR.
+	 */
+	rc = xor_gen(3, cell_b, (void **)vects);
+	if (rc) {
+		rc = -DER_INVAL;
+		goto out;
+	}
+
+	d_iov_set(&iov, vects[2], cell_b);
+	if (daos_csummer_initialized(csummer)) {
+		rc = daos_csummer_calc_iods(csummer, &sgl, &iod, NULL, 1,
+					    false, NULL, 0, &iod_csums);
+		if (rc) {
+			D_ERROR("daos_csummer_calc_iods failed: "DF_RC"\n",
+				DP_RC(rc));
+			goto out;
+		}
+	}
+
+	rc = vos_obj_update(ioc->ioc_coc->sc_hdl, oea->ea_oid,
+			    oea->ea_epoch_range.epr_hi, ioc->ioc_map_ver, 0,
+			    &oea->ea_dkey, 1, &iod, iod_csums, &sgl);
+	if (rc == -DER_NO_PERM) {
+		D_DEBUG(DB_EPC, DF_UOID" parity already exists\n",
+			DP_UOID(oea->ea_oid));
+		rc = 0;
+	} else if (rc) {
+		D_ERROR(DF_UOID" vos_obj_update failed: "DF_RC".\n",
+			DP_UOID(oea->ea_oid), DP_RC(rc));
+	}
+
+	if (iod_csums != NULL)
+		daos_csummer_free_ic(csummer, &iod_csums);
+out:
+	D_FREE(buf);
+	return rc;
+}
+
 void
 ds_obj_ec_agg_handler(crt_rpc_t *rpc)
 {
@@ -2075,7 +2255,12 @@ ds_obj_ec_agg_handler(crt_rpc_t *rpc)
 
 	D_ASSERT(ioc.ioc_coc != NULL);
 	dkey = (daos_key_t *)&oea->ea_dkey;
-	if (parity_bulk != CRT_BULK_NULL) {
+	if (parity_bulk != CRT_BULK_NULL &&
+	    (oea->ea_flags & ORF_EC_AGG_PDELTA)) {
+		rc = obj_ec_agg_apply_delta(rpc, &ioc);
+		if (rc)
+			goto out;
+	} else if (parity_bulk != CRT_BULK_NULL) {
 		rc = vos_update_begin(ioc.ioc_coc->sc_hdl, oea->ea_oid,
 				      oea->ea_epoch_range.epr_hi, 0, dkey, 1,
 				      iod, iod_csums, 0, &ioh, NULL);
@@ -2153,6 +2338,7 @@ ds_obj_tgt_update_handler(crt_rpc_t *rpc)
 	struct dtx_handle                dth = { 0 };
 	struct dtx_memberships		*mbs = NULL;
 	struct daos_shard_tgt		*tgts = NULL;
+	struct obj_tls			*tls = NULL;
 	uint32_t			 tgt_cnt;
 	uint32_t			 opc = opc_get(rpc->cr_opc);
 	uint32_t			 dtx_flags = 0;
@@ -2237,6 +2423,7 @@ ds_obj_tgt_update_handler(crt_rpc_t *rpc)
 	if (orw->orw_flags & ORF_DTX_SYNC)
 		dtx_flags |= DTX_SYNC;
 
+	tls = obj_update_admit();
 	rc = dtx_begin(ioc.ioc_vos_coh, &orw->orw_dti, &epoch, 1,
 		       orw->orw_map_ver, &orw->orw_oid,
 		       orw->orw_dti_cos.ca_arrays,
@@ -2263,6 +2450,7 @@ ds_obj_tgt_update_handler(crt_rpc_t *rpc)
 
 out:
 	rc = dtx_end(&dth, ioc.ioc_coc, rc);
+	obj_update_done(tls);
 	obj_rw_reply(rpc, rc, 0, &ioc);
 	D_FREE(mbs);
 	obj_ioc_end(&ioc, rc);
@@ -2400,6 +2588,7 @@ ds_obj_rw_handler(crt_rpc_t *rpc)
 	struct dtx_memberships		*mbs = NULL;
 	struct daos_shard_tgt		*tgts = NULL;
 	struct dtx_id			*dti_cos = NULL;
+	struct obj_tls			*tls = NULL;
 	int				dti_cos_cnt;
 	uint32_t			tgt_cnt;
 	uint32_t			version = 0;
@@ -2458,6 +2647,10 @@ ds_obj_rw_handler(crt_rpc_t *rpc)
 			dtx_flags |= DTX_FORCE_REFRESH;
 
 re_fetch:
+		rc = obj_snap_read_check(&ioc, orw->orw_flags, orw->orw_epoch);
+		if (rc != 0)
+			goto out;
+
 		rc = dtx_begin(ioc.ioc_vos_coh, &orw->orw_dti, &epoch, 0,
 			       orw->orw_map_ver, &orw->orw_oid,
 			       NULL, 0, dtx_flags, NULL, &dth);
@@ -2466,6 +2659,9 @@ re_fetch:
 
 		rc = obj_local_rw(rpc, &ioc, NULL, NULL, NULL, &dth, false);
 		rc = dtx_end(&dth, ioc.ioc_coc, rc);
+		if (rc == 0)
+			rc = obj_snap_read_check(&ioc, orw->orw_flags,
+						 orw->orw_epoch);
 
 		if (rc == -DER_INPROGRESS && dth.dth_local_retry) {
 			if (++retry > 5)
@@ -2537,6 +2733,8 @@ again1:
 		D_GOTO(out, rc);
 	}
 
+	if (tls == NULL)
+		tls = obj_update_admit();
 again2:
 	if (orw->orw_iod_array.oia_oiods != NULL && split_req == NULL) {
 		rc = obj_ec_rw_req_split(orw->orw_oid, &orw->orw_iod_array,
@@ -2661,6 +2859,7 @@ out:
 			       DP_DTI(&orw->orw_dti), DP_RC(rc1));
 	}
 
+	obj_update_done(tls);
 	obj_rw_reply(rpc, rc, epoch.oe_value, &ioc);
 	obj_ec_split_req_fini(split_req);
 	D_FREE(mbs);
@@ -2842,6 +3041,10 @@ obj_local_enum(struct obj_io_context *ioc, crt_rpc_t *rpc,
 		flags |= DTX_FORCE_REFRESH;
 
 again:
+	rc = obj_snap_read_check(ioc, oei->oei_flags, epoch.oe_value);
+	if (rc != 0)
+		goto failed;
+
 	rc = dtx_begin(ioc->ioc_vos_coh, &oei->oei_dti, &epoch, 0,
 		       oei->oei_map_ver, &oei->oei_oid, NULL, 0, flags,
 		       NULL, &dth);
@@ -2879,6 +3082,9 @@ re_pack:
 
 	/* dss_enum_pack may return 1. */
 	rc_tmp = dtx_end(&dth, ioc->ioc_coc, rc > 0 ? 0 : rc);
+	if (rc_tmp == 0 && rc >= 0)
+		rc_tmp = obj_snap_read_check(ioc, oei->oei_flags,
+					     epoch.oe_value);
 	if (rc_tmp != 0)
 		rc = rc_tmp;
 
@@ -3589,6 +3795,10 @@ again:
 	epoch.oe_first = okqi->okqi_epoch_first;
 	epoch.oe_flags = orf_to_dtx_epoch_flags(okqi->okqi_flags);
 
+	rc = obj_snap_read_check(&ioc, okqi->okqi_flags, okqi->okqi_epoch);
+	if (rc != 0)
+		goto out;
+
 	rc = dtx_begin(ioc.ioc_vos_coh, &okqi->okqi_dti, &epoch, 0,
 		       okqi->okqi_map_ver, &okqi->okqi_oid, NULL, 0, 0, NULL,
 		       &dth);
@@ -3617,6 +3827,9 @@ re_query:
 	}
 
 	rc = dtx_end(&dth, ioc.ioc_coc, rc);
+	if (rc == 0)
+		rc = obj_snap_read_check(&ioc, okqi->okqi_flags,
+					 okqi->okqi_epoch);
 
 out:
 	if (rc == -DER_INPROGRESS && dth.dth_local_retry) {
@@ -4012,49 +4225,57 @@ ds_cpd_handle_one(crt_rpc_t *rpc, struct daos_cpd_sub_head *dcsh,
 		}
 	}
 
-	/* P4: punch and vos_update_end. */
+	/* P4: verify and post the data. It may yield for NVMe I/O, so finish
+	 *     it for all the sub updates before any vos_update_end. Then the
+	 *     local transaction will not be interrupted by other ULTs, that
+	 *     is required when commit the DTX in single phase (DTX_SOLO).
+	 */
 	for (i = 0; i < dcde->dcde_write_cnt; i++) {
 		dcsr = &dcsrs[dcri[i].dcri_req_idx];
+		if (dcsr->dcsr_opc != DCSO_UPDATE)
+			continue;
 
-		if (dcsr->dcsr_opc == DCSO_UPDATE) {
-			dcu = &dcsr->dcsr_update;
-			if (dcu->dcu_ec_split_req != NULL) {
-				iods = dcu->dcu_ec_split_req->osr_iods;
-				csums = dcu->dcu_ec_split_req->osr_iod_csums;
-			} else {
-				iods = dcu->dcu_iod_array.oia_iods;
-				csums = dcu->dcu_iod_array.oia_iod_csums;
-			}
+		dcu = &dcsr->dcsr_update;
+		if (dcu->dcu_ec_split_req != NULL) {
+			iods = dcu->dcu_ec_split_req->osr_iods;
+			csums = dcu->dcu_ec_split_req->osr_iod_csums;
+		} else {
+			iods = dcu->dcu_iod_array.oia_iods;
+			csums = dcu->dcu_iod_array.oia_iod_csums;
+		}
 
-			rc = vos_dedup_verify(iohs[i]);
-			if (rc != 0) {
-				D_ERROR("dedup_verify failed for obj "
-					DF_UOID", DTX "DF_DTI": "DF_RC"\n",
-					DP_UOID(dcsr->dcsr_oid),
-					DP_DTI(&dcsh->dcsh_xid), DP_RC(rc));
-					goto out;
-			}
+		rc = vos_dedup_verify(iohs[i]);
+		if (rc != 0) {
+			D_ERROR("dedup_verify failed for obj "DF_UOID", DTX "
+				DF_DTI": "DF_RC"\n", DP_UOID(dcsr->dcsr_oid),
+				DP_DTI(&dcsh->dcsh_xid), DP_RC(rc));
+			goto out;
+		}
 
-			rc = obj_verify_bio_csum(dcsr->dcsr_oid.id_pub,
-						 iods, csums, biods[i],
-						 ioc->ioc_coc->sc_csummer,
-						 dcsr->dcsr_nr);
-			if (rc != 0) {
-				if (rc == -DER_CSUM)
-					obj_log_csum_err();
-				goto out;
-			}
+		rc = obj_verify_bio_csum(dcsr->dcsr_oid.id_pub, iods, csums,
+					 biods[i], ioc->ioc_coc->sc_csummer,
+					 dcsr->dcsr_nr);
+		if (rc != 0) {
+			if (rc == -DER_CSUM)
+				obj_log_csum_err();
+			goto out;
+		}
 
-			rc = bio_iod_post(biods[i]);
-			biods[i] = NULL;
-			if (rc != 0) {
-				D_ERROR("iod_post failed for obj "DF_UOID
-					", DTX "DF_DTI": "DF_RC"\n",
-					DP_UOID(dcsr->dcsr_oid),
-					DP_DTI(&dcsh->dcsh_xid), DP_RC(rc));
-				goto out;
-			}
+		rc = bio_iod_post(biods[i]);
+		biods[i] = NULL;
+		if (rc != 0) {
+			D_ERROR("iod_post failed for obj "DF_UOID", DTX "
+				DF_DTI": "DF_RC"\n", DP_UOID(dcsr->dcsr_oid),
+				DP_DTI(&dcsh->dcsh_xid), DP_RC(rc));
+			goto out;
+		}
+	}
+
+	/* P5: punch and vos_update_end. */
+	for (i = 0; i < dcde->dcde_write_cnt; i++) {
+		dcsr = &dcsrs[dcri[i].dcri_req_idx];
 
+		if (dcsr->dcsr_opc == DCSO_UPDATE) {
 			rc = dtx_sub_init(dth, &dcsr->dcsr_oid,
 					  dcsr->dcsr_dkey_hash);
 			if (rc != 0)
@@ -4482,7 +4703,12 @@ again:
 	else
 		tgts++;
 
-	if (tgt_cnt <= 1 && dcde->dcde_write_cnt <= 1)
+	/* If all the sub modifications are against the leader target, then
+	 * commit them in single phase (1PC) as standalone modification does.
+	 * ds_cpd_handle_one() will not yield after the local transaction is
+	 * started, so the solo DTX is safe for multiple sub modifications.
+	 */
+	if (tgt_cnt <= 1)
 		dtx_flags |= DTX_SOLO;
 	if (flags & ORF_RESEND)
 		dtx_flags |= DTX_PREPARED;
@@ -139,8 +139,15 @@ ds_obj_remote_update(struct dtx_leader_handle *dlh, void *data, int idx,
 	orw->orw_shard_tgts.ca_count	= orw_parent->orw_shard_tgts.ca_count;
 	orw->orw_shard_tgts.ca_arrays	= orw_parent->orw_shard_tgts.ca_arrays;
 	orw->orw_flags |= ORF_BULK_BIND | obj_exec_arg->flags;
-	orw->orw_dti_cos.ca_count	= dth->dth_dti_cos_count;
-	orw->orw_dti_cos.ca_arrays	= dth->dth_dti_cos;
+	if (orw->orw_flags & ORF_RESEND) {
+		orw->orw_dti_cos.ca_count	= dth->dth_dti_cos_count;
+		orw->orw_dti_cos.ca_arrays	= dth->dth_dti_cos;
+	} else {
+		/* Piggyback other committable DTXs for the target. */
+		orw->orw_dti_cos.ca_count =
+			dtx_leader_piggyback(dlh, obj_exec_arg->ioc->ioc_coc,
+					     idx, &orw->orw_dti_cos.ca_arrays);
+	}
 
 	D_DEBUG(DB_TRACE, DF_UOID" forwarding to rank:%d tag:%d.\n",
 		DP_UOID(orw->orw_oid), tgt_ep.ep_rank, tgt_ep.ep_tag);
@@ -250,8 +257,15 @@ ds_obj_remote_punch(struct dtx_leader_handle *dlh, void *data, int idx,
 	opi->opi_shard_tgts.ca_count = opi_parent->opi_shard_tgts.ca_count;
 	opi->opi_shard_tgts.ca_arrays = opi_parent->opi_shard_tgts.ca_arrays;
 	opi->opi_flags |= obj_exec_arg->flags;
-	opi->opi_dti_cos.ca_count = dth->dth_dti_cos_count;
-	opi->opi_dti_cos.ca_arrays = dth->dth_dti_cos;
+	if (opi->opi_flags & ORF_RESEND) {
+		opi->opi_dti_cos.ca_count = dth->dth_dti_cos_count;
+		opi->opi_dti_cos.ca_arrays = dth->dth_dti_cos;
+	} else {
+		/* Piggyback other committable DTXs for the target. */
+		opi->opi_dti_cos.ca_count =
+			dtx_leader_piggyback(dlh, obj_exec_arg->ioc->ioc_coc,
+					     idx, &opi->opi_dti_cos.ca_arrays);
+	}
 
 	D_DEBUG(DB_TRACE, DF_UOID" forwarding to rank:%d tag:%d.\n",
 		DP_UOID(opi->opi_oid), tgt_ep.ep_rank, tgt_ep.ep_tag);
@@ -222,6 +222,8 @@ pool_child_add_one(void *varg)
 			"." DF_RC "\n", DP_UUID(child->spc_uuid), DP_RC(rc));
 		goto out_scrub;
 	}
+	sched_pool_metrics_init(child->spc_uuid, arg->pla_pool->sp_path,
+				info->dmi_tgt_id);
 
 	d_list_add(&child->spc_list, &tls->dt_pool_list);
 
@@ -235,6 +237,7 @@ pool_child_add_one(void *varg)
 out_list:
 	d_list_del_init(&child->spc_list);
 	ds_cont_child_stop_all(child);
+	sched_pool_metrics_fini(child->spc_uuid);
 	dss_module_fini_metrics(DAOS_TGT_TAG, child->spc_metrics);
 out_scrub:
 	ds_stop_scrubbing_ult(child);
@@ -265,6 +268,7 @@ pool_child_delete_one(void *uuid)
 	ds_cont_child_stop_all(child);
 	stop_gc_ult(child);
 	ds_stop_scrubbing_ult(child);
+	sched_pool_metrics_fini(child->spc_uuid);
 	ds_pool_child_put(child); /* -1 for the list */
 
 	ds_pool_child_put(child); /* -1 for lookup */
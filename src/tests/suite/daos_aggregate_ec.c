@@ -947,6 +947,131 @@ re_test:
 	cleanup_ec_agg_tests(&ctx);
 }
 
+/**
+ * Enable parity delta on the container, aggregate a partial stripe of a
+ * 2 parities object, then verify that a degraded fetch, which recovers the
+ * overwritten cell from the parity updated by the delta, returns the right
+ * data.
+ */
+static void
+ec_pdelta_agg(void **statep)
+{
+	test_arg_t		*arg = *statep;
+	struct ec_agg_test_ctx	 ctx = { 0 };
+	struct daos_oclass_attr	*oca;
+	daos_prop_t		*prop;
+	uint32_t		 cs, ss;
+	d_iov_t			 dkey;
+	d_sg_list_t		 sgl;
+	d_iov_t			 sg_iov;
+	daos_iod_t		 iod;
+	daos_recx_t		 recx;
+	char			*wbuf;
+	char			*rbuf;
+	char			*expect;
+	uint16_t		 fail_shard = 0;
+	uint64_t		 fail_val;
+	int			 rc;
+
+	if (!test_runable(arg, 4))
+		skip();
+
+	FAULT_INJECTION_REQUIRED();
+
+	daos_pool_set_prop(arg->pool.pool_uuid, "reclaim", "time");
+	setup_ec_agg_tests(statep, &ctx);
+
+	prop = daos_prop_alloc(1);
+	assert_non_null(prop);
+	prop->dpp_entries[0].dpe_type = DAOS_PROP_CO_EC_PDELTA;
+	prop->dpp_entries[0].dpe_val = DAOS_PROP_CO_EC_PDELTA_ON;
+
+	uuid_generate(ctx.uuid);
+	rc = daos_cont_create(ctx.poh, ctx.uuid, prop, NULL);
+	assert_success(rc);
+	daos_prop_free(prop);
+	rc = daos_cont_open(ctx.poh, ctx.uuid, DAOS_COO_RW, &ctx.coh,
+			    &ctx.info, NULL);
+	assert_success(rc);
+
+	dts_ec_agg_oc = DAOS_OC_EC_K2P2_L32K;
+	ec_setup_obj(&ctx, dts_ec_agg_oc, 1);
+	assert_int_equal(oid_is_ec(ctx.oid, &oca), true);
+	assert_int_equal(oca->u.ec.e_k, 2);
+	assert_int_equal(oca->u.ec.e_p, 2);
+	cs = oca->u.ec.e_len;
+	ss = cs * oca->u.ec.e_k;
+	wbuf = calloc(ss, 1);
+	rbuf = calloc(ss, 1);
+	expect = calloc(ss, 1);
+	assert_non_null(wbuf);
+	assert_non_null(rbuf);
+	assert_non_null(expect);
+
+	d_iov_set(&dkey, "dkey", strlen("dkey"));
+	d_iov_set(&iod.iod_name, "akey", strlen("akey"));
+	sgl.sg_nr = 1;
+	sgl.sg_nr_out = 0;
+	sgl.sg_iovs = &sg_iov;
+	iod.iod_nr	= 1;
+	iod.iod_size	= 1;
+	iod.iod_recxs	= &recx;
+	iod.iod_type	= DAOS_IOD_ARRAY;
+
+	/* full stripe, aggregated to parity first */
+	memset(wbuf, 'a', ss);
+	d_iov_set(&sg_iov, wbuf, ss);
+	recx.rx_idx	= 0;
+	recx.rx_nr	= ss;
+	rc = daos_obj_update(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1, &iod, &sgl,
+			     NULL);
+	assert_rc_equal(rc, 0);
+	memcpy(expect, wbuf, ss);
+
+	daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+			      DAOS_FORCE_EC_AGG | DAOS_FAIL_ALWAYS,
+			      0, NULL);
+	print_message("wait for 25 seconds for full stripe aggregation.\n");
+	sleep(25);
+
+	/* overwrite half of the first cell, aggregated by parity delta */
+	memset(wbuf, 'b', cs / 2);
+	d_iov_set(&sg_iov, wbuf, cs / 2);
+	recx.rx_idx	= 0;
+	recx.rx_nr	= cs / 2;
+	rc = daos_obj_update(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1, &iod, &sgl,
+			     NULL);
+	assert_rc_equal(rc, 0);
+	memcpy(expect, wbuf, cs / 2);
+
+	print_message("wait for 25 seconds for partial stripe aggregation.\n");
+	sleep(25);
+
+	/* degraded fetch, recover the first cell from the parities */
+	fail_val = daos_shard_fail_value(&fail_shard, 1);
+	daos_fail_loc_set(DAOS_FAIL_SHARD_FETCH | DAOS_FAIL_ONCE);
+	daos_fail_value_set(fail_val);
+	d_iov_set(&sg_iov, rbuf, ss);
+	recx.rx_idx	= 0;
+	recx.rx_nr	= ss;
+	rc = daos_obj_fetch(ctx.oh, DAOS_TX_NONE, 0, &dkey, 1, &iod, &sgl,
+			    NULL, NULL);
+	assert_rc_equal(rc, 0);
+	assert_memory_equal(rbuf, expect, ss);
+
+	daos_debug_set_params(arg->group, -1, DMG_KEY_FAIL_LOC,
+			      0, 0, NULL);
+	daos_fail_loc_set(0);
+	daos_fail_value_set(0);
+
+	free(wbuf);
+	free(rbuf);
+	free(expect);
+	rc = daos_obj_close(ctx.oh, NULL);
+	assert_rc_equal(rc, 0);
+	cleanup_ec_agg_tests(&ctx);
+}
+
 #define NUM_SERVERS 5
 static int
 ec_setup(void **statep)
@@ -960,6 +1085,8 @@ static const struct CMUnitTest ec_agg_tests[] = {
 	  incremental_fill, test_case_teardown},
 	{"DAOS_ECAG01: test fetch snapshot lower than vos agg boundary",
 	  fetch_snap_with_agg, async_disable, test_case_teardown},
+	{"DAOS_ECAG02: test partial stripe aggregation with parity delta",
+	  ec_pdelta_agg, async_disable, test_case_teardown},
 };
 
 int run_daos_aggregation_ec_test(int rank, int size, int *sub_tests,
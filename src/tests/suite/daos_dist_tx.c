@@ -3009,6 +3009,129 @@ dtx_41(void **state)
 	dtx_uncertainty_miss_request(*state, DAOS_DTX_MISS_ABORT, true, true);
 }
 
+static void
+dtx_42(void **state)
+{
+	test_arg_t	*arg = *state;
+	const char	*dkey = dts_dtx_dkey;
+	const char	*akey = dts_dtx_akey;
+	char		 write_buf[DTX_IO_SMALL];
+	char		 fetch_buf[DTX_IO_SMALL];
+	daos_handle_t	 th = { 0 };
+	daos_obj_id_t	 oid;
+	struct ioreq	 req;
+
+	print_message("DTX42: read only transaction on stable epoch\n");
+
+	arg->async = 0;
+	oid = daos_test_oid_gen(arg->coh, OC_RP_XSF, 0, 0, arg->myrank);
+	ioreq_init(&req, arg->coh, oid, DAOS_IOD_SINGLE, arg);
+
+	dts_buf_render(write_buf, DTX_IO_SMALL);
+	insert_single(dkey, akey, 0, write_buf, DTX_IO_SMALL, DAOS_TX_NONE,
+		      &req);
+
+	MUST(daos_tx_open(arg->coh, &th, DAOS_TF_SNAP_READ, NULL));
+
+	arg->expect_result = -DER_NO_PERM;
+	insert_single(dkey, akey, 0, write_buf, DTX_IO_SMALL, th, &req);
+
+	/* The new modification is above the stable epoch, invisible. */
+	arg->expect_result = 0;
+	lookup_single(dkey, akey, 0, fetch_buf, DTX_IO_SMALL, th, &req);
+	assert_int_equal(req.iod[0].iod_size, 0);
+
+	MUST(daos_tx_commit(th, NULL));
+	MUST(daos_tx_close(th, NULL));
+
+	print_message("Sleep %d seconds for the stable epoch to catch up\n",
+		      DTX_COMMIT_THRESHOLD_AGE + 1);
+	sleep(DTX_COMMIT_THRESHOLD_AGE + 1);
+
+	MUST(daos_tx_open(arg->coh, &th, DAOS_TF_SNAP_READ, NULL));
+
+	lookup_single(dkey, akey, 0, fetch_buf, DTX_IO_SMALL, th, &req);
+	assert_int_equal(req.iod[0].iod_size, DTX_IO_SMALL);
+	assert_memory_equal(write_buf, fetch_buf, DTX_IO_SMALL);
+
+	print_message("Sleep %d seconds for the stable epoch to age out\n",
+		      DAOS_AGG_THRESHOLD - DTX_COMMIT_THRESHOLD_AGE + 1);
+	sleep(DAOS_AGG_THRESHOLD - DTX_COMMIT_THRESHOLD_AGE + 1);
+
+	arg->expect_result = -DER_TX_RESTART;
+	lookup_single(dkey, akey, 0, fetch_buf, DTX_IO_SMALL, th, &req);
+
+	/* Restart moves the TX to a newer stable epoch. */
+	MUST(daos_tx_restart(th, NULL));
+
+	arg->expect_result = 0;
+	lookup_single(dkey, akey, 0, fetch_buf, DTX_IO_SMALL, th, &req);
+	assert_int_equal(req.iod[0].iod_size, DTX_IO_SMALL);
+	assert_memory_equal(write_buf, fetch_buf, DTX_IO_SMALL);
+
+	MUST(daos_tx_commit(th, NULL));
+	MUST(daos_tx_close(th, NULL));
+
+	ioreq_fini(&req);
+}
+
+static void
+dtx_43(void **state)
+{
+	test_arg_t	*arg = *state;
+	const char	*dkey = dts_dtx_dkey;
+	char		 akeys[DTX_NC_CNT][16];
+	char		 write_bufs[DTX_NC_CNT][DTX_IO_SMALL];
+	char		 fetch_buf[DTX_IO_SMALL];
+	daos_size_t	 iod_size = DTX_IO_SMALL;
+	daos_handle_t	 coh;
+	daos_obj_id_t	 oid;
+	struct ioreq	 reqs[DTX_NC_CNT];
+	struct ioreq	 req;
+	int		 rx_nr = 1;
+	uint64_t	 idx = 0;
+	int		 i;
+
+	print_message("DTX43: combine small updates for the same target\n");
+
+	MUST(daos_cont_open(arg->pool.poh, arg->co_uuid,
+			    DAOS_COO_RW | DAOS_COO_WCOMB, &coh, NULL, NULL));
+
+	arg->async = 1;
+	oid = daos_test_oid_gen(arg->coh, OC_S1, 0, 0, arg->myrank);
+	for (i = 0; i < DTX_NC_CNT; i++) {
+		const char	*akey = akeys[i];
+		void		*val = write_bufs[i];
+
+		snprintf(akeys[i], sizeof(akeys[i]), "akey_%d", i);
+		dts_buf_render(write_bufs[i], DTX_IO_SMALL);
+		ioreq_init(&reqs[i], coh, oid, DAOS_IOD_SINGLE, arg);
+		insert_nowait(dkey, 1, &akey, &iod_size, &rx_nr, &idx, &val,
+			      DAOS_TX_NONE, &reqs[i], 0);
+	}
+
+	MUST(daos_cont_flush(coh, NULL));
+
+	for (i = 0; i < DTX_NC_CNT; i++)
+		insert_wait(&reqs[i]);
+
+	for (i = 0; i < DTX_NC_CNT; i++)
+		ioreq_fini(&reqs[i]);
+
+	arg->async = 0;
+	ioreq_init(&req, arg->coh, oid, DAOS_IOD_SINGLE, arg);
+
+	for (i = 0; i < DTX_NC_CNT; i++) {
+		lookup_single(dkey, akeys[i], 0, fetch_buf, DTX_IO_SMALL,
+			      DAOS_TX_NONE, &req);
+		assert_int_equal(req.iod[0].iod_size, DTX_IO_SMALL);
+		assert_memory_equal(write_bufs[i], fetch_buf, DTX_IO_SMALL);
+	}
+
+	ioreq_fini(&req);
+	MUST(daos_cont_close(coh, NULL));
+}
+
 static test_arg_t *saved_dtx_arg;
 
 static int
@@ -3123,6 +3246,10 @@ static const struct CMUnitTest dtx_tests[] = {
 	 dtx_40, NULL, test_case_teardown},
 	{"DTX41: uncertain check - miss abort with delay",
 	 dtx_41, NULL, test_case_teardown},
+	{"DTX42: read only transaction on stable epoch",
+	 dtx_42, NULL, test_case_teardown},
+	{"DTX43: combine small updates for the same target",
+	 dtx_43, NULL, test_case_teardown},
 };
 
 static int
@@ -13,6 +13,7 @@
 
 #include "daos_iotest.h"
 #include <daos_types.h>
+#include <daos_metrics.h>
 #include <daos/checksum.h>
 #include <daos/placement.h>
 
@@ -4542,6 +4543,126 @@ int_key_setting(void **state)
 	assert_rc_equal(rc, 0);
 }
 
+/** Get the client object layout cache counters, false if not available */
+static bool
+layout_cntrs_get(daos_metrics_obj_layout_cntrs_t *cntrs)
+{
+	daos_metrics_ucntrs_t	ucntrs = { 0 };
+	char			*env;
+	int			 rc;
+
+	/* the cache is disabled by DAOS_LAYOUT_CACHE_BITS=0 */
+	env = getenv("DAOS_LAYOUT_CACHE_BITS");
+	if (env != NULL && atoi(env) == 0)
+		return false;
+
+	/* counters are only collected with DAOS_METRICS=ON */
+	ucntrs.mc_grp = DAOS_METRICS_POOL_RPC_CNTR;
+	rc = daos_metrics_get_cntrs(DAOS_METRICS_OBJ_LAYOUT_CNTR, &ucntrs);
+	assert_rc_equal(rc, 0);
+	if (ucntrs.mc_grp != DAOS_METRICS_OBJ_LAYOUT_CNTR)
+		return false;
+
+	*cntrs = ucntrs.u.arc_layout_cntrs;
+	return true;
+}
+
+static void
+layout_open_close(test_arg_t *arg, daos_obj_id_t oid)
+{
+	daos_handle_t	oh;
+	int		rc;
+
+	rc = daos_obj_open(arg->coh, oid, 0, &oh, NULL);
+	assert_rc_equal(rc, 0);
+	rc = daos_obj_close(oh, NULL);
+	assert_rc_equal(rc, 0);
+}
+
+/**
+ * Open the same object twice, the second open should find the object layout
+ * in the client layout cache.
+ */
+static void
+layout_cache_hit(void **state)
+{
+	test_arg_t			*arg = *state;
+	daos_metrics_obj_layout_cntrs_t	 before, after;
+	daos_obj_id_t			 oid;
+
+	if (!layout_cntrs_get(&before)) {
+		print_message("object layout cache counters unavailable\n");
+		skip();
+	}
+
+	oid = daos_test_oid_gen(arg->coh, dts_obj_class, 0, 0, arg->myrank);
+
+	print_message("open the same object twice\n");
+	layout_open_close(arg, oid);
+	assert_true(layout_cntrs_get(&after));
+	assert_int_equal(after.lcc_miss, before.lcc_miss + 1);
+	assert_int_equal(after.lcc_hit, before.lcc_hit);
+
+	layout_open_close(arg, oid);
+	assert_true(layout_cntrs_get(&after));
+	assert_int_equal(after.lcc_miss, before.lcc_miss + 1);
+	assert_int_equal(after.lcc_hit, before.lcc_hit + 1);
+}
+
+/**
+ * Cached object layouts of the old pool map version should be dropped once
+ * the pool map version is bumped.
+ */
+static void
+layout_cache_inval(void **state)
+{
+	test_arg_t			*arg = *state;
+	daos_metrics_obj_layout_cntrs_t	 before, after;
+	daos_obj_id_t			 oid;
+	d_rank_t			 rank;
+	int				 rc;
+
+	/* needs at lest 4 targets, exclude one and another 3 raft nodes */
+	if (!test_runable(arg, 4))
+		skip();
+
+	if (!layout_cntrs_get(&before)) {
+		print_message("object layout cache counters unavailable\n");
+		skip();
+	}
+
+	oid = daos_test_oid_gen(arg->coh, dts_obj_class, 0, 0, arg->myrank);
+	layout_open_close(arg, oid);
+	assert_true(layout_cntrs_get(&before));
+
+	rank = arg->srv_nnodes - 1;
+	if (arg->myrank == 0) {
+		print_message("exclude target 0 of rank %u\n", rank);
+		daos_exclude_target(arg->pool.pool_uuid, arg->group,
+				    arg->dmg_config, rank, 0);
+		test_rebuild_wait(&arg, 1);
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+
+	/** refresh the client pool map */
+	rc = daos_pool_query(arg->pool.poh, NULL, NULL, NULL, NULL);
+	assert_rc_equal(rc, 0);
+
+	print_message("open the object with the new pool map\n");
+	layout_open_close(arg, oid);
+	assert_true(layout_cntrs_get(&after));
+	assert_true(after.lcc_inval > before.lcc_inval);
+	assert_int_equal(after.lcc_miss, before.lcc_miss + 1);
+	assert_int_equal(after.lcc_hit, before.lcc_hit);
+
+	if (arg->myrank == 0) {
+		daos_reint_target(arg->pool.pool_uuid, arg->group,
+				  arg->dmg_config, rank, 0);
+		test_rebuild_wait(&arg, 1);
+	}
+	MPI_Barrier(MPI_COMM_WORLD);
+}
+
 static const struct CMUnitTest io_tests[] = {
 	{ "IO1: simple update/fetch/verify",
 	  io_simple, async_disable, test_case_teardown},
@@ -4633,6 +4754,10 @@ static const struct CMUnitTest io_tests[] = {
 	  oclass_auto_setting, async_disable, test_case_teardown},
 	{ "IO44: INT dkey/akey checks",
 	  int_key_setting, async_disable, test_case_teardown},
+	{ "IO45: Object layout cache hit on re-open",
+	  layout_cache_hit, async_disable, test_case_teardown},
+	{ "IO46: Object layout cache invalidation on pool map change",
+	  layout_cache_inval, async_disable, test_case_teardown},
 };
 
 int
@@ -493,6 +493,16 @@ daos_parse_property(char *name, char *value, daos_prop_t *props)
 			return -DER_INVAL;
 		}
 		entry->dpe_type = DAOS_PROP_CO_EC_CELL_SZ;
+	} else if (!strcmp(name, "ec_pdelta")) {
+		if (!strcmp(value, "on"))
+			entry->dpe_val = DAOS_PROP_CO_EC_PDELTA_ON;
+		else if (!strcmp(value, "off"))
+			entry->dpe_val = DAOS_PROP_CO_EC_PDELTA_OFF;
+		else {
+			fprintf(stderr, "ec_pdelta prop value can only be 'on/off'\n");
+			return -DER_INVAL;
+		}
+		entry->dpe_type = DAOS_PROP_CO_EC_PDELTA;
 	} else {
 		fprintf(stderr, "supported prop names are label/cksum/cksum_size/srv_cksum/dedup/dedup_th/rf\n");
 		return -DER_INVAL;
@@ -1711,12 +1721,14 @@ help_hdlr(int argc, char *argv[], struct cmd_args_s *ap)
 			"	--properties=<name>:<value>[,<name>:<value>,...]\n"
 			"			   supported prop names are label, cksum,\n"
 			"				cksum_size, srv_cksum, dedup, status\n"
-			"				dedup_th, compression, encryption\n"
+			"				dedup_th, compression, encryption,\n"
+			"				ec_pdelta\n"
 			"			   label value can be any string\n"
 			"			   cksum supported values are off, crc[16,32,64],\n"
 			"						      adler32, sha[1,256,512]\n"
 			"			   cksum_size can be any size < 4GiB\n"
 			"			   srv_cksum values can be on, off\n"
+			"			   ec_pdelta values can be on, off\n"
 			"			   dedup (preview) values can be off, memcmp or hash\n"
 			"			   dedup_th (preview) can be any size between 4KiB and 64KiB\n"
 			"			   compression (preview) values can be lz4, deflate, deflate[1-4]\n"
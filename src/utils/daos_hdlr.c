@@ -1327,6 +1327,16 @@ cont_decode_props(struct cmd_args_s *ap, daos_prop_t *props,
 	} else {
 		D_PRINT("EC cell size:\t%d\n", (int)entry->dpe_val);
 	}
+
+	entry = daos_prop_entry_get(props, DAOS_PROP_CO_EC_PDELTA);
+	if (entry == NULL) {
+		fprintf(ap->errstream, "EC parity delta property not found\n");
+		rc = -DER_INVAL;
+	} else {
+		D_PRINT("EC parity delta:\t%s\n",
+			entry->dpe_val == DAOS_PROP_CO_EC_PDELTA_ON ?
+			"on" : "off");
+	}
 	entry = daos_prop_entry_get(props, DAOS_PROP_CO_ALLOCED_OID);
 	if (entry == NULL) {
 		fprintf(ap->errstream,
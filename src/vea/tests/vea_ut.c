@@ -976,12 +976,14 @@ print_stats(struct vea_ut_args *args, bool verbose)
 	print_message("free_blks:"DF_U64"/"DF_U64", large_frags:"DF_U64", "
 		      "small_frags:"DF_U64", largest_ext_blks:%u\n"
 		      "resrv_hint:"DF_U64"\nresrv_large:"DF_U64"\n"
-		      "resrv_small:"DF_U64"\nresrv_vec:"DF_U64"\n",
+		      "resrv_small:"DF_U64"\nresrv_vec:"DF_U64"\n"
+		      "resrv_bitmap:"DF_U64"\n",
 		      stat.vs_free_persistent, stat.vs_free_transient,
 		      stat.vs_large_frags, stat.vs_small_frags,
 		      stat.vs_largest_blks,
 		      stat.vs_resrv_hint, stat.vs_resrv_large,
-		      stat.vs_resrv_small, stat.vs_resrv_vec);
+		      stat.vs_resrv_small, stat.vs_resrv_vec,
+		      stat.vs_resrv_bitmap);
 
 	if (verbose)
 		vea_dump(args->vua_vsi, true);
@@ -1254,6 +1256,263 @@ ut_fragmentation(void **state)
 	ut_teardown(&args);
 }
 
+static void
+ut_bitmap(void **state)
+{
+	struct vea_ut_args	 args;
+	struct vea_unmap_context unmap_ctxt = { 0 };
+	struct vea_resrvd_ext	*ext;
+	struct vea_stat		 stat;
+	d_list_t		*r_list;
+	uint64_t		 capacity = ((VEA_LARGE_EXT_MB * 2) << 20);
+	uint64_t		 off;
+	uint32_t		 blk_cnt = 8;
+	int			 rc, i;
+
+	print_message("Test bitmap allocator for small extents\n");
+	setenv("DAOS_VEA_BITMAP_ENABLED", "1", 1);
+	ut_setup(&args);
+	rc = vea_format(&args.vua_umm, &args.vua_txd, args.vua_md, 0, 1,
+			capacity, NULL, NULL, false);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_load(&args.vua_umm, &args.vua_txd, args.vua_md, &unmap_ctxt,
+		      &args.vua_vsi);
+	assert_rc_equal(rc, 0);
+	assert_true(bitmap_enabled(args.vua_vsi));
+
+	/* Reservations of same size are packed in consecutive slots */
+	r_list = &args.vua_resrvd_list[0];
+	off = VEA_HINT_OFF_INVAL;
+	for (i = 0; i < 4; i++) {
+		rc = vea_reserve(args.vua_vsi, blk_cnt, NULL, r_list);
+		assert_rc_equal(rc, 0);
+
+		ext = d_list_entry(r_list->prev, struct vea_resrvd_ext,
+				   vre_link);
+		assert_int_equal(ext->vre_blk_cnt, blk_cnt);
+		if (i == 0)
+			off = ext->vre_blk_off;
+		else
+			assert_int_equal(ext->vre_blk_off, off + i * blk_cnt);
+
+		rc = vea_verify_alloc(args.vua_vsi, true, ext->vre_blk_off,
+				      blk_cnt);
+		assert_rc_equal(rc, 0);
+		rc = vea_verify_alloc(args.vua_vsi, false, ext->vre_blk_off,
+				      blk_cnt);
+		assert_rc_equal(rc, 1);
+	}
+
+	rc = vea_query(args.vua_vsi, NULL, &stat);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(stat.vs_resrv_bitmap, 4);
+	assert_int_equal(stat.vs_free_transient + 4 * blk_cnt,
+			 stat.vs_free_persistent);
+
+	/* Canceled slots are visible for allocation instantly */
+	rc = vea_cancel(args.vua_vsi, NULL, r_list);
+	assert_rc_equal(rc, 0);
+	rc = vea_verify_alloc(args.vua_vsi, true, off, 4 * blk_cnt);
+	assert_rc_equal(rc, 1);
+
+	rc = vea_query(args.vua_vsi, NULL, &stat);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(stat.vs_free_transient, stat.vs_free_persistent);
+
+	/* Reuse the first slot, publish then free it */
+	rc = vea_reserve(args.vua_vsi, blk_cnt, NULL, r_list);
+	assert_rc_equal(rc, 0);
+	ext = d_list_entry(r_list->prev, struct vea_resrvd_ext, vre_link);
+	assert_int_equal(ext->vre_blk_off, off);
+
+	rc = umem_tx_begin(&args.vua_umm, &args.vua_txd);
+	assert_rc_equal(rc, 0);
+	rc = vea_tx_publish(args.vua_vsi, NULL, r_list);
+	assert_rc_equal(rc, 0);
+	rc = umem_tx_commit(&args.vua_umm);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_verify_alloc(args.vua_vsi, false, off, blk_cnt);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_free(args.vua_vsi, off, blk_cnt);
+	assert_rc_equal(rc, 0);
+	/* Not visible for allocation until migrated */
+	rc = vea_verify_alloc(args.vua_vsi, true, off, blk_cnt);
+	assert_rc_equal(rc, 0);
+
+	vea_flush(args.vua_vsi, false);
+	rc = vea_verify_alloc(args.vua_vsi, true, off, blk_cnt);
+	assert_rc_equal(rc, 1);
+
+	/* Large extent isn't served by bitmap allocator */
+	rc = vea_reserve(args.vua_vsi, 1024, NULL, r_list);
+	assert_rc_equal(rc, 0);
+	rc = vea_query(args.vua_vsi, NULL, &stat);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(stat.vs_resrv_bitmap, 5);
+	rc = vea_cancel(args.vua_vsi, NULL, r_list);
+	assert_rc_equal(rc, 0);
+
+	vea_unload(args.vua_vsi);
+	ut_teardown(&args);
+	unsetenv("DAOS_VEA_BITMAP_ENABLED");
+}
+
+static void
+ut_ext_isolated(void **state)
+{
+	struct vea_ut_args	 args;
+	struct vea_unmap_context unmap_ctxt = { 0 };
+	struct vea_hint_context	*h_ctxt;
+	struct vea_resrvd_ext	*ext;
+	struct vea_stat		 stat;
+	d_list_t		*r_list;
+	uint64_t		 capacity = ((VEA_LARGE_EXT_MB * 2) << 20);
+	uint64_t		 off[5];
+	uint32_t		 blk_cnt = 4;
+	int			 rc, i;
+
+	print_message("Test isolated extent & frags histogram\n");
+	ut_setup(&args);
+	rc = vea_format(&args.vua_umm, &args.vua_txd, args.vua_md, 0, 1,
+			capacity, NULL, NULL, false);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_load(&args.vua_umm, &args.vua_txd, args.vua_md, &unmap_ctxt,
+		      &args.vua_vsi);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_hint_load(args.vua_hint[0], &args.vua_hint_ctxt[0]);
+	assert_rc_equal(rc, 0);
+	h_ctxt = args.vua_hint_ctxt[0];
+
+	/* Allocate five consecutive extents from the same I/O stream */
+	r_list = &args.vua_resrvd_list[0];
+	for (i = 0; i < 5; i++) {
+		rc = vea_reserve(args.vua_vsi, blk_cnt, h_ctxt, r_list);
+		assert_rc_equal(rc, 0);
+		ext = d_list_entry(r_list->prev, struct vea_resrvd_ext,
+				   vre_link);
+		off[i] = ext->vre_blk_off;
+		if (i > 0)
+			assert_int_equal(off[i], off[i - 1] + blk_cnt);
+	}
+
+	rc = umem_tx_begin(&args.vua_umm, &args.vua_txd);
+	assert_rc_equal(rc, 0);
+	rc = vea_tx_publish(args.vua_vsi, h_ctxt, r_list);
+	assert_rc_equal(rc, 0);
+	rc = umem_tx_commit(&args.vua_umm);
+	assert_rc_equal(rc, 0);
+
+	assert_false(vea_ext_isolated(args.vua_vsi, off[2], blk_cnt));
+
+	/* Free the 2nd and the 4th, the middle one becomes isolated */
+	rc = vea_free(args.vua_vsi, off[1], blk_cnt);
+	assert_rc_equal(rc, 0);
+	assert_false(vea_ext_isolated(args.vua_vsi, off[2], blk_cnt));
+	rc = vea_free(args.vua_vsi, off[3], blk_cnt);
+	assert_rc_equal(rc, 0);
+	assert_true(vea_ext_isolated(args.vua_vsi, off[2], blk_cnt));
+	assert_false(vea_ext_isolated(args.vua_vsi, off[0], blk_cnt));
+
+	/* The two small frags are in the second bucket */
+	vea_flush(args.vua_vsi, false);
+	rc = vea_query(args.vua_vsi, NULL, &stat);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(stat.vs_frags_hist[0], 0);
+	assert_int_equal(stat.vs_frags_hist[1], 2);
+
+	vea_hint_unload(h_ctxt);
+	args.vua_hint_ctxt[0] = NULL;
+	vea_unload(args.vua_vsi);
+	ut_teardown(&args);
+}
+
+static void
+ut_hint_cursor(void **state)
+{
+	struct vea_ut_args	 args;
+	struct vea_unmap_context unmap_ctxt = { 0 };
+	struct vea_hint_context	*h_ctxt;
+	struct vea_resrvd_ext	*ext;
+	d_list_t		*r_list;
+	uint64_t		 capacity = ((VEA_LARGE_EXT_MB * 2) << 20);
+	uint64_t		 off[2][4], off_c, off_s;
+	uint32_t		 blk_cnt = 8;
+	int			 rc, i, w;
+
+	print_message("Test per-writer allocation cursors\n");
+	ut_setup(&args);
+	rc = vea_format(&args.vua_umm, &args.vua_txd, args.vua_md, 0, 1,
+			capacity, NULL, NULL, false);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_load(&args.vua_umm, &args.vua_txd, args.vua_md, &unmap_ctxt,
+		      &args.vua_vsi);
+	assert_rc_equal(rc, 0);
+
+	rc = vea_hint_load(args.vua_hint[0], &args.vua_hint_ctxt[0]);
+	assert_rc_equal(rc, 0);
+	h_ctxt = args.vua_hint_ctxt[0];
+
+	/* Two writers interleave their reserve & publish on one I/O stream */
+	for (i = 0; i < 4; i++) {
+		for (w = 0; w < 2; w++) {
+			r_list = &args.vua_resrvd_list[w];
+			rc = vea_reserve_key(args.vua_vsi, blk_cnt, h_ctxt,
+					     w + 1, r_list);
+			assert_rc_equal(rc, 0);
+			ext = d_list_entry(r_list->prev, struct vea_resrvd_ext,
+					   vre_link);
+			off[w][i] = ext->vre_blk_off;
+
+			rc = umem_tx_begin(&args.vua_umm, &args.vua_txd);
+			assert_rc_equal(rc, 0);
+			rc = vea_tx_publish(args.vua_vsi, h_ctxt, r_list);
+			assert_rc_equal(rc, 0);
+			rc = umem_tx_commit(&args.vua_umm);
+			assert_rc_equal(rc, 0);
+		}
+	}
+
+	/* Extents of each writer are contiguous */
+	for (w = 0; w < 2; w++) {
+		for (i = 1; i < 4; i++)
+			assert_int_equal(off[w][i], off[w][i - 1] + blk_cnt);
+	}
+
+	/*
+	 * Canceled reservation rewinds the cursor of the writer, and the
+	 * I/O stream hint to its own offset.
+	 */
+	off_s = h_ctxt->vhc_off;
+	assert_int_equal(off_s, off[1][3] + blk_cnt);
+	r_list = &args.vua_resrvd_list[0];
+	rc = vea_reserve_key(args.vua_vsi, blk_cnt, h_ctxt, 1, r_list);
+	assert_rc_equal(rc, 0);
+	ext = d_list_entry(r_list->prev, struct vea_resrvd_ext, vre_link);
+	off_c = ext->vre_blk_off;
+	assert_int_equal(off_c, off[0][3] + blk_cnt);
+	rc = vea_cancel(args.vua_vsi, h_ctxt, r_list);
+	assert_rc_equal(rc, 0);
+	assert_int_equal(h_ctxt->vhc_off, off_s);
+
+	rc = vea_reserve_key(args.vua_vsi, blk_cnt, h_ctxt, 1, r_list);
+	assert_rc_equal(rc, 0);
+	ext = d_list_entry(r_list->prev, struct vea_resrvd_ext, vre_link);
+	assert_int_equal(ext->vre_blk_off, off_c);
+	rc = vea_cancel(args.vua_vsi, h_ctxt, r_list);
+	assert_rc_equal(rc, 0);
+
+	vea_hint_unload(h_ctxt);
+	args.vua_hint_ctxt[0] = NULL;
+	vea_unload(args.vua_vsi);
+	ut_teardown(&args);
+}
+
 static const struct CMUnitTest vea_uts[] = {
 	{ "vea_format", ut_format, NULL, NULL},
 	{ "vea_load", ut_load, NULL, NULL},
@@ -1279,7 +1538,10 @@ static const struct CMUnitTest vea_uts[] = {
 	  NULL, NULL},
 	{ "vea_free_invalid_space", ut_free_invalid_space, NULL, NULL},
 	{ "vea_interleaved_ops", ut_interleaved_ops, NULL, NULL},
-	{ "vea_fragmentation", ut_fragmentation, NULL, NULL}
+	{ "vea_fragmentation", ut_fragmentation, NULL, NULL},
+	{ "vea_bitmap", ut_bitmap, NULL, NULL},
+	{ "vea_ext_isolated", ut_ext_isolated, NULL, NULL},
+	{ "vea_hint_cursor", ut_hint_cursor, NULL, NULL}
 };
 
 int main(int argc, char **argv)
@@ -11,7 +11,6 @@
 #include "vea_internal.h"
 
 #define VEA_BLK_SZ	(4 * 1024)	/* 4K */
-#define VEA_TREE_ODR	20
 
 static void
 erase_md(struct umem_instance *umem, struct vea_space_df *md)
@@ -169,6 +168,7 @@ vea_unload(struct vea_space_info *vsi)
 {
 	D_ASSERT(vsi != NULL);
 	unload_space_info(vsi);
+	bitmap_fini(vsi);
 
 	/* Destroy the in-memory free extent tree */
 	if (daos_handle_is_valid(vsi->vsi_free_btr)) {
@@ -229,6 +229,7 @@ vea_load(struct umem_instance *umem, struct umem_tx_stage_data *txd,
 	D_INIT_LIST_HEAD(&vsi->vsi_agg_lru);
 	vsi->vsi_agg_btr = DAOS_HDL_INVAL;
 	vsi->vsi_vec_btr = DAOS_HDL_INVAL;
+	vsi->vsi_bitmap_btr = DAOS_HDL_INVAL;
 	vsi->vsi_agg_time = 0;
 	vsi->vsi_agg_scheduled = false;
 	vsi->vsi_unmap_ctxt = *unmap_ctxt;
@@ -257,6 +258,11 @@ vea_load(struct umem_instance *umem, struct umem_tx_stage_data *txd,
 	if (rc != 0)
 		goto error;
 
+	/* Initialize bitmap allocator for small extents */
+	rc = bitmap_init(vsi);
+	if (rc != 0)
+		goto error;
+
 	/* Load free space tracking info from SCM */
 	rc = load_space_info(vsi);
 	if (rc)
@@ -279,21 +285,24 @@ error:
  * Reserve attempting order:
  *
  * 1. Reserve from the free extent with 'hinted' start offset. (vsi_free_tree)
- * 2. Reserve from the largest free extent if it isn't non-active (extent age
+ * 2. Reserve a slot from the bitmap groups of the exact size class when the
+ *    bitmap allocator is enabled and the extent is small. (vsi_bitmap_cls)
+ * 3. Reserve from the largest free extent if it isn't non-active (extent age
  *    isn't VEA_EXT_AGE_MAX), otherwise, divide it in half-and-half and resreve
  *    from the latter half. (vfc_heap)
- * 3. Search & reserve from a bunch of extent size classed LRUs in first fit
+ * 4. Search & reserve from a bunch of extent size classed LRUs in first fit
  *    policy, larger & older free extent has priority. (vfc_lrus)
- * 4. Repeat the search in 3rd step to reserve an extent vector. (vsi_vec_tree)
- * 5. Fail reserve with ENOMEM if all above attempts fail.
+ * 5. Repeat the search in 4th step to reserve an extent vector. (vsi_vec_tree)
+ * 6. Fail reserve with ENOMEM if all above attempts fail.
  */
 int
-vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
-	    struct vea_hint_context *hint, d_list_t *resrvd_list)
+vea_reserve_key(struct vea_space_info *vsi, uint32_t blk_cnt,
+		struct vea_hint_context *hint, uint64_t key,
+		d_list_t *resrvd_list)
 {
 	struct vea_resrvd_ext *resrvd;
 	bool retry = true;
-	int rc = 0;
+	int stat_idx, rc = 0;
 
 	D_ASSERT(vsi != NULL);
 	D_ASSERT(resrvd_list != NULL);
@@ -304,22 +313,34 @@ vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
 
 	D_INIT_LIST_HEAD(&resrvd->vre_link);
 	resrvd->vre_hint_off = VEA_HINT_OFF_INVAL;
+	resrvd->vre_stream_off = VEA_HINT_OFF_INVAL;
 
 	/* Get hint offset */
-	hint_get(hint, &resrvd->vre_hint_off);
+	hint_get(hint, key, &resrvd->vre_hint_off);
+	hint_get(hint, 0, &resrvd->vre_stream_off);
 
 migrate:
 	/* Trigger free extents migration */
 	migrate_free_exts(vsi, false);
 
 	/* Reserve from hint offset */
+	stat_idx = STAT_RESRV_HINT;
 	rc = reserve_hint(vsi, blk_cnt, resrvd);
 	if (rc != 0)
 		goto error;
 	else if (resrvd->vre_blk_cnt != 0)
 		goto done;
 
+	/* Reserve from the bitmap groups, it accounts stat by itself */
+	stat_idx = STAT_MAX;
+	rc = reserve_bitmap(vsi, blk_cnt, resrvd);
+	if (rc != 0)
+		goto error;
+	else if (resrvd->vre_blk_cnt != 0)
+		goto done;
+
 	/* Reserve from the large extents */
+	stat_idx = STAT_RESRV_LARGE;
 	rc = reserve_large(vsi, blk_cnt, resrvd);
 	if (rc != 0)
 		goto error;
@@ -327,6 +348,7 @@ migrate:
 		goto done;
 
 	/* Reserve from the small extents */
+	stat_idx = STAT_RESRV_SMALL;
 	rc = reserve_small(vsi, blk_cnt, resrvd);
 	if (rc != 0)
 		goto error;
@@ -334,16 +356,26 @@ migrate:
 		goto done;
 
 	/* Reserve extent vector as the last resort */
+	stat_idx = STAT_RESRV_VEC;
 	rc = reserve_vector(vsi, blk_cnt, resrvd);
 
 	if (rc == -DER_NOSPACE && retry) {
 		vsi->vsi_agg_time = 0; /* force free extents migration */
+		/* Return the idle bitmap groups to the compound index */
+		bitmap_reclaim(vsi);
 		retry = false;
 		goto migrate;
 	} else if (rc != 0) {
 		goto error;
 	}
 done:
+	/*
+	 * The stats are accounted here instead of in reserve_large() and
+	 * reserve_small(), since bitmap groups are carved by them as well.
+	 */
+	if (stat_idx != STAT_MAX)
+		vsi->vsi_stat[stat_idx] += 1;
+
 	D_ASSERT(resrvd->vre_blk_off != VEA_HINT_OFF_INVAL);
 	D_ASSERT(resrvd->vre_blk_cnt == blk_cnt);
 
@@ -353,7 +385,7 @@ done:
 	vsi->vsi_stat[STAT_FREE_BLKS] -= blk_cnt;
 
 	/* Update hint offset */
-	hint_update(hint, resrvd->vre_blk_off + blk_cnt,
+	hint_update(hint, key, resrvd->vre_blk_off + blk_cnt,
 		    &resrvd->vre_hint_seq);
 
 	d_list_add_tail(&resrvd->vre_link, resrvd_list);
@@ -364,6 +396,13 @@ error:
 	return rc;
 }
 
+int
+vea_reserve(struct vea_space_info *vsi, uint32_t blk_cnt,
+	    struct vea_hint_context *hint, d_list_t *resrvd_list)
+{
+	return vea_reserve_key(vsi, blk_cnt, hint, 0, resrvd_list);
+}
+
 static int
 process_resrvd_list(struct vea_space_info *vsi, struct vea_hint_context *hint,
 		    d_list_t *resrvd_list, bool publish)
@@ -371,7 +410,7 @@ process_resrvd_list(struct vea_space_info *vsi, struct vea_hint_context *hint,
 	struct vea_resrvd_ext	*resrvd, *tmp;
 	struct vea_free_extent vfe = {0};
 	uint64_t		 seq_max = 0, seq_min = 0;
-	uint64_t		 off_c = 0, off_p = 0;
+	uint64_t		 off_c = 0, off_s = 0, off_p = 0;
 	uint64_t		 cur_time;
 	int			 rc = 0;
 
@@ -394,6 +433,7 @@ process_resrvd_list(struct vea_space_info *vsi, struct vea_hint_context *hint,
 		if (seq_min == 0) {
 			seq_min = resrvd->vre_hint_seq;
 			off_c = resrvd->vre_hint_off;
+			off_s = resrvd->vre_stream_off;
 		} else if (hint != NULL) {
 			D_ASSERT(seq_min < resrvd->vre_hint_seq);
 		}
@@ -426,9 +466,12 @@ process_resrvd_list(struct vea_space_info *vsi, struct vea_hint_context *hint,
 			goto error;
 	}
 
+	if (!publish)
+		hint_cursor_revert(hint, off_c, off_p);
+
 	rc = publish ? hint_tx_publish(vsi->vsi_umem, hint, off_p, seq_min,
 				       seq_max) :
-		       hint_cancel(hint, off_c, seq_min, seq_max);
+		       hint_cancel(hint, off_s, seq_min, seq_max);
 error:
 	d_list_for_each_entry_safe(resrvd, tmp, resrvd_list, vre_link) {
 		d_list_del_init(&resrvd->vre_link);
@@ -638,16 +681,29 @@ count_free_persistent(daos_handle_t ih, d_iov_t *key, d_iov_t *val,
 	return 0;
 }
 
+static inline int
+frags_hist_bucket(uint32_t blk_cnt)
+{
+	int	bkt = 0;
+
+	/* Bucket i holds extents in (16^(i-1), 16^i] blocks */
+	while (bkt < VEA_FRAGS_HIST_CNT - 1 && blk_cnt > (1U << (bkt * 4)))
+		bkt++;
+
+	return bkt;
+}
+
 static int
 count_free_transient(daos_handle_t ih, d_iov_t *key, d_iov_t *val,
 		     void *arg)
 {
 	struct vea_entry	*ve;
-	uint64_t		*free_blks = arg;
+	struct vea_stat		*stat = arg;
 
 	ve = (struct vea_entry *)val->iov_buf;
-	D_ASSERT(free_blks != NULL);
-	*free_blks += ve->ve_ext.vfe_blk_cnt;
+	D_ASSERT(stat != NULL);
+	stat->vs_free_transient += ve->ve_ext.vfe_blk_cnt;
+	stat->vs_frags_hist[frags_hist_bucket(ve->ve_ext.vfe_blk_cnt)]++;
 
 	return 0;
 }
@@ -688,11 +744,12 @@ vea_query(struct vea_space_info *vsi, struct vea_attr *attr,
 			return rc;
 
 		stat->vs_free_transient = 0;
+		memset(stat->vs_frags_hist, 0, sizeof(stat->vs_frags_hist));
 		rc = dbtree_iterate(vsi->vsi_free_btr, DAOS_INTENT_DEFAULT,
-				    false, count_free_transient,
-				    (void *)&stat->vs_free_transient);
+				    false, count_free_transient, (void *)stat);
 		if (rc != 0)
 			return rc;
+		stat->vs_free_transient += bitmap_free_blks(vsi);
 
 		stat->vs_large_frags = d_binheap_size(&vfc->vfc_heap);
 
@@ -724,11 +781,46 @@ vea_query(struct vea_space_info *vsi, struct vea_attr *attr,
 		stat->vs_resrv_large = vsi->vsi_stat[STAT_RESRV_LARGE];
 		stat->vs_resrv_small = vsi->vsi_stat[STAT_RESRV_SMALL];
 		stat->vs_resrv_vec = vsi->vsi_stat[STAT_RESRV_VEC];
+		stat->vs_resrv_bitmap = vsi->vsi_stat[STAT_RESRV_BITMAP];
 	}
 
 	return 0;
 }
 
+bool
+vea_ext_isolated(struct vea_space_info *vsi, uint64_t blk_off,
+		 uint32_t blk_cnt)
+{
+	struct vea_free_extent	*vfe;
+	d_iov_t			 key, val;
+	uint64_t		 off = blk_off;
+	int			 rc;
+
+	D_ASSERT(vsi != NULL);
+	D_ASSERT(daos_handle_is_valid(vsi->vsi_md_free_btr));
+
+	/* Free extent adjacent to the extent head */
+	d_iov_set(&key, &off, sizeof(off));
+	d_iov_set(&val, NULL, 0);
+	rc = dbtree_fetch(vsi->vsi_md_free_btr, BTR_PROBE_LT,
+			  DAOS_INTENT_DEFAULT, &key, NULL, &val);
+	if (rc)
+		return false;
+
+	vfe = (struct vea_free_extent *)val.iov_buf;
+	if (vfe->vfe_blk_off + vfe->vfe_blk_cnt != blk_off)
+		return false;
+
+	/* Free extent adjacent to the extent tail */
+	off = blk_off + blk_cnt;
+	d_iov_set(&key, &off, sizeof(off));
+	d_iov_set(&val, NULL, 0);
+	rc = dbtree_fetch(vsi->vsi_md_free_btr, BTR_PROBE_EQ,
+			  DAOS_INTENT_DEFAULT, &key, NULL, &val);
+
+	return rc == 0;
+}
+
 void
 vea_flush(struct vea_space_info *vsi, bool plug)
 {
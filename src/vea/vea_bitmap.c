@@ -0,0 +1,598 @@
+/**
+ * (C) Copyright 2021 Intel Corporation.
+ *
+ * SPDX-License-Identifier: BSD-2-Clause-Patent
+ */
+#define D_LOGFAC	DD_FAC(vos)
+
+#include <daos/common.h>
+#include <daos/btree_class.h>
+#include <daos/dtx.h>
+#include "vea_internal.h"
+
+/*
+ * Bitmap allocator for small extents.
+ *
+ * Reservations no larger than VEA_BITMAP_MAX_MB are served from bitmap
+ * groups, each group is a contiguous extent carved from the compound index
+ * and dedicated to one size class (exact block count), every slot in the
+ * group is tracked by one bit. Groups with free slots are linked in the
+ * per-class available list, so reserving a slot doesn't need to scan the
+ * size classed LRUs, and freeing a slot is just a bit clear.
+ *
+ * The bitmaps are purely transient, the persistent free extent tree is still
+ * the only source of truth, so the bitmap groups are simply rebuilt on
+ * demand after restart.
+ */
+
+/*
+ * Record of the bitmap group tree, always keep the offset as first field,
+ * since it's the direct key of DBTREE_CLASS_IV.
+ */
+struct vea_bitmap_rec {
+	uint64_t		 vbr_blk_off;
+	struct vea_bitmap_grp	*vbr_grp;
+};
+
+static inline uint32_t
+grp_blks(struct vea_bitmap_grp *grp)
+{
+	return grp->vbg_class * grp->vbg_bits;
+}
+
+static inline bool
+slot_isset(struct vea_bitmap_grp *grp, uint32_t idx)
+{
+	return grp->vbg_bmap[idx / VEA_BITMAP_WORD_BITS] &
+		(1ULL << (idx % VEA_BITMAP_WORD_BITS));
+}
+
+static inline void
+slot_set(struct vea_bitmap_grp *grp, uint32_t idx)
+{
+	grp->vbg_bmap[idx / VEA_BITMAP_WORD_BITS] |=
+		(1ULL << (idx % VEA_BITMAP_WORD_BITS));
+}
+
+static inline void
+slot_clear(struct vea_bitmap_grp *grp, uint32_t idx)
+{
+	grp->vbg_bmap[idx / VEA_BITMAP_WORD_BITS] &=
+		~(1ULL << (idx % VEA_BITMAP_WORD_BITS));
+}
+
+static inline struct vea_bitmap_class *
+grp2class(struct vea_space_info *vsi, struct vea_bitmap_grp *grp)
+{
+	D_ASSERT(grp->vbg_class > 0 &&
+		 grp->vbg_class <= vsi->vsi_bitmap_cls_cnt);
+	return &vsi->vsi_bitmap_cls[grp->vbg_class - 1];
+}
+
+/*
+ * Find the bitmap group covering @blk_off, if there isn't such group, return
+ * the start offset of next group in @next (UINT64_MAX if no more group).
+ */
+static int
+grp_lookup(struct vea_space_info *vsi, uint64_t blk_off,
+	   struct vea_bitmap_grp **grp_out, uint64_t *next)
+{
+	struct vea_bitmap_grp	*grp;
+	d_iov_t			 key, val;
+	int			 rc;
+
+	*grp_out = NULL;
+	if (next != NULL)
+		*next = UINT64_MAX;
+
+	d_iov_set(&key, &blk_off, sizeof(blk_off));
+	d_iov_set(&val, NULL, 0);
+	rc = dbtree_fetch(vsi->vsi_bitmap_btr, BTR_PROBE_LE,
+			  DAOS_INTENT_DEFAULT, &key, NULL, &val);
+	if (rc && rc != -DER_NONEXIST)
+		return rc;
+
+	if (rc == 0) {
+		grp = ((struct vea_bitmap_rec *)val.iov_buf)->vbr_grp;
+		D_ASSERT(grp->vbg_blk_off <= blk_off);
+		if (blk_off < grp->vbg_blk_off + grp_blks(grp)) {
+			*grp_out = grp;
+			return 0;
+		}
+	}
+
+	if (next == NULL)
+		return 0;
+
+	d_iov_set(&key, &blk_off, sizeof(blk_off));
+	d_iov_set(&val, NULL, 0);
+	rc = dbtree_fetch(vsi->vsi_bitmap_btr, BTR_PROBE_GE,
+			  DAOS_INTENT_DEFAULT, &key, NULL, &val);
+	if (rc == -DER_NONEXIST)
+		return 0;
+	else if (rc)
+		return rc;
+
+	grp = ((struct vea_bitmap_rec *)val.iov_buf)->vbr_grp;
+	D_ASSERT(grp->vbg_blk_off > blk_off);
+	*next = grp->vbg_blk_off;
+
+	return 0;
+}
+
+/* Carve a new bitmap group for the size class from the compound index */
+static int
+grp_create(struct vea_space_info *vsi, uint32_t blk_cnt,
+	   struct vea_bitmap_grp **grp_out)
+{
+	struct vea_bitmap_class	*cls = &vsi->vsi_bitmap_cls[blk_cnt - 1];
+	struct vea_bitmap_grp	*grp;
+	struct vea_resrvd_ext	 ext = { 0 };
+	struct vea_bitmap_rec	 rec;
+	struct vea_free_extent	 vfe;
+	d_iov_t			 key, val;
+	uint32_t		 tot_blks;
+	int			 rc;
+
+	*grp_out = NULL;
+	tot_blks = blk_cnt * cls->vbc_bits;
+	ext.vre_hint_off = VEA_HINT_OFF_INVAL;
+
+	rc = reserve_large(vsi, tot_blks, &ext);
+	if (rc == 0 && ext.vre_blk_cnt == 0)
+		rc = reserve_small(vsi, tot_blks, &ext);
+	/* Too fragmented to carve a group, fallback to extent allocation */
+	if (rc || ext.vre_blk_cnt == 0)
+		return rc;
+
+	D_ALLOC(grp, sizeof(*grp) + cls->vbc_bits / 8);
+	if (grp == NULL) {
+		rc = -DER_NOMEM;
+		goto error;
+	}
+
+	D_INIT_LIST_HEAD(&grp->vbg_link);
+	grp->vbg_blk_off = ext.vre_blk_off;
+	grp->vbg_class = blk_cnt;
+	grp->vbg_bits = cls->vbc_bits;
+	grp->vbg_free = cls->vbc_bits;
+	grp->vbg_hint = 0;
+
+	rec.vbr_blk_off = grp->vbg_blk_off;
+	rec.vbr_grp = grp;
+	d_iov_set(&key, &rec.vbr_blk_off, sizeof(rec.vbr_blk_off));
+	d_iov_set(&val, &rec, sizeof(rec));
+	rc = dbtree_update(vsi->vsi_bitmap_btr, &key, &val);
+	if (rc) {
+		D_ERROR("Failed to insert bitmap group: "DF_RC"\n", DP_RC(rc));
+		D_FREE(grp);
+		goto error;
+	}
+
+	d_list_add(&grp->vbg_link, &cls->vbc_avail);
+	*grp_out = grp;
+
+	D_DEBUG(DB_IO, "Bitmap group ["DF_U64", %u] class:%u created\n",
+		grp->vbg_blk_off, grp_blks(grp), blk_cnt);
+	return 0;
+error:
+	vfe.vfe_blk_off = ext.vre_blk_off;
+	vfe.vfe_blk_cnt = ext.vre_blk_cnt;
+	vfe.vfe_flags = 0;
+	if (daos_gettime_coarse(&vfe.vfe_age))
+		vfe.vfe_age = 0;
+	if (compound_free(vsi, &vfe,
+			  VEA_FL_NO_ACCOUNTING | VEA_FL_NO_BITMAP))
+		D_ERROR("Failed to return ["DF_U64", %u]\n",
+			vfe.vfe_blk_off, vfe.vfe_blk_cnt);
+	return rc;
+}
+
+/* Return a fully free bitmap group back to the compound index */
+static int
+grp_release(struct vea_space_info *vsi, struct vea_bitmap_grp *grp)
+{
+	struct vea_free_extent	vfe;
+	d_iov_t			key;
+	int			rc;
+
+	D_ASSERT(grp->vbg_free == grp->vbg_bits);
+
+	vfe.vfe_blk_off = grp->vbg_blk_off;
+	vfe.vfe_blk_cnt = grp_blks(grp);
+	vfe.vfe_flags = 0;
+	rc = daos_gettime_coarse(&vfe.vfe_age);
+	if (rc)
+		return rc;
+
+	d_iov_set(&key, &vfe.vfe_blk_off, sizeof(vfe.vfe_blk_off));
+	rc = dbtree_delete(vsi->vsi_bitmap_btr, BTR_PROBE_EQ, &key, NULL);
+	if (rc) {
+		D_ERROR("Failed to delete bitmap group ["DF_U64", %u]: "
+			DF_RC"\n", vfe.vfe_blk_off, vfe.vfe_blk_cnt, DP_RC(rc));
+		return rc;
+	}
+
+	D_DEBUG(DB_IO, "Bitmap group ["DF_U64", %u] class:%u released\n",
+		vfe.vfe_blk_off, vfe.vfe_blk_cnt, grp->vbg_class);
+
+	d_list_del(&grp->vbg_link);
+	D_FREE(grp);
+
+	/* The free blocks in group are already accounted */
+	return compound_free(vsi, &vfe,
+			     VEA_FL_NO_ACCOUNTING | VEA_FL_NO_BITMAP);
+}
+
+static uint32_t
+grp_alloc_slot(struct vea_bitmap_grp *grp)
+{
+	uint32_t	words = grp->vbg_bits / VEA_BITMAP_WORD_BITS;
+	uint32_t	i, w, bit;
+
+	D_ASSERT(grp->vbg_free > 0);
+	for (i = 0; i < words; i++) {
+		w = (grp->vbg_hint + i) % words;
+		if (grp->vbg_bmap[w] == UINT64_MAX)
+			continue;
+
+		bit = __builtin_ctzll(~grp->vbg_bmap[w]);
+		grp->vbg_hint = w;
+		return w * VEA_BITMAP_WORD_BITS + bit;
+	}
+
+	D_ASSERTF(0, "Bitmap group ["DF_U64", %u] free:%u has no free slot\n",
+		  grp->vbg_blk_off, grp_blks(grp), grp->vbg_free);
+	return 0;
+}
+
+int
+reserve_bitmap(struct vea_space_info *vsi, uint32_t blk_cnt,
+	       struct vea_resrvd_ext *resrvd)
+{
+	struct vea_bitmap_class	*cls;
+	struct vea_bitmap_grp	*grp = NULL;
+	uint32_t		 slot = 0;
+	int			 rc;
+
+	if (!bitmap_enabled(vsi) || blk_cnt > vsi->vsi_bitmap_cls_cnt)
+		return 0;
+
+	cls = &vsi->vsi_bitmap_cls[blk_cnt - 1];
+	if (cls->vbc_bits == 0)
+		return 0;
+
+	/* Try the hinted slot first to keep the I/O stream sequential */
+	if (resrvd->vre_hint_off != VEA_HINT_OFF_INVAL) {
+		rc = grp_lookup(vsi, resrvd->vre_hint_off, &grp, NULL);
+		if (rc)
+			return rc;
+
+		if (grp != NULL) {
+			uint64_t rel;
+
+			rel = resrvd->vre_hint_off - grp->vbg_blk_off;
+			slot = rel / blk_cnt;
+			if (grp->vbg_class != blk_cnt ||
+			    (rel % blk_cnt) != 0 || slot_isset(grp, slot))
+				grp = NULL;
+		}
+	}
+
+	if (grp == NULL) {
+		if (d_list_empty(&cls->vbc_avail)) {
+			rc = grp_create(vsi, blk_cnt, &grp);
+			if (rc || grp == NULL)
+				return rc;
+		}
+
+		grp = d_list_entry(cls->vbc_avail.next, struct vea_bitmap_grp,
+				   vbg_link);
+		slot = grp_alloc_slot(grp);
+	}
+
+	D_ASSERT(!slot_isset(grp, slot));
+	slot_set(grp, slot);
+	grp->vbg_free--;
+	if (grp->vbg_free == 0)
+		d_list_move_tail(&grp->vbg_link, &cls->vbc_full);
+
+	resrvd->vre_blk_off = grp->vbg_blk_off + (uint64_t)slot * blk_cnt;
+	resrvd->vre_blk_cnt = blk_cnt;
+
+	vsi->vsi_stat[STAT_RESRV_BITMAP] += 1;
+
+	D_DEBUG(DB_IO, "["DF_U64", %u]\n", resrvd->vre_blk_off,
+		resrvd->vre_blk_cnt);
+
+	return 0;
+}
+
+static inline bool
+grp_is_last_avail(struct vea_bitmap_class *cls, struct vea_bitmap_grp *grp)
+{
+	return cls->vbc_avail.next == &grp->vbg_link &&
+	       cls->vbc_avail.prev == &grp->vbg_link;
+}
+
+static int
+grp_free(struct vea_space_info *vsi, struct vea_bitmap_grp *grp,
+	 struct vea_free_extent *vfe, unsigned int flags)
+{
+	struct vea_bitmap_class	*cls = grp2class(vsi, grp);
+	uint64_t		 rel = vfe->vfe_blk_off - grp->vbg_blk_off;
+	uint32_t		 first, last, i, freed = 0;
+	bool			 was_full = (grp->vbg_free == 0);
+
+	first = (rel + grp->vbg_class - 1) / grp->vbg_class;
+	last = (rel + vfe->vfe_blk_cnt) / grp->vbg_class;
+
+	/*
+	 * Slot is the allocation unit, a partially freed slot stays allocated
+	 * until the bitmap groups being rebuilt on next load, such temporary
+	 * space leak is tolerable.
+	 */
+	if ((rel % grp->vbg_class) != 0 ||
+	    ((rel + vfe->vfe_blk_cnt) % grp->vbg_class) != 0)
+		D_ERROR("Free ["DF_U64", %u] unaligned to bitmap class %u\n",
+			vfe->vfe_blk_off, vfe->vfe_blk_cnt, grp->vbg_class);
+
+	for (i = first; i < last; i++) {
+		if (!slot_isset(grp, i)) {
+			D_ERROR("Double free slot %u of bitmap group ["DF_U64
+				", %u]\n", i, grp->vbg_blk_off, grp_blks(grp));
+			return -DER_INVAL;
+		}
+		slot_clear(grp, i);
+		grp->vbg_free++;
+		freed++;
+	}
+
+	if (freed == 0)
+		return 0;
+
+	if (!(flags & VEA_FL_NO_ACCOUNTING))
+		vsi->vsi_stat[STAT_FREE_BLKS] += (uint64_t)freed *
+						 grp->vbg_class;
+
+	if (first / VEA_BITMAP_WORD_BITS < grp->vbg_hint)
+		grp->vbg_hint = first / VEA_BITMAP_WORD_BITS;
+
+	if (was_full)
+		d_list_move_tail(&grp->vbg_link, &cls->vbc_avail);
+
+	/* Keep the last available group to avoid carving back and forth */
+	if (grp->vbg_free == grp->vbg_bits && !grp_is_last_avail(cls, grp))
+		return grp_release(vsi, grp);
+
+	return 0;
+}
+
+/*
+ * Free extent which could be covered by bitmap groups, the portions not
+ * covered by any group are freed to the compound index.
+ */
+int
+bitmap_free(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+	    unsigned int flags)
+{
+	struct vea_bitmap_grp	*grp;
+	struct vea_free_extent	 piece;
+	uint64_t		 cur, end, next;
+	int			 rc;
+
+	D_ASSERT(bitmap_enabled(vsi));
+	cur = vfe->vfe_blk_off;
+	end = vfe->vfe_blk_off + vfe->vfe_blk_cnt;
+
+	while (cur < end) {
+		rc = grp_lookup(vsi, cur, &grp, &next);
+		if (rc)
+			return rc;
+
+		piece = *vfe;
+		piece.vfe_blk_off = cur;
+		if (grp == NULL) {
+			piece.vfe_blk_cnt = min(end, next) - cur;
+			rc = compound_free(vsi, &piece,
+					   flags | VEA_FL_NO_BITMAP);
+		} else {
+			piece.vfe_blk_cnt = min(end, grp->vbg_blk_off +
+						grp_blks(grp)) - cur;
+			rc = grp_free(vsi, grp, &piece, flags);
+		}
+
+		if (rc)
+			return rc;
+		cur += piece.vfe_blk_cnt;
+	}
+
+	return 0;
+}
+
+/* Return all the fully free bitmap groups back to the compound index */
+void
+bitmap_reclaim(struct vea_space_info *vsi)
+{
+	struct vea_bitmap_grp	*grp, *tmp;
+	int			 i, rc;
+
+	if (!bitmap_enabled(vsi))
+		return;
+
+	for (i = 0; i < vsi->vsi_bitmap_cls_cnt; i++) {
+		d_list_t *avail = &vsi->vsi_bitmap_cls[i].vbc_avail;
+
+		d_list_for_each_entry_safe(grp, tmp, avail, vbg_link) {
+			if (grp->vbg_free != grp->vbg_bits)
+				continue;
+
+			rc = grp_release(vsi, grp);
+			if (rc) {
+				D_ERROR("Failed to release bitmap group: "
+					DF_RC"\n", DP_RC(rc));
+				return;
+			}
+		}
+	}
+}
+
+/* Free blocks tracked by bitmap groups */
+uint64_t
+bitmap_free_blks(struct vea_space_info *vsi)
+{
+	struct vea_bitmap_grp	*grp;
+	uint64_t		 free_blks = 0;
+	int			 i;
+
+	if (!bitmap_enabled(vsi))
+		return 0;
+
+	for (i = 0; i < vsi->vsi_bitmap_cls_cnt; i++) {
+		d_list_t *avail = &vsi->vsi_bitmap_cls[i].vbc_avail;
+
+		d_list_for_each_entry(grp, avail, vbg_link)
+			free_blks += (uint64_t)grp->vbg_free * grp->vbg_class;
+	}
+
+	return free_blks;
+}
+
+/**
+ * Verify if an extent is allocated in bitmap groups.
+ *
+ * \return			0 - Allocated or not covered by any group
+ *				1 - Free in bitmap groups
+ *				Negative value on error
+ */
+int
+bitmap_verify_alloc(struct vea_space_info *vsi, uint64_t off, uint32_t cnt)
+{
+	struct vea_bitmap_grp	*grp;
+	uint64_t		 cur = off, end = off + cnt, next, grp_end;
+	uint32_t		 i, first, last, alloc = 0, unused = 0;
+	int			 rc;
+
+	if (!bitmap_enabled(vsi))
+		return 0;
+
+	while (cur < end) {
+		rc = grp_lookup(vsi, cur, &grp, &next);
+		if (rc)
+			return rc;
+
+		if (grp == NULL) {
+			cur = min(end, next);
+			continue;
+		}
+
+		grp_end = min(end, grp->vbg_blk_off + grp_blks(grp));
+		first = (cur - grp->vbg_blk_off) / grp->vbg_class;
+		last = (grp_end - grp->vbg_blk_off + grp->vbg_class - 1) /
+			grp->vbg_class;
+		for (i = first; i < last; i++) {
+			if (slot_isset(grp, i))
+				alloc++;
+			else
+				unused++;
+		}
+		cur = grp_end;
+	}
+
+	if (unused == 0)
+		return 0;
+
+	return alloc == 0 ? 1 : -DER_INVAL;
+}
+
+int
+bitmap_init(struct vea_space_info *vsi)
+{
+	struct vea_space_df	*md = vsi->vsi_md;
+	struct umem_attr	 uma;
+	uint64_t		 max_blks;
+	uint32_t		 cls_cnt, bits;
+	bool			 enabled = false;
+	int			 i, rc;
+
+	vsi->vsi_bitmap_btr = DAOS_HDL_INVAL;
+	vsi->vsi_bitmap_cls = NULL;
+	vsi->vsi_bitmap_cls_cnt = 0;
+
+	d_getenv_bool("DAOS_VEA_BITMAP_ENABLED", &enabled);
+	if (!enabled)
+		return 0;
+
+	cls_cnt = (VEA_BITMAP_MAX_MB << 20) / md->vsd_blk_sz;
+	if (cls_cnt == 0)
+		return 0;
+
+	memset(&uma, 0, sizeof(uma));
+	uma.uma_id = UMEM_CLASS_VMEM;
+	/* Create in-memory bitmap group tree */
+	rc = dbtree_create(DBTREE_CLASS_IV, BTR_FEAT_DIRECT_KEY, VEA_TREE_ODR,
+			   &uma, NULL, &vsi->vsi_bitmap_btr);
+	if (rc != 0)
+		return rc;
+
+	D_ALLOC_ARRAY(vsi->vsi_bitmap_cls, cls_cnt);
+	if (vsi->vsi_bitmap_cls == NULL) {
+		bitmap_fini(vsi);
+		return -DER_NOMEM;
+	}
+	vsi->vsi_bitmap_cls_cnt = cls_cnt;
+
+	/*
+	 * Each group is around VEA_BITMAP_GRP_BLKS blocks, it can't exceed
+	 * 1/VEA_BITMAP_GRP_DIV of the device, otherwise, groups for various
+	 * classes could eat up a small device. A class is disabled when its
+	 * group can't hold at least VEA_BITMAP_WORD_BITS slots.
+	 */
+	max_blks = md->vsd_tot_blks / VEA_BITMAP_GRP_DIV;
+	for (i = 0; i < cls_cnt; i++) {
+		struct vea_bitmap_class *cls = &vsi->vsi_bitmap_cls[i];
+
+		D_INIT_LIST_HEAD(&cls->vbc_avail);
+		D_INIT_LIST_HEAD(&cls->vbc_full);
+
+		bits = max(VEA_BITMAP_GRP_BLKS / (i + 1), VEA_BITMAP_WORD_BITS);
+		bits = min((uint64_t)bits, max_blks / (i + 1));
+		cls->vbc_bits = bits & ~(VEA_BITMAP_WORD_BITS - 1);
+	}
+
+	return 0;
+}
+
+void
+bitmap_fini(struct vea_space_info *vsi)
+{
+	struct vea_bitmap_grp	*grp, *tmp;
+	int			 i;
+
+	if (daos_handle_is_valid(vsi->vsi_bitmap_btr)) {
+		dbtree_destroy(vsi->vsi_bitmap_btr, NULL);
+		vsi->vsi_bitmap_btr = DAOS_HDL_INVAL;
+	}
+
+	if (vsi->vsi_bitmap_cls == NULL)
+		return;
+
+	for (i = 0; i < vsi->vsi_bitmap_cls_cnt; i++) {
+		struct vea_bitmap_class *cls = &vsi->vsi_bitmap_cls[i];
+
+		d_list_for_each_entry_safe(grp, tmp, &cls->vbc_avail,
+					   vbg_link) {
+			d_list_del(&grp->vbg_link);
+			D_FREE(grp);
+		}
+		d_list_for_each_entry_safe(grp, tmp, &cls->vbc_full,
+					   vbg_link) {
+			d_list_del(&grp->vbg_link);
+			D_FREE(grp);
+		}
+	}
+
+	D_FREE(vsi->vsi_bitmap_cls);
+	vsi->vsi_bitmap_cls = NULL;
+	vsi->vsi_bitmap_cls_cnt = 0;
+}
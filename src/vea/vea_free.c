@@ -265,6 +265,10 @@ compound_free(struct vea_space_info *vsi, struct vea_free_extent *vfe,
 	d_iov_t			 key, val;
 	int			 rc;
 
+	/* Freed extent could be covered by bitmap groups */
+	if (bitmap_enabled(vsi) && !(flags & VEA_FL_NO_BITMAP))
+		return bitmap_free(vsi, vfe, flags);
+
 	rc = merge_free_ext(vsi, vfe, VEA_TYPE_COMPOUND, flags);
 	if (rc < 0) {
 		return rc;
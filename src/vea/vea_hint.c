@@ -8,23 +8,99 @@
 #include <daos/common.h>
 #include "vea_internal.h"
 
+static struct vea_hint_cursor *
+cursor_lookup(struct vea_hint_context *hint, uint64_t key, bool create)
+{
+	struct vea_hint_cursor	*cur, *victim = NULL;
+	int			 i;
+
+	for (i = 0; i < VEA_HINT_CURSOR_MAX; i++) {
+		cur = &hint->vhc_cursors[i];
+		if (cur->vhu_key == key)
+			goto found;
+
+		/* Pick an unused slot or the least recently used one */
+		if (victim == NULL || (victim->vhu_key != 0 &&
+		    (cur->vhu_key == 0 || cur->vhu_clock < victim->vhu_clock)))
+			victim = cur;
+	}
+
+	if (!create)
+		return NULL;
+
+	cur = victim;
+	cur->vhu_key = key;
+	cur->vhu_off = VEA_HINT_OFF_INVAL;
+found:
+	cur->vhu_clock = ++hint->vhc_clock;
+	return cur;
+}
+
 void
-hint_get(struct vea_hint_context *hint, uint64_t *off)
+hint_get(struct vea_hint_context *hint, uint64_t key, uint64_t *off)
 {
-	if (hint != NULL) {
-		D_ASSERT(off != NULL);
+	struct vea_hint_cursor *cur;
+
+	if (hint == NULL)
+		return;
+
+	D_ASSERT(off != NULL);
+	if (key == 0) {
 		*off = hint->vhc_off;
+		return;
 	}
+
+	/*
+	 * A writer without cursor starts from the offset chosen by the
+	 * allocator instead of appending to the stream, so that it won't
+	 * interleave with other sequential writers.
+	 */
+	cur = cursor_lookup(hint, key, false);
+	*off = cur != NULL ? cur->vhu_off : VEA_HINT_OFF_INVAL;
 }
 
 void
-hint_update(struct vea_hint_context *hint, uint64_t off, uint64_t *seq)
+hint_update(struct vea_hint_context *hint, uint64_t key, uint64_t off,
+	    uint64_t *seq)
 {
+	struct vea_hint_cursor *cur;
+
 	if (hint != NULL) {
 		D_ASSERT(seq != NULL);
 		hint->vhc_off = off;
 		hint->vhc_seq++;
 		*seq = hint->vhc_seq;
+
+		if (key != 0) {
+			cur = cursor_lookup(hint, key, true);
+			cur->vhu_off = off;
+		}
+	}
+}
+
+/*
+ * Rewind the cursor which was advanced to @end by the canceled reservations
+ * back to @off. The cursor is dropped if it had no offset before.
+ */
+void
+hint_cursor_revert(struct vea_hint_context *hint, uint64_t off, uint64_t end)
+{
+	struct vea_hint_cursor	*cur;
+	int			 i;
+
+	if (hint == NULL)
+		return;
+
+	for (i = 0; i < VEA_HINT_CURSOR_MAX; i++) {
+		cur = &hint->vhc_cursors[i];
+		if (cur->vhu_key == 0 || cur->vhu_off != end)
+			continue;
+
+		if (off == VEA_HINT_OFF_INVAL)
+			cur->vhu_key = 0;
+		else
+			cur->vhu_off = off;
+		return;
 	}
 }
 
@@ -14,6 +14,24 @@
 #include <daos_srv/vea.h>
 
 #define VEA_MAGIC	(0xea201804)
+#define VEA_TREE_ODR	20
+
+/* Max number of per-writer allocation cursors tracked by a hint context */
+#define VEA_HINT_CURSOR_MAX	32
+
+/*
+ * In-memory allocation cursor of a sequential writer (e.g. an object) in
+ * an I/O stream. Cursors are never persisted, they are rebuilt on demand
+ * after restart.
+ */
+struct vea_hint_cursor {
+	/* Writer key, 0 means unused slot */
+	uint64_t		 vhu_key;
+	/* Block offset following the last reservation of the writer */
+	uint64_t		 vhu_off;
+	/* LRU clock of last access */
+	uint64_t		 vhu_clock;
+};
 
 /* Per I/O stream hint context */
 struct vea_hint_context {
@@ -22,6 +40,10 @@ struct vea_hint_context {
 	uint64_t		 vhc_off;
 	/* In-memory hint sequence */
 	uint64_t		 vhc_seq;
+	/* LRU clock for the cursor table */
+	uint64_t		 vhc_clock;
+	/* Bounded per-writer cursor table */
+	struct vea_hint_cursor	 vhc_cursors[VEA_HINT_CURSOR_MAX];
 };
 
 /* Free extent informat stored in the in-memory compound free extent index */
@@ -42,6 +64,41 @@ struct vea_entry {
 #define VEA_HINT_OFF_INVAL	0	/* Invalid hint offset */
 #define VEA_MIGRATE_INTVL	10	/* Seconds */
 
+#define VEA_BITMAP_MAX_MB	1	/* Bitmap allocator threshold in MB */
+#define VEA_BITMAP_GRP_BLKS	8192	/* Preferred bitmap group size */
+#define VEA_BITMAP_GRP_DIV	32	/* Group size <= 1/32 of total blocks */
+#define VEA_BITMAP_WORD_BITS	64
+
+/*
+ * Bitmap group, a contiguous extent carved from the compound index which is
+ * divided into equally sized slots, each slot is tracked by one bit.
+ */
+struct vea_bitmap_grp {
+	/* Link to vbc_avail or vbc_full of the owning bitmap class */
+	d_list_t		vbg_link;
+	/* Start block offset of the group */
+	uint64_t		vbg_blk_off;
+	/* Slot size in blocks, it's the block count of the size class */
+	uint32_t		vbg_class;
+	/* Total slots, always multiple of VEA_BITMAP_WORD_BITS */
+	uint32_t		vbg_bits;
+	/* Free slots */
+	uint32_t		vbg_free;
+	/* Bitmap word to start searching free slot from */
+	uint32_t		vbg_hint;
+	uint64_t		vbg_bmap[0];
+};
+
+/* Bitmap groups for extents of exactly the same block count */
+struct vea_bitmap_class {
+	/* Groups with free slots */
+	d_list_t		vbc_avail;
+	/* Fully allocated groups */
+	d_list_t		vbc_full;
+	/* Slots per group, 0 means the class is disabled */
+	uint32_t		vbc_bits;
+};
+
 struct free_ext_cursor {
 	struct vea_entry	*fec_cur;
 	int			 fec_idx;
@@ -82,6 +139,7 @@ enum {
 	STAT_RESRV_LARGE,
 	STAT_RESRV_SMALL,
 	STAT_RESRV_VEC,
+	STAT_RESRV_BITMAP,
 	STAT_FREE_BLKS,
 	STAT_MAX,
 };
@@ -118,6 +176,14 @@ struct vea_space_info {
 	daos_handle_t			 vsi_agg_btr;
 	/* Last aggregation time */
 	uint64_t			 vsi_agg_time;
+	/*
+	 * Bitmap classes for small extents, indexed by block count - 1,
+	 * NULL when the bitmap allocator is disabled.
+	 */
+	struct vea_bitmap_class		*vsi_bitmap_cls;
+	uint32_t			 vsi_bitmap_cls_cnt;
+	/* Bitmap group tree sorted by group start offset */
+	daos_handle_t			 vsi_bitmap_btr;
 	/* Unmap context to perform unmap against freed extent */
 	struct vea_unmap_context	 vsi_unmap_ctxt;
 	/* Statistics */
@@ -133,8 +199,15 @@ static inline bool ext_is_idle(struct vea_free_extent *vfe)
 enum vea_free_flags {
 	VEA_FL_NO_MERGE		= (1 << 0),
 	VEA_FL_NO_ACCOUNTING	= (1 << 1),
+	/* Don't route the freed extent to bitmap groups */
+	VEA_FL_NO_BITMAP	= (1 << 2),
 };
 
+static inline bool bitmap_enabled(struct vea_space_info *vsi)
+{
+	return vsi->vsi_bitmap_cls != NULL;
+}
+
 /* vea_init.c */
 void destroy_free_class(struct vea_free_class *vfc);
 int create_free_class(struct vea_free_class *vfc, struct vea_space_df *md);
@@ -171,9 +244,24 @@ int persistent_free(struct vea_space_info *vsi, struct vea_free_extent *vfe);
 int aggregated_free(struct vea_space_info *vsi, struct vea_free_extent *vfe);
 void migrate_free_exts(struct vea_space_info *vsi, bool add_tx_cb);
 
+/* vea_bitmap.c */
+int bitmap_init(struct vea_space_info *vsi);
+void bitmap_fini(struct vea_space_info *vsi);
+int reserve_bitmap(struct vea_space_info *vsi, uint32_t blk_cnt,
+		   struct vea_resrvd_ext *resrvd);
+int bitmap_free(struct vea_space_info *vsi, struct vea_free_extent *vfe,
+		unsigned int flags);
+void bitmap_reclaim(struct vea_space_info *vsi);
+uint64_t bitmap_free_blks(struct vea_space_info *vsi);
+int bitmap_verify_alloc(struct vea_space_info *vsi, uint64_t off,
+			uint32_t cnt);
+
 /* vea_hint.c */
-void hint_get(struct vea_hint_context *hint, uint64_t *off);
-void hint_update(struct vea_hint_context *hint, uint64_t off, uint64_t *seq);
+void hint_get(struct vea_hint_context *hint, uint64_t key, uint64_t *off);
+void hint_update(struct vea_hint_context *hint, uint64_t key, uint64_t off,
+		 uint64_t *seq);
+void hint_cursor_revert(struct vea_hint_context *hint, uint64_t off,
+			uint64_t end);
 int hint_cancel(struct vea_hint_context *hint, uint64_t off, uint64_t seq_min,
 		uint64_t seq_max);
 int hint_tx_publish(struct umem_instance *umm, struct vea_hint_context *hint,
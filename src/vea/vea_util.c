@@ -217,10 +217,15 @@ vea_verify_alloc(struct vea_space_info *vsi, bool transient, uint64_t off,
 	if (rc)
 		return rc;
 
-	if (transient)
+	if (transient) {
+		/* Free blocks in bitmap groups aren't in the free tree */
+		rc = bitmap_verify_alloc(vsi, off, cnt);
+		if (rc)
+			return rc;
 		btr_hdl = vsi->vsi_free_btr;
-	else
+	} else {
 		btr_hdl = vsi->vsi_md_free_btr;
+	}
 
 	D_ASSERT(daos_handle_is_valid(btr_hdl));
 	d_iov_set(&key, &vfe.vfe_blk_off, sizeof(vfe.vfe_blk_off));
@@ -133,6 +133,12 @@ struct agg_merge_window {
 	/* I/O context for transferring data on flush */
 	struct agg_io_context		 mw_io_ctxt;
 	bool				 mw_csum_support;
+	/* Relocate isolated NVMe extents when it isn't NULL */
+	struct vea_space_info		*mw_defrag_vsi;
+	/* How many extents can be relocated in current aggregation */
+	unsigned int			 mw_defrag_credits;
+	/* Current window is flushed to relocate an isolated extent */
+	bool				 mw_defrag;
 };
 
 struct vos_agg_param {
@@ -826,7 +832,7 @@ reserve_segment(struct vos_object *obj, struct agg_io_context *io,
 
 	D_ASSERT(media == DAOS_MEDIA_NVME);
 	rc = vos_reserve_blocks(obj->obj_cont, &io->ic_nvme_exts, size,
-				VOS_IOS_AGGREGATION, &off);
+				VOS_IOS_AGGREGATION, &obj->obj_id, &off);
 	if (rc)
 		D_ERROR("Reserve "DF_U64" from NVMe failed. "DF_RC"\n",
 			size, DP_RC(rc));
@@ -1491,6 +1497,44 @@ free_removal_records(struct agg_merge_window *mw, d_list_t *head, bool top)
 		mw->mw_rmv_cnt = 0;
 }
 
+/*
+ * Relocating an NVMe extent isolated by free extents on both sides would
+ * coalesce the free extents around it, the relocated data will be appended
+ * to the aggregation I/O stream.
+ */
+static bool
+need_defrag(struct agg_merge_window *mw)
+{
+	struct agg_phy_ent	*phy_ent;
+	bio_addr_t		*addr;
+	uint64_t		 blk_off;
+	uint32_t		 blk_cnt;
+
+	if (mw->mw_defrag_vsi == NULL || mw->mw_defrag_credits == 0)
+		return false;
+
+	d_list_for_each_entry(phy_ent, &mw->mw_phy_ents, pe_link) {
+		addr = &phy_ent->pe_addr;
+		if (addr->ba_type != DAOS_MEDIA_NVME ||
+		    bio_addr_is_hole(addr) || phy_ent->pe_off != 0)
+			continue;
+
+		blk_off = addr->ba_off >> VOS_BLK_SHIFT;
+		blk_cnt = vos_byte2blkcnt(mw->mw_rsize *
+				evt_extent_width(&phy_ent->pe_rect.rc_ex));
+		if (!vea_ext_isolated(mw->mw_defrag_vsi, blk_off, blk_cnt))
+			continue;
+
+		D_DEBUG(DB_EPC, "Relocate isolated extent ["DF_U64", %u]\n",
+			blk_off, blk_cnt);
+		mw->mw_defrag_credits--;
+		mw->mw_defrag = true;
+		return true;
+	}
+
+	return false;
+}
+
 static bool
 need_flush(struct agg_merge_window *mw, bool last)
 {
@@ -1529,6 +1573,9 @@ need_flush(struct agg_merge_window *mw, bool last)
 	if (last && mw->mw_rmv_cnt != 0)
 		return true;
 
+	if (need_defrag(mw))
+		return true;
+
 	clear_merge_window(mw);
 	D_DEBUG(DB_EPC, "Skip window flush "DF_EXT"\n", DP_EXT(&mw->mw_ext));
 
@@ -1573,7 +1620,11 @@ flush_merge_window(daos_handle_t ih, struct agg_merge_window *mw,
 			DP_EXT(&mw->mw_ext), DP_RC(rc));
 		goto out;
 	}
+
+	if (mw->mw_defrag)
+		d_tm_inc_counter(vos_tls_get()->vtl_defrag_relocated, 1);
 out:
+	mw->mw_defrag = false;
 	cleanup_segments(ih, mw, rc);
 	return rc;
 }
@@ -2316,6 +2367,51 @@ merge_window_init(struct agg_merge_window *mw, void (*func)(void *))
 	io->ic_csum_recalc_func = func;
 }
 
+/*
+ * Check if NVMe free space of the pool is fragmented, the fragmentation
+ * metrics are updated along with the check.
+ */
+static bool
+pool_fragmented(struct vos_pool *pool)
+{
+	struct vos_tls	*tls = vos_tls_get();
+	struct vea_attr	 attr;
+	struct vea_stat	 stat;
+	uint64_t	 now = 0;
+	int		 i, rc;
+
+	if (pool->vp_vea_info == NULL)
+		return false;
+
+	rc = daos_gettime_coarse(&now);
+	if (rc || now < pool->vp_defrag_check + VOS_DEFRAG_CHECK_INTVL)
+		return pool->vp_defrag;
+	pool->vp_defrag_check = now;
+
+	rc = vea_query(pool->vp_vea_info, &attr, &stat);
+	if (rc) {
+		D_ERROR("Query pool:"DF_UUID" NVMe space failed. "DF_RC"\n",
+			DP_UUID(pool->vp_id), DP_RC(rc));
+		pool->vp_defrag = false;
+		return false;
+	}
+
+	d_tm_set_gauge(tls->vtl_vea_largest, stat.vs_largest_blks);
+	for (i = 0; i < VEA_FRAGS_HIST_CNT; i++)
+		d_tm_set_gauge(tls->vtl_vea_frags[i], stat.vs_frags_hist[i]);
+
+	pool->vp_defrag = stat.vs_largest_blks < attr.va_large_thresh &&
+		(attr.va_free_blks * 100 >=
+		 attr.va_tot_blks * VOS_DEFRAG_FREE_PCT);
+
+	D_CDEBUG(pool->vp_defrag, DLOG_INFO, DB_EPC,
+		 "Pool:"DF_UUID" largest free:%u, free:"DF_U64"/"DF_U64
+		 ", defrag:%d\n", DP_UUID(pool->vp_id), stat.vs_largest_blks,
+		 attr.va_free_blks, attr.va_tot_blks, pool->vp_defrag);
+
+	return pool->vp_defrag;
+}
+
 struct agg_data {
 	vos_iter_param_t	ad_iter_param;
 	struct vos_agg_param	ad_agg_param;
@@ -2365,6 +2461,13 @@ vos_aggregate(daos_handle_t coh, daos_epoch_range_t *epr,
 	ad->ad_agg_param.ap_yield_func = yield_func;
 	ad->ad_agg_param.ap_yield_arg = yield_arg;
 	merge_window_init(&ad->ad_agg_param.ap_window, csum_func);
+	/* Relocate isolated NVMe extents when free space is fragmented */
+	if (pool_fragmented(cont->vc_pool)) {
+		ad->ad_agg_param.ap_window.mw_defrag_vsi =
+			cont->vc_pool->vp_vea_info;
+		ad->ad_agg_param.ap_window.mw_defrag_credits =
+			VOS_DEFRAG_EXTS_MAX;
+	}
 	/* A full scan caused by snapshot deletion */
 	ad->ad_agg_param.ap_full_scan = full_scan;
 
@@ -162,6 +162,9 @@ vos_bio_addr_free(struct vos_pool *pool, bio_addr_t *addr, daos_size_t nob)
 		blk_off = vos_byte2blkoff(addr->ba_off);
 		blk_cnt = vos_byte2blkcnt(nob);
 
+		/* Freed blocks could be reused, drop them from read cache */
+		bio_rcache_invalidate(pool->vp_io_ctxt, addr->ba_off, nob);
+
 		rc = vea_free(pool->vp_vea_info, blk_off, blk_cnt);
 		if (rc)
 			D_ERROR("Error on block ["DF_U64", %u] free. "DF_RC"\n",
@@ -364,7 +367,7 @@ static void *
 vos_tls_init(int xs_id, int tgt_id)
 {
 	struct vos_tls *tls;
-	int		rc;
+	int		rc, i;
 
 	D_ALLOC_PTR(tls);
 	if (tls == NULL)
@@ -417,6 +420,32 @@ vos_tls_init(int xs_id, int tgt_id)
 		D_WARN("Failed to create committed cnt sensor: "DF_RC"\n",
 		       DP_RC(rc));
 
+	rc = d_tm_add_metric(&tls->vtl_defrag_relocated, D_TM_COUNTER,
+			     "Number of NVMe extents relocated by defrag",
+			     "extents", "io/defrag/relocated/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create defrag relocated sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	rc = d_tm_add_metric(&tls->vtl_vea_largest, D_TM_GAUGE,
+			     "Largest free NVMe extent", "blocks",
+			     "io/defrag/largest_free/tgt_%u", tgt_id);
+	if (rc)
+		D_WARN("Failed to create largest free sensor: "DF_RC"\n",
+		       DP_RC(rc));
+
+	for (i = 0; i < VEA_FRAGS_HIST_CNT; i++) {
+		rc = d_tm_add_metric(&tls->vtl_vea_frags[i], D_TM_GAUGE,
+				     "Free NVMe extents in size bucket i, "
+				     "(16^(i-1), 16^i] blocks",
+				     "extents",
+				     "io/defrag/free_frags/bkt_%d/tgt_%u", i,
+				     tgt_id);
+		if (rc)
+			D_WARN("Failed to create free frags sensor: "DF_RC"\n",
+			       DP_RC(rc));
+	}
+
 	return tls;
 failed:
 	vos_tls_fini(tls);
@@ -505,6 +505,30 @@ vos_cont_query(daos_handle_t coh, vos_cont_info_t *cont_info)
 	return 0;
 }
 
+int
+vos_cont_snap_read(daos_handle_t coh, daos_epoch_t epoch)
+{
+	struct vos_container	*cont;
+
+	cont = vos_hdl2cont(coh);
+	D_ASSERT(cont != NULL);
+
+	if (epoch <= cont->vc_cont_df->cd_hae ||
+	    (cont->vc_in_aggregation &&
+	     epoch <= cont->vc_epr_aggregation.epr_hi)) {
+		D_DEBUG(DB_IO, DF_CONT": snapshot read at "DF_X64" is "
+			"aggregated, HAE "DF_X64"\n",
+			DP_CONT(cont->vc_pool->vp_id, cont->vc_id), epoch,
+			cont->vc_cont_df->cd_hae);
+		return -DER_TX_RESTART;
+	}
+
+	if (cont->vc_snap_read_eph < epoch)
+		cont->vc_snap_read_eph = epoch;
+
+	return 0;
+}
+
 /**
  * Set container state
  */
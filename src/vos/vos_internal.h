@@ -103,6 +103,17 @@ enum {
 /* Force aggregation/discard ULT yield on certain amount of tight loops */
 #define VOS_AGG_CREDITS_MAX	32
 
+/*
+ * NVMe free space is regarded as fragmented when there isn't any large free
+ * extent, though the free space is more than VOS_DEFRAG_FREE_PCT percent.
+ * The fragmentation is checked at most once every VOS_DEFRAG_CHECK_INTVL
+ * seconds, and each aggregation pass relocates at most VOS_DEFRAG_EXTS_MAX
+ * isolated extents.
+ */
+#define VOS_DEFRAG_FREE_PCT	10
+#define VOS_DEFRAG_CHECK_INTVL	60	/* Seconds */
+#define VOS_DEFRAG_EXTS_MAX	1024
+
 static inline uint32_t vos_byte2blkcnt(uint64_t bytes)
 {
 	D_ASSERT(bytes != 0);
@@ -167,6 +178,10 @@ struct vos_pool {
 	struct d_hash_table	*vp_dedup_hash;
 	/* The count of committed DTXs for the whole pool. */
 	uint32_t		 vp_dtx_committed_count;
+	/** Last NVMe fragmentation check time in seconds */
+	uint64_t		 vp_defrag_check;
+	/** NVMe free space is fragmented, relocate extents on aggregation */
+	bool			 vp_defrag;
 };
 
 /**
@@ -210,6 +225,8 @@ struct vos_container {
 	daos_epoch_range_t	vc_epr_aggregation;
 	/* Current ongoing discard EPR */
 	daos_epoch_range_t	vc_epr_discard;
+	/* Highest epoch pinned by stable snapshot reads */
+	daos_epoch_t		vc_snap_read_eph;
 	/* Various flags */
 	unsigned int		vc_in_aggregation:1,
 				vc_in_discard:1,
@@ -1036,7 +1053,8 @@ vos_publish_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
 		bool publish);
 int
 vos_reserve_blocks(struct vos_container *cont, d_list_t *rsrvd_nvme,
-		   daos_size_t size, enum vos_io_stream ios, uint64_t *off);
+		   daos_size_t size, enum vos_io_stream ios,
+		   daos_unit_oid_t *oid, uint64_t *off);
 
 int
 vos_publish_blocks(struct vos_container *cont, d_list_t *blk_list, bool publish,
@@ -1877,13 +1877,20 @@ vos_reserve_scm(struct vos_container *cont, struct vos_rsrvd_scm *rsrvd_scm,
 	return umoff;
 }
 
+/*
+ * Reserve NVMe blocks for the I/O stream @ios. When @oid is provided, the
+ * reservation follows the per-object allocation cursor of the stream hint,
+ * so that the extents of interleaved sequential writers stay contiguous.
+ */
 int
 vos_reserve_blocks(struct vos_container *cont, d_list_t *rsrvd_nvme,
-		   daos_size_t size, enum vos_io_stream ios, uint64_t *off)
+		   daos_size_t size, enum vos_io_stream ios,
+		   daos_unit_oid_t *oid, uint64_t *off)
 {
 	struct vea_space_info	*vsi;
 	struct vea_hint_context	*hint_ctxt;
 	struct vea_resrvd_ext	*ext;
+	uint64_t		 key = 0;
 	uint32_t		 blk_cnt;
 	int			 rc;
 
@@ -1895,7 +1902,14 @@ vos_reserve_blocks(struct vos_container *cont, d_list_t *rsrvd_nvme,
 
 	blk_cnt = vos_byte2blkcnt(size);
 
-	rc = vea_reserve(vsi, blk_cnt, hint_ctxt, rsrvd_nvme);
+	if (oid != NULL) {
+		key = d_hash_murmur64((unsigned char *)oid, sizeof(*oid), 0);
+		/* Zero key means no cursor */
+		if (key == 0)
+			key = 1;
+	}
+
+	rc = vea_reserve_key(vsi, blk_cnt, hint_ctxt, key, rsrvd_nvme);
 	if (rc)
 		return rc;
 
@@ -1930,7 +1944,7 @@ reserve_space(struct vos_io_context *ioc, uint16_t media, daos_size_t size,
 
 	D_ASSERT(media == DAOS_MEDIA_NVME);
 	rc = vos_reserve_blocks(ioc->ic_cont, &ioc->ic_blk_exts, size,
-				VOS_IOS_GENERIC, off);
+				VOS_IOS_GENERIC, &ioc->ic_oid, off);
 	if (rc)
 		D_ERROR("Reserve "DF_U64" from NVMe failed. "DF_RC"\n",
 			size, DP_RC(rc));
@@ -2383,6 +2397,13 @@ vos_update_begin(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 	if (rc != 0)
 		return rc;
 
+	/* Don't slip under a stable snapshot read, see vos_cont_snap_read */
+	if (dtx_is_valid_handle(dth) &&
+	    ioc->ic_epr.epr_hi <= ioc->ic_cont->vc_snap_read_eph) {
+		rc = -DER_TX_RESTART;
+		goto error;
+	}
+
 	/* flags may have VOS_OF_CRIT to skip sys/held checks here */
 	rc = vos_space_hold(vos_cont2pool(ioc->ic_cont), flags, dkey, iod_nr,
 			    iods, iods_csums, &ioc->ic_space_held[0]);
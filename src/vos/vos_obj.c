@@ -327,9 +327,14 @@ vos_obj_punch(daos_handle_t coh, daos_unit_oid_t oid, daos_epoch_t epoch,
 	D_DEBUG(DB_IO, "Punch "DF_UOID", epoch "DF_U64"\n",
 		DP_UOID(oid), epr.epr_hi);
 
-	vos_dth_set(dth);
 	cont = vos_hdl2cont(coh);
 
+	/* Don't slip under a stable snapshot read, see vos_cont_snap_read */
+	if (dtx_is_valid_handle(dth) && epr.epr_hi <= cont->vc_snap_read_eph)
+		return -DER_TX_RESTART;
+
+	vos_dth_set(dth);
+
 	if (dtx_is_valid_handle(dth)) {
 		if (akey_nr) {
 			cflags = VOS_TS_WRITE_AKEY;
@@ -19,6 +19,7 @@
 #include <daos_srv/daos_engine.h>
 #include <daos_srv/bio.h>
 #include <daos_srv/dtx_srv.h>
+#include <daos_srv/vea.h>
 #include <gurt/telemetry_common.h>
 #include <gurt/telemetry_producer.h>
 
@@ -63,6 +64,12 @@ struct vos_tls {
 		bool			 vtl_hash_set;
 	};
 	struct d_tm_node_t		 *vtl_committed;
+	/** NVMe extents relocated by defragmentation */
+	struct d_tm_node_t		 *vtl_defrag_relocated;
+	/** Largest free NVMe extent of the last checked pool */
+	struct d_tm_node_t		 *vtl_vea_largest;
+	/** Free NVMe extent size histogram of the last checked pool */
+	struct d_tm_node_t		 *vtl_vea_frags[VEA_FRAGS_HIST_CNT];
 };
 
 struct bio_xs_context *vos_xsctxt_get(void);
@@ -14,7 +14,7 @@
 
 Name:          daos
 Version:       1.3.104
-Release:       2%{?relval}%{?dist}
+Release:       3%{?relval}%{?dist}
 Summary:       DAOS Storage Engine
 
 License:       BSD-2-Clause-Patent
@@ -77,6 +77,9 @@ BuildRequires: protobuf-c-devel
 BuildRequires: lz4-devel
 %endif
 BuildRequires: spdk-devel >= 21.07
+%if (0%{?rhel} >= 8) || (0%{?suse_version} >= 1500)
+BuildRequires: liburing-devel
+%endif
 %if (0%{?rhel} >= 7)
 BuildRequires: libisa-l-devel
 BuildRequires: libisa-l_crypto-devel
@@ -472,6 +475,9 @@ getent passwd daos_agent >/dev/null || useradd -s /sbin/nologin -r -g daos_agent
 %{_libdir}/libdaos_serialize.so
 
 %changelog
+* Sun Oct 18 2026 agent <agent@local> 1.3.104-3
+- Add liburing-devel BuildRequires for the io_uring bdev class
+
 * Wed Aug 04 2021 Tom Nabarro <tom.nabarro@intel.com> 1.3.104-2
 - Update to spdk 21.07 and (indirectly) dpdk 21.05
 